@@ -0,0 +1,77 @@
+/**
+ * @file allocator.cpp
+ * @brief Replacement allocation functions of the Python-Sublanguage executables
+ *
+ * Counts every allocation for the statistics (--stats of the interpreter, --counts of the
+ * benchmarks). Linked into the executables rather than the library, so that the programs
+ * embedding the library keep their own allocator.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <cstdlib>
+#include <new>
+#include "stats.h"
+
+/**
+ * @brief Allocates memory, counting the allocation
+ * @param size The number of bytes
+ * @return The allocated memory
+ */
+void* operator new(std::size_t size) {
+    Stats::recordAllocation(size);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+/**
+ * @brief Frees memory allocated by operator new
+ *
+ * The other deallocation functions call this one. It is not inlined, so the compiler sees every
+ * pointer returned by operator new reach operator delete rather than free().
+ * @param memory The memory
+ */
+[[gnu::noinline]] void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+/**
+ * @brief Frees memory allocated by operator new (sized deallocation)
+ * @param memory The memory
+ * @param size The number of bytes (unused)
+ */
+void operator delete(void* memory, std::size_t size) noexcept {
+    (void)size;
+    operator delete(memory);
+}
+
+/**
+ * @brief Allocates memory for an array, counting the allocation
+ * @param size The number of bytes
+ * @return The allocated memory
+ */
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+/**
+ * @brief Frees memory allocated by operator new[]
+ * @param memory The memory
+ */
+void operator delete[](void* memory) noexcept {
+    operator delete(memory);
+}
+
+/**
+ * @brief Frees memory allocated by operator new[] (sized deallocation)
+ * @param memory The memory
+ * @param size The number of bytes (unused)
+ */
+void operator delete[](void* memory, std::size_t size) noexcept {
+    (void)size;
+    operator delete(memory);
+}
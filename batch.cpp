@@ -0,0 +1,241 @@
+/**
+ * @file batch.cpp
+ * @brief Implements the batch runner of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the WorkQueue and BatchRunner classes.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <unistd.h>
+#include "batch.h"
+#include "output.h"
+#include "error.h"
+#include "scheduler.h"
+
+/**
+ * @brief Adds a script to the back of the queue
+ * @param index The index of the script in the manifest
+ */
+void WorkQueue::push(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    indexes_.push_back(index);
+}
+
+/**
+ * @brief Takes the script at the front of the queue (used by the owner)
+ * @param index The index of the script taken
+ * @return False if the queue is empty
+ */
+bool WorkQueue::pop(size_t& index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indexes_.empty()) return false;
+    index = indexes_.front();
+    indexes_.pop_front();
+    return true;
+}
+
+/**
+ * @brief Takes the script at the back of the queue (used by the other workers)
+ * @param index The index of the script taken
+ * @return False if the queue is empty
+ */
+bool WorkQueue::steal(size_t& index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (indexes_.empty()) return false;
+    index = indexes_.back();
+    indexes_.pop_back();
+    return true;
+}
+
+/**
+ * @brief Constructs a batch runner and deals the scripts to the queues of the workers
+ * @param paths The paths of the scripts, in the order of the manifest
+ * @param workers The number of worker threads (at least 1)
+ * @param options The compile options of every script
+ * @param limits The execution limits of every script
+ * @param interleave Run the scripts as suspendable tasks on the calling thread instead of the workers
+ */
+BatchRunner::BatchRunner(std::vector<std::string> paths, size_t workers, CompileOptions options, ExecutionLimits limits, bool interleave)
+    : paths_(std::move(paths)), options_(options), limits_(limits), interleave_(interleave),
+      queues_(interleave ? 1 : std::max<size_t>(workers, 1)), results_(paths_.size()) {
+    // contiguous ranges keep neighbouring scripts on the same worker until stealing starts
+    size_t chunk = (paths_.size() + queues_.size() - 1) / queues_.size();
+    for (size_t i = 0; i < paths_.size(); i++) {
+        queues_[i / std::max<size_t>(chunk, 1)].push(i);
+    }
+}
+
+/**
+ * @brief Runs the batch and prints the outputs in order, followed by the throughput on stderr
+ * @return The number of scripts that failed
+ */
+size_t BatchRunner::operator()() {
+    auto start = std::chrono::steady_clock::now();
+    if (interleave_) {
+        runInterleaved();
+        writeResults();
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < queues_.size(); w++) {
+            workers.emplace_back(&BatchRunner::work, this, w);
+        }
+        writeResults();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failed = 0;
+    for (const auto& result : results_) {
+        if (result.status != 0) failed++;
+    }
+    std::cerr << "Batch: " << results_.size() << " scripts, " << failed << " failed, "
+              << (interleave_ ? "interleaved" : std::to_string(queues_.size()) + " workers") << ", " << seconds << " s, "
+              << (seconds > 0 ? results_.size() / seconds : 0) << " scripts/s" << std::endl;
+    return failed;
+}
+
+/**
+ * @brief Reads the paths of the scripts from a manifest
+ * @param path The path of the manifest
+ * @return The paths of the scripts, in order
+ */
+std::vector<std::string> BatchRunner::readManifest(const std::string& path) {
+    std::ifstream manifest(path);
+    if (!manifest.is_open()) {
+        throw FileOpenError(0, 0, "Could not open manifest: " + path);
+    }
+    std::vector<std::string> paths;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) paths.push_back(line);
+    }
+    return paths;
+}
+
+/**
+ * @brief Body of a worker: runs the scripts of its queue, then steals from the others
+ * @param worker The index of the worker
+ */
+void BatchRunner::work(size_t worker) {
+    // the source buffer is reused by all the scripts of the worker
+    std::string source;
+    size_t index;
+    while (true) {
+        bool found = queues_[worker].pop(index);
+        for (size_t k = 1; !found && k < queues_.size(); k++) {
+            found = queues_[(worker + k) % queues_.size()].steal(index);
+        }
+        // scripts are only dealt at construction, so empty queues mean the batch is over
+        if (!found) return;
+        runScript(index, source);
+    }
+}
+
+/**
+ * @brief Reads, compiles and runs one script, then publishes its result
+ *
+ * The compiled program is released when the script has run, before the result is published.
+ * @param index The index of the script in the manifest
+ * @param source The buffer for the source code of the script
+ */
+void BatchRunner::runScript(size_t index, std::string& source) {
+    BatchResult result;
+    if (readScript(index, source, result)) {
+        CompileResult compiled = compile(source, options_);
+        if (!compiled.ok()) {
+            result.diagnostics = std::move(compiled.diagnostics);
+        } else {
+            RunOptions options;
+            options.output = [&result](const char* data, size_t size) { result.output.append(data, size); };
+            options.limits = limits_;
+            result.diagnostics = run(compiled.program, options).diagnostics;
+        }
+    }
+    result.status = result.diagnostics.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+    result.done = true;
+
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    results_[index] = std::move(result);
+    resultsReady_.notify_one();
+}
+
+/**
+ * @brief Reads the source code of a script
+ * @param index The index of the script in the manifest
+ * @param source The buffer for the source code
+ * @param result The result of the script, which gets the diagnostic if the file cannot be opened
+ * @return False if the file cannot be opened
+ */
+bool BatchRunner::readScript(size_t index, std::string& source, BatchResult& result) {
+    std::ifstream file(paths_[index]);
+    if (!file.is_open()) {
+        result.diagnostics.push_back(Diagnostic::fromError(FileOpenError(0, 0, "Could not open input file: " + paths_[index])));
+        return false;
+    }
+    source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * @brief Compiles every script, then runs them all as tasks of the Scheduler on this thread
+ *
+ * The Scheduler holds the only handle of each program, so its tree is freed as soon as its task ends.
+ */
+void BatchRunner::runInterleaved() {
+    Scheduler scheduler;
+    std::vector<size_t> tasks(paths_.size(), SIZE_MAX);
+    std::string source;
+    for (size_t i = 0; i < paths_.size(); i++) {
+        BatchResult& result = results_[i];
+        if (!readScript(i, source, result)) continue;
+        CompileResult compiled = compile(source, options_);
+        if (!compiled.ok()) {
+            result.diagnostics = std::move(compiled.diagnostics);
+            continue;
+        }
+        RunOptions options;
+        options.output = [&result](const char* data, size_t size) { result.output.append(data, size); };
+        options.limits = limits_;
+        tasks[i] = scheduler.spawn(compiled.program, options);
+    }
+    scheduler.run();
+    for (size_t i = 0; i < paths_.size(); i++) {
+        if (tasks[i] != SIZE_MAX) {
+            results_[i].diagnostics = scheduler.getResult(tasks[i]).diagnostics;
+        }
+        results_[i].status = results_[i].diagnostics.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+        results_[i].done = true;
+    }
+}
+
+/**
+ * @brief Writes the results in the order of the manifest, releasing each output once written
+ */
+void BatchRunner::writeResults() {
+    OutputSink output(STDOUT_FILENO, FLUSH_ON_SIZE);
+    for (size_t i = 0; i < results_.size(); i++) {
+        std::unique_lock<std::mutex> lock(resultsMutex_);
+        resultsReady_.wait(lock, [this, i] { return results_[i].done; });
+        BatchResult result = std::move(results_[i]);
+        results_[i].status = result.status;
+        lock.unlock();
+
+        output.write(result.output.data(), result.output.size());
+        if (!result.diagnostics.empty()) {
+            // the diagnostic follows the output of its script, as for a single run
+            output.flush();
+            std::cerr << paths_[i] << ": " << result.diagnostics.front().toString() << std::endl;
+        }
+    }
+}
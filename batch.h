@@ -0,0 +1,101 @@
+#if !defined(BATCH_H)
+#define BATCH_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "interpreter.h"
+
+/**
+ * @file batch.h
+ * @brief Defines the batch runner of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the BatchRunner class, which lexes, parses and runs
+ * the scripts listed in a manifest on a pool of worker threads, inside a single process.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+/**
+ * @struct BatchResult
+ * @brief Outcome of one script of the batch
+ */
+struct BatchResult {
+    std::string output;                  // output of the print statements
+    std::vector<Diagnostic> diagnostics; // error of the script (empty on success)
+    int status{0};                       // exit status the script would have had as a process
+    bool done{false};                    // the result is complete
+};
+
+/**
+ * @class WorkQueue
+ * @brief Double-ended queue of script indexes owned by one worker
+ *
+ * The owner takes work from the front, idle workers steal it from the back.
+ */
+class WorkQueue{
+    public:
+        // constructors
+        WorkQueue() = default;
+        WorkQueue(WorkQueue const& wq) = delete;
+
+        // destructor
+        ~WorkQueue() = default;
+
+        // methods
+        void push(size_t index);
+        bool pop(size_t& index);
+        bool steal(size_t& index);
+
+    private:
+        std::mutex mutex_;
+        std::deque<size_t> indexes_;
+};
+
+/**
+ * @class BatchRunner
+ * @brief Runs the scripts of a manifest on a fixed-size pool of workers with work stealing
+ *
+ * Alternatively, all the scripts are interleaved on the calling thread by the Scheduler.
+ * The outputs are written in the order of the manifest as soon as each prefix of the batch
+ * is complete: the output of a script to stdout, its diagnostic (prefixed by its path) to stderr.
+ */
+class BatchRunner{
+    public:
+        // constructors
+        BatchRunner() = delete;
+        BatchRunner(std::vector<std::string> paths, size_t workers, CompileOptions options, ExecutionLimits limits, bool interleave = false);
+        BatchRunner(BatchRunner const& br) = delete;
+
+        // destructor
+        ~BatchRunner() = default;
+
+        // overload () operator to run the batch, returns the number of failed scripts
+        size_t operator()();
+
+        // method to read a manifest (one path per line, empty lines are ignored)
+        static std::vector<std::string> readManifest(const std::string& path);
+
+    private:
+        // methods of the workers and of the writer of the results
+        void work(size_t worker);
+        void runScript(size_t index, std::string& source);
+        bool readScript(size_t index, std::string& source, BatchResult& result);
+        void runInterleaved();
+        void writeResults();
+
+        std::vector<std::string> paths_;
+        CompileOptions options_;
+        ExecutionLimits limits_; // limits of every script
+        bool interleave_; // run every script on the calling thread with the cooperative Scheduler
+        std::vector<WorkQueue> queues_;
+        std::vector<BatchResult> results_;
+        std::mutex resultsMutex_;
+        std::condition_variable resultsReady_;
+};
+
+
+#endif
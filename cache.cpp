@@ -0,0 +1,706 @@
+/**
+ * @file cache.cpp
+ * @brief Implements the persistent cache of compiled programs of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the ProgramCache, ProgramWriter and ProgramReader classes.
+ * A cache file is laid out as follows (integers are unsigned LEB128 varints, except the key):
+ *   magic "PSLC", format version, key (8 bytes, little endian), length and bytes of the source
+ *   (compared on load, since different sources may share a key)
+ *   token count, then the type (1 byte), line (zigzag delta from the previous token) and column
+ *   of each token referenced by a position
+ *   name count, then the length and bytes of each identifier
+ *   the records of the Syntax Tree in post-order, ended by the PROGRAM_RECORD (the records of
+ *   the list statements carry the line of their identifier)
+ *   checksum of all the previous bytes (8 bytes, little endian)
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cache.h"
+
+/**
+ * @brief Computes the FNV-1a hash of a sequence of bytes
+ * @param data The first byte
+ * @param size The number of bytes
+ * @return The 64-bit hash
+ */
+uint64_t getChecksum(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Computes the cache key of a source code (FNV-1a hash of the interpreter version and of the source)
+ * @param source The source code of the program
+ * @return The 64-bit key
+ */
+uint64_t ProgramCache::getKey(const std::string& source) {
+    // the terminating '\0' of the version separates it from the source
+    std::string keyed = std::string(INTERPRETER_VERSION) + '\0' + source;
+    return getChecksum(keyed.data(), keyed.size());
+}
+
+/**
+ * @brief Returns the path of the cache file of a key
+ * @param key The cache key of the program
+ * @return The path of the file in the cache directory
+ */
+std::string ProgramCache::getPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.pslc", static_cast<unsigned long long>(key));
+    return directory_ + "/" + name;
+}
+
+/**
+ * @brief Loads the compiled form of a source code from the cache
+ *
+ * The file is mapped in memory and decoded without lexing or parsing the source.
+ * @param source The source code of the program
+ * @param tokens The vector receiving the rebuilt tokens (the Syntax Tree does not refer to them)
+ * @return The Syntax Tree, or nullptr if the program is not in the cache (or the file is unusable)
+ */
+Program* ProgramCache::load(const std::string& source, std::vector<Token*>& tokens) const {
+    uint64_t key = getKey(source);
+    int fd = open(getPath(key).c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+
+    Program* program = nullptr;
+    try {
+        ProgramReader reader(static_cast<const char*>(data), info.st_size, tokens);
+        program = reader(key, source);
+    } catch (const Error& e) {
+        // A corrupted or stale file is a cache miss: the program is compiled again
+        for (auto t : tokens) delete t;
+        tokens.clear();
+        program = nullptr;
+    }
+    munmap(data, info.st_size);
+    return program;
+}
+
+/**
+ * @brief Stores the compiled form of a successfully parsed program in the cache
+ *
+ * The file is written under a temporary name and renamed, so concurrent runs never read a
+ * partial file. Failures are ignored: the cache is only an optimization.
+ * @param source The source code of the program
+ * @param program The Syntax Tree of the program
+ * @param tokens The token vector referenced by the Syntax Tree
+ */
+void ProgramCache::store(const std::string& source, Program* program, std::vector<Token*> const& tokens) const {
+    // the length of the source is written as a 32-bit value
+    if (source.size() > UINT32_MAX) return;
+    uint64_t key = getKey(source);
+    ProgramWriter writer(tokens);
+    std::string data = writer(program, key, source);
+
+    mkdir(directory_.c_str(), 0755);
+    std::string path = getPath(key);
+    std::string tmpPath = path + ".tmp" + std::to_string(getpid());
+
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (!file) return;
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = (fclose(file) == 0) && written;
+    if (!written || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+    }
+}
+
+/**
+ * @brief Encodes a Syntax Tree
+ *
+ * The tree is walked with an explicit stack, so deeply nested programs can be cached.
+ * @param program The Syntax Tree to encode
+ * @param key The cache key of the program
+ * @param source The source code of the program
+ * @return The content of the cache file
+ */
+std::string ProgramWriter::operator()(Program* program, uint64_t key, const std::string& source) {
+    enum NodeKind { EXPRESSION_NODE, STATEMENT_NODE, BLOCK_NODE };
+    struct WorkItem {
+        NodeKind kind;
+        void* node;
+        bool expanded; // the children have been pushed, the record can be written
+    };
+    std::vector<WorkItem> work;
+
+    // Statements are pushed in reverse order, so they are written in order
+    std::vector<Statement*> const& statements = program->getStatements();
+    for (auto it = statements.rbegin(); it != statements.rend(); ++it) {
+        work.push_back(WorkItem{STATEMENT_NODE, *it, false});
+    }
+
+    while (!work.empty()) {
+        WorkItem item = work.back();
+        work.pop_back();
+
+        // The children are complete: write the record of the node
+        if (item.expanded) {
+            if (item.kind == EXPRESSION_NODE) writeExpression(static_cast<Expression*>(item.node));
+            else if (item.kind == STATEMENT_NODE) writeStatement(static_cast<Statement*>(item.node));
+            else writeBlock(static_cast<Block*>(item.node));
+            continue;
+        }
+        work.push_back(WorkItem{item.kind, item.node, true});
+
+        // Push the children of the node in reverse order, so they are written in order
+        size_t first = work.size();
+        if (item.kind == EXPRESSION_NODE) {
+            Expression* expr = static_cast<Expression*>(item.node);
+            switch (expr->getExprType()) {
+                case ExpressionType::BINARY_EXPR:
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<Binary*>(expr)->getLeft(), false});
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<Binary*>(expr)->getRight(), false});
+                    break;
+                case ExpressionType::NARY_EXPR:
+                    for (auto operand : static_cast<Nary*>(expr)->getOperands()) {
+                        work.push_back(WorkItem{EXPRESSION_NODE, operand, false});
+                    }
+                    break;
+                case ExpressionType::UNARY_EXPR:
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<Unary*>(expr)->getOperand(), false});
+                    break;
+                case ExpressionType::LOAD_EXPR:
+                    if (static_cast<Location*>(expr)->getLocationType() == LocationType::LIST_ELEM) {
+                        work.push_back(WorkItem{EXPRESSION_NODE, static_cast<ListElementLocation*>(expr)->getIndex(), false});
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if (item.kind == STATEMENT_NODE) {
+            Statement* stmt = static_cast<Statement*>(item.node);
+            switch (stmt->getStatementType()) {
+                case ASSIGNMENT_STMT:
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<AssignmentStatement*>(stmt)->getLocation(), false});
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<AssignmentStatement*>(stmt)->getExpression(), false});
+                    break;
+                case LIST_APP_STMT:
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<ListAppendStatement*>(stmt)->getExpression(), false});
+                    break;
+                case PRINT_STMT:
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<PrintStatement*>(stmt)->getExpression(), false});
+                    break;
+                case IF_STMT:
+                case WHILE_STMT:
+                    work.push_back(WorkItem{EXPRESSION_NODE, static_cast<CompoundStatement*>(stmt)->getExpression(), false});
+                    for (auto block : static_cast<CompoundStatement*>(stmt)->getBlocks()) {
+                        work.push_back(WorkItem{BLOCK_NODE, block, false});
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        else {
+            Block* block = static_cast<Block*>(item.node);
+            if (block->getBlockType() == BlockType::SIMPLE_BLOCK) {
+                for (auto stmt : static_cast<SimpleBlock*>(block)->getStatements()) {
+                    work.push_back(WorkItem{STATEMENT_NODE, stmt, false});
+                }
+            } else if (block->getBlockType() == BlockType::ELIF_BLOCK) {
+                work.push_back(WorkItem{EXPRESSION_NODE, static_cast<ElifBlock*>(block)->getCondition(), false});
+                work.push_back(WorkItem{BLOCK_NODE, static_cast<ElifBlock*>(block)->getBlock(), false});
+            } else if (block->getBlockType() == BlockType::ELSE_BLOCK) {
+                work.push_back(WorkItem{BLOCK_NODE, static_cast<ElseBlock*>(block)->getBlock(), false});
+            }
+        }
+        std::reverse(work.begin() + first, work.end());
+    }
+
+    writeU8(records_, PROGRAM_RECORD);
+    writeU32(records_, statements.size());
+
+    // Header, token table and table of names, followed by the records
+    std::string out = CACHE_MAGIC;
+    writeU32(out, CACHE_FORMAT_VERSION);
+    writeU64(out, key);
+    writeU32(out, source.size());
+    out += source;
+    writeU32(out, usedTokens_.size());
+    int previousLine = 0;
+    for (auto token : usedTokens_) {
+        int delta = token->getLine() - previousLine;
+        previousLine = token->getLine();
+        writeU8(out, token->getType());
+        writeU32(out, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+        writeU32(out, token->getColumn());
+    }
+    writeU32(out, ids_.size());
+    for (auto const& id : ids_) {
+        writeU32(out, id.size());
+        out += id;
+    }
+    out += records_;
+    writeU64(out, getChecksum(out.data(), out.size()));
+    return out;
+}
+
+/**
+ * @brief Writes the record of an expression
+ * @param expr The expression (its operands have already been written)
+ */
+void ProgramWriter::writeExpression(Expression* expr) {
+    switch (expr->getExprType()) {
+        case ExpressionType::BINARY_EXPR:
+            writeU8(records_, BINARY_RECORD);
+            writeU8(records_, static_cast<Binary*>(expr)->getOperator());
+            break;
+        case ExpressionType::NARY_EXPR: {
+            Nary* nary = static_cast<Nary*>(expr);
+            writeU8(records_, NARY_RECORD);
+            writeU32(records_, nary->getOperands().size());
+            for (auto op : nary->getOperators()) writeU8(records_, op);
+            break;
+        }
+        case ExpressionType::UNARY_EXPR:
+            writeU8(records_, UNARY_RECORD);
+            writeU8(records_, static_cast<Unary*>(expr)->getOperator());
+            break;
+        case ExpressionType::LITERAL_EXPR: {
+            Literal* literal = static_cast<Literal*>(expr);
+            if (literal->getLiteralType() == Types::TYPE_INT) {
+                writeU8(records_, INT_LITERAL_RECORD);
+                writeU32(records_, static_cast<uint32_t>(literal->getIntValue()));
+            } else {
+                writeU8(records_, BOOL_LITERAL_RECORD);
+                writeU8(records_, literal->getBoolValue());
+            }
+            break;
+        }
+        case ExpressionType::LOAD_EXPR:
+            if (static_cast<Location*>(expr)->getLocationType() == LocationType::ID) {
+                writeU8(records_, ID_LOCATION_RECORD);
+                writeId(static_cast<IdLocation*>(expr)->getId());
+            } else {
+                writeU8(records_, LIST_ELEMENT_LOCATION_RECORD);
+                writeId(static_cast<ListElementLocation*>(expr)->getId());
+            }
+            break;
+        default:
+            throw InternalError(expr->getLine(), expr->getColumn(), "Unknown ExpressionType in cache writer");
+    }
+    writePosition(expr->getPosition());
+}
+
+/**
+ * @brief Writes the record of a statement
+ * @param stmt The statement (its expressions and blocks have already been written)
+ */
+void ProgramWriter::writeStatement(Statement* stmt) {
+    switch (stmt->getStatementType()) {
+        case ASSIGNMENT_STMT:
+            writeU8(records_, ASSIGNMENT_RECORD);
+            break;
+        case LIST_DECL_STMT:
+            writeU8(records_, LIST_DECLARATION_RECORD);
+            writeId(static_cast<ListDeclarationStatement*>(stmt)->getId());
+            writeU32(records_, static_cast<uint32_t>(static_cast<ListDeclarationStatement*>(stmt)->getIdLine()));
+            break;
+        case LIST_APP_STMT:
+            writeU8(records_, LIST_APPEND_RECORD);
+            writeId(static_cast<ListAppendStatement*>(stmt)->getId());
+            writeU32(records_, static_cast<uint32_t>(static_cast<ListAppendStatement*>(stmt)->getIdLine()));
+            break;
+        case BREAK_STMT:
+            writeU8(records_, BREAK_RECORD);
+            break;
+        case CONTINUE_STMT:
+            writeU8(records_, CONTINUE_RECORD);
+            break;
+        case PRINT_STMT:
+            writeU8(records_, PRINT_RECORD);
+            break;
+        case IF_STMT:
+        case WHILE_STMT:
+            writeU8(records_, COMPOUND_RECORD);
+            writeU8(records_, stmt->getStatementType());
+            writeU32(records_, static_cast<CompoundStatement*>(stmt)->getBlocks().size());
+            break;
+        default:
+            throw InternalError(stmt->getLine(), stmt->getColumn(), "Unknown StatementType in cache writer");
+    }
+    writePosition(stmt->getPosition());
+}
+
+/**
+ * @brief Writes the record of a block
+ * @param block The block (its statements have already been written)
+ */
+void ProgramWriter::writeBlock(Block* block) {
+    if (block->getBlockType() == BlockType::SIMPLE_BLOCK) {
+        writeU8(records_, SIMPLE_BLOCK_RECORD);
+        writeU32(records_, static_cast<SimpleBlock*>(block)->getStatements().size());
+    } else if (block->getBlockType() == BlockType::ELIF_BLOCK) {
+        writeU8(records_, ELIF_BLOCK_RECORD);
+    } else if (block->getBlockType() == BlockType::ELSE_BLOCK) {
+        writeU8(records_, ELSE_BLOCK_RECORD);
+    } else {
+        throw InternalError(block->getLine(), block->getColumn(), "Unknown BlockType in cache writer");
+    }
+    writePosition(block->getPosition());
+}
+
+/**
+ * @brief Writes the position of a node as the new index of its token, adding the token to the table on first use
+ * @param position The position of the node in the token vector
+ */
+void ProgramWriter::writePosition(int position) {
+    uint32_t& index = tokenIndexes_[position];
+    if (index == UNUSED_TOKEN) {
+        index = usedTokens_.size();
+        usedTokens_.push_back(tokens_[position]);
+    }
+    writeU32(records_, index);
+}
+
+/**
+ * @brief Writes the index of an identifier in the table of names, adding it on first use
+ * @param id The name of the identifier
+ */
+void ProgramWriter::writeId(const std::string& id) {
+    auto inserted = idIndexes_.emplace(id, ids_.size());
+    if (inserted.second) {
+        ids_.push_back(inserted.first->first);
+    }
+    writeU32(records_, inserted.first->second);
+}
+
+/**
+ * @brief Appends an 8-bit value
+ * @param out The output buffer
+ * @param value The value to append
+ */
+void ProgramWriter::writeU8(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Appends a 32-bit value as a varint (7 bits per byte, high bit set on all but the last byte)
+ * @param out The output buffer
+ * @param value The value to append
+ */
+void ProgramWriter::writeU32(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Appends a 64-bit value (little endian)
+ * @param out The output buffer
+ * @param value The value to append
+ */
+void ProgramWriter::writeU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+/**
+ * @brief Decodes a Syntax Tree
+ * @param key The expected cache key (a file written for another version is rejected)
+ * @param source The source code of the program (a file written for another source with the same key is rejected)
+ * @return The Syntax Tree of the program
+ */
+Program* ProgramReader::operator()(uint64_t key, const std::string& source) {
+    // Check the header and the checksum (the records are then read up to the checksum)
+    if (size_ < 12 || memcmp(data_, CACHE_MAGIC, 4) != 0) {
+        throw InternalError(0, 0, "Invalid cache file");
+    }
+    offset_ = size_ - 8;
+    uint64_t checksum = readU64();
+    size_ -= 8;
+    if (checksum != getChecksum(data_, size_)) {
+        throw InternalError(0, 0, "Corrupted cache file");
+    }
+    offset_ = 4;
+    if (readU32() != CACHE_FORMAT_VERSION || readU64() != key) {
+        throw InternalError(0, 0, "Stale cache file");
+    }
+    uint32_t sourceSize = readU32();
+    if (sourceSize != source.size() || sourceSize > size_ - offset_ || memcmp(data_ + offset_, source.data(), sourceSize) != 0) {
+        throw InternalError(0, 0, "Cache file of another source");
+    }
+    offset_ += sourceSize;
+
+    // Rebuild the referenced tokens: their position in this vector replaces the original one
+    uint32_t tokenCount = readU32();
+    if (tokenCount > size_ - offset_) {
+        throw InternalError(0, 0, "Truncated cache file");
+    }
+    tokens_.reserve(tokenCount);
+    int line = 0;
+    for (uint32_t i = 0; i < tokenCount; i++) {
+        uint8_t type = readU8();
+        if (type > TokenType::PUNCTUATION_TOKEN) {
+            throw InternalError(0, 0, "Invalid token in cache file");
+        }
+        uint32_t delta = readU32();
+        line += static_cast<int>((delta >> 1) ^ (~(delta & 1) + 1));
+        int column = static_cast<int>(readU32());
+        tokens_.push_back(new Token(line, column, static_cast<TokenType>(type)));
+    }
+
+    // Intern the table of names
+    uint32_t idCount = readU32();
+    for (uint32_t i = 0; i < idCount; i++) {
+        uint32_t length = readU32();
+        if (length > size_ - offset_) {
+            throw InternalError(0, 0, "Truncated cache file");
+        }
+        ids_.push_back(names_->intern(std::string(data_ + offset_, length)));
+        offset_ += length;
+    }
+
+    // Rebuild the tree: the children of each record are on top of the stacks
+    DecodedNodes nodes;
+    std::vector<Expression*>& exprs = nodes.exprs;
+    std::vector<Statement*>& stmts = nodes.stmts;
+    std::vector<Block*>& blocks = nodes.blocks;
+    auto popExpression = [&nodes]() {
+        if (nodes.exprs.empty()) throw InternalError(0, 0, "Invalid expression record in cache file");
+        Expression* expr = nodes.exprs.back();
+        nodes.exprs.pop_back();
+        nodes.heldExprs.push_back(expr);
+        return expr;
+    };
+    auto popBlock = [&nodes]() {
+        if (nodes.blocks.empty()) throw InternalError(0, 0, "Invalid block record in cache file");
+        Block* block = nodes.blocks.back();
+        nodes.blocks.pop_back();
+        nodes.heldBlocks.push_back(block);
+        return block;
+    };
+    auto popStatements = [&nodes](uint32_t count) {
+        if (count > nodes.stmts.size()) throw InternalError(0, 0, "Invalid statement record in cache file");
+        std::vector<Statement*> popped(nodes.stmts.end() - count, nodes.stmts.end());
+        nodes.stmts.resize(nodes.stmts.size() - count);
+        nodes.heldStmts.insert(nodes.heldStmts.end(), popped.begin(), popped.end());
+        return popped;
+    };
+
+    while (true) {
+        // The children popped by the previous record now belong to its node
+        nodes.release();
+        uint8_t record = readU8();
+        switch (record) {
+            case BINARY_RECORD: {
+                uint8_t op = readU8();
+                if (op > BinaryOperator::DIV_OP) throw InternalError(0, 0, "Invalid operator in cache file");
+                Expression* right = popExpression();
+                Expression* left = popExpression();
+                exprs.push_back(new Binary(left, static_cast<BinaryOperator>(op), right, readPosition(), tokens_));
+                break;
+            }
+            case NARY_RECORD: {
+                uint32_t count = readU32();
+                if (count < 2 || count > exprs.size()) throw InternalError(0, 0, "Invalid operator chain in cache file");
+                std::vector<BinaryOperator> ops;
+                for (uint32_t i = 0; i + 1 < count; i++) {
+                    uint8_t op = readU8();
+                    if (op > BinaryOperator::DIV_OP) throw InternalError(0, 0, "Invalid operator in cache file");
+                    ops.push_back(static_cast<BinaryOperator>(op));
+                }
+                std::vector<Expression*> operands(exprs.end() - count, exprs.end());
+                exprs.resize(exprs.size() - count);
+                nodes.heldExprs.insert(nodes.heldExprs.end(), operands.begin(), operands.end());
+                exprs.push_back(new Nary(std::move(operands), std::move(ops), readPosition(), tokens_));
+                break;
+            }
+            case UNARY_RECORD: {
+                uint8_t op = readU8();
+                if (op > UnaryOperator::MINUS_OP) throw InternalError(0, 0, "Invalid operator in cache file");
+                Expression* operand = popExpression();
+                exprs.push_back(new Unary(static_cast<UnaryOperator>(op), operand, readPosition(), tokens_));
+                break;
+            }
+            case INT_LITERAL_RECORD: {
+                int value = static_cast<int>(readU32());
+                exprs.push_back(new Literal(value, readPosition(), tokens_));
+                break;
+            }
+            case BOOL_LITERAL_RECORD: {
+                bool value = readU8() != 0;
+                exprs.push_back(new Literal(value, readPosition(), tokens_));
+                break;
+            }
+            case ID_LOCATION_RECORD: {
+                const std::string* id = readId();
+                exprs.push_back(new IdLocation(id, readPosition(), tokens_));
+                break;
+            }
+            case LIST_ELEMENT_LOCATION_RECORD: {
+                const std::string* id = readId();
+                Expression* index = popExpression();
+                exprs.push_back(new ListElementLocation(id, index, readPosition(), tokens_));
+                break;
+            }
+            case ASSIGNMENT_RECORD: {
+                Expression* expr = popExpression();
+                Expression* loc = popExpression();
+                if (loc->getExprType() != ExpressionType::LOAD_EXPR) throw InternalError(0, 0, "Invalid assignment record in cache file");
+                stmts.push_back(new AssignmentStatement(static_cast<Location*>(loc), expr, readPosition(), tokens_));
+                break;
+            }
+            case LIST_DECLARATION_RECORD: {
+                const std::string* id = readId();
+                int idLine = static_cast<int>(readU32());
+                stmts.push_back(new ListDeclarationStatement(id, idLine, readPosition(), tokens_));
+                break;
+            }
+            case LIST_APPEND_RECORD: {
+                const std::string* id = readId();
+                int idLine = static_cast<int>(readU32());
+                Expression* expr = popExpression();
+                stmts.push_back(new ListAppendStatement(id, idLine, expr, readPosition(), tokens_));
+                break;
+            }
+            case BREAK_RECORD:
+                stmts.push_back(new BreakStatement(readPosition(), tokens_));
+                break;
+            case CONTINUE_RECORD:
+                stmts.push_back(new ContinueStatement(readPosition(), tokens_));
+                break;
+            case PRINT_RECORD: {
+                Expression* expr = popExpression();
+                stmts.push_back(new PrintStatement(expr, readPosition(), tokens_));
+                break;
+            }
+            case COMPOUND_RECORD: {
+                uint8_t type = readU8();
+                uint32_t count = readU32();
+                if ((type != StatementType::IF_STMT && type != StatementType::WHILE_STMT) || count == 0 || count > blocks.size()) {
+                    throw InternalError(0, 0, "Invalid compound statement record in cache file");
+                }
+                std::vector<Block*> compoundBlocks(blocks.end() - count, blocks.end());
+                blocks.resize(blocks.size() - count);
+                nodes.heldBlocks.insert(nodes.heldBlocks.end(), compoundBlocks.begin(), compoundBlocks.end());
+                Expression* condition = popExpression();
+                stmts.push_back(new CompoundStatement(static_cast<StatementType>(type), condition, compoundBlocks, readPosition(), tokens_));
+                break;
+            }
+            case SIMPLE_BLOCK_RECORD: {
+                std::vector<Statement*> blockStmts = popStatements(readU32());
+                blocks.push_back(new SimpleBlock(blockStmts, readPosition(), tokens_));
+                break;
+            }
+            case ELIF_BLOCK_RECORD: {
+                Block* block = popBlock();
+                Expression* condition = popExpression();
+                blocks.push_back(new ElifBlock(condition, block, readPosition(), tokens_));
+                break;
+            }
+            case ELSE_BLOCK_RECORD: {
+                Block* block = popBlock();
+                blocks.push_back(new ElseBlock(block, readPosition(), tokens_));
+                break;
+            }
+            case PROGRAM_RECORD: {
+                std::vector<Statement*> programStmts = popStatements(readU32());
+                // Every node must belong to the tree and the file must end here
+                if (!exprs.empty() || !stmts.empty() || !blocks.empty() || offset_ != size_) {
+                    throw InternalError(0, 0, "Invalid program record in cache file");
+                }
+                nodes.release();
+                return new Program(programStmts, names_);
+            }
+            default:
+                throw InternalError(0, 0, "Invalid record in cache file");
+        }
+    }
+}
+
+/**
+ * @brief Deletes the nodes of an invalid file (none once the tree is complete)
+ */
+DecodedNodes::~DecodedNodes() {
+    for (Expression* expr : exprs) delete expr;
+    for (Statement* stmt : stmts) delete stmt;
+    for (Block* block : blocks) delete block;
+    for (Expression* expr : heldExprs) delete expr;
+    for (Statement* stmt : heldStmts) delete stmt;
+    for (Block* block : heldBlocks) delete block;
+}
+
+/**
+ * @brief Reads an 8-bit value
+ * @return The value read
+ */
+uint8_t ProgramReader::readU8() {
+    if (offset_ + 1 > size_) {
+        throw InternalError(0, 0, "Truncated cache file");
+    }
+    return static_cast<uint8_t>(data_[offset_++]);
+}
+
+/**
+ * @brief Reads a 32-bit value encoded as a varint
+ * @return The value read
+ */
+uint32_t ProgramReader::readU32() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = readU8();
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw InternalError(0, 0, "Invalid integer in cache file");
+}
+
+/**
+ * @brief Reads a 64-bit value (little endian)
+ * @return The value read
+ */
+uint64_t ProgramReader::readU64() {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= static_cast<uint64_t>(readU8()) << (8 * i);
+    return value;
+}
+
+/**
+ * @brief Reads the position of a node in the rebuilt token vector
+ * @return The position read
+ */
+int ProgramReader::readPosition() {
+    uint32_t position = readU32();
+    if (position >= tokens_.size()) {
+        throw InternalError(0, 0, "Invalid token reference in cache file");
+    }
+    return static_cast<int>(position);
+}
+
+/**
+ * @brief Reads a reference to an identifier of the table of names
+ * @return The interned name of the identifier
+ */
+const std::string* ProgramReader::readId() {
+    uint32_t index = readU32();
+    if (index >= ids_.size()) {
+        throw InternalError(0, 0, "Invalid identifier reference in cache file");
+    }
+    return ids_[index];
+}
@@ -0,0 +1,195 @@
+#if !defined(CACHE_H)
+#define CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "token.h"
+#include "syntax.h"
+#include "error.h"
+
+/**
+ * @file cache.h
+ * @brief Defines the persistent cache of compiled programs of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the ProgramCache class, which stores the Syntax Tree of
+ * a successfully parsed program in a binary file named after a hash of the source code and of
+ * the interpreter version (the file also holds the source, to tell apart colliding keys), and of the ProgramWriter and ProgramReader classes, which encode and
+ * decode that file.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Version of the interpreter, part of the cache key (change it whenever the Syntax Tree changes)
+#define INTERPRETER_VERSION "1.2.0"
+
+// First bytes and format version of a cache file
+#define CACHE_MAGIC "PSLC"
+#define CACHE_FORMAT_VERSION 3
+
+/**
+ * @enum CacheRecord
+ * @brief Tags of the records of a cache file, one record per node of the Syntax Tree
+ *
+ * Records are written in post-order: the children of a node always precede it, so the reader
+ * rebuilds the tree with a stack per kind of node (expressions, statements and blocks).
+ */
+enum CacheRecord {
+    BINARY_RECORD,
+    NARY_RECORD,
+    UNARY_RECORD,
+    INT_LITERAL_RECORD,
+    BOOL_LITERAL_RECORD,
+    ID_LOCATION_RECORD,
+    LIST_ELEMENT_LOCATION_RECORD,
+    ASSIGNMENT_RECORD,
+    LIST_DECLARATION_RECORD,
+    LIST_APPEND_RECORD,
+    BREAK_RECORD,
+    CONTINUE_RECORD,
+    PRINT_RECORD,
+    COMPOUND_RECORD,
+    SIMPLE_BLOCK_RECORD,
+    ELIF_BLOCK_RECORD,
+    ELSE_BLOCK_RECORD,
+    PROGRAM_RECORD
+};
+
+// FNV-1a hash, used for the cache key and for the checksum of the cache files
+uint64_t getChecksum(const char* data, size_t size);
+
+/**
+ * @class ProgramCache
+ * @brief Directory of compiled programs, keyed by the hash of their source code
+ *
+ * Only programs that were lexed and parsed successfully are stored, so errors are never cached.
+ */
+class ProgramCache{
+    public:
+        // constructors
+        ProgramCache() = delete;
+        ProgramCache(std::string directory) : directory_(std::move(directory)) {}
+        ProgramCache(ProgramCache const& pc) = delete;
+
+        // destructor
+        ~ProgramCache() = default;
+
+        // methods
+        Program* load(const std::string& source, std::vector<Token*>& tokens) const;
+        void store(const std::string& source, Program* program, std::vector<Token*> const& tokens) const;
+        std::string getPath(uint64_t key) const;
+        static uint64_t getKey(const std::string& source);
+
+    private:
+        std::string directory_;
+};
+
+/**
+ * @class ProgramWriter
+ * @brief Encodes a Syntax Tree into the binary format of the cache
+ *
+ * Only the tokens referenced by the positions of the nodes are written (their type, line and
+ * column, for error reporting) and the positions are renumbered accordingly. Identifiers are written
+ * once in a table of names.
+ */
+class ProgramWriter{
+    public:
+        // constructors
+        ProgramWriter() = delete;
+        ProgramWriter(std::vector<Token*> const& tokens) : tokens_(tokens), tokenIndexes_(tokens.size(), UNUSED_TOKEN) {}
+        ProgramWriter(ProgramWriter const& pw) = delete;
+
+        // destructor
+        ~ProgramWriter() = default;
+
+        // overload () operator to encode the Syntax Tree
+        std::string operator()(Program* program, uint64_t key, const std::string& source);
+
+    private:
+        static constexpr uint32_t UNUSED_TOKEN = UINT32_MAX;
+
+        // methods to encode the records
+        void writeExpression(Expression* expr);
+        void writeStatement(Statement* stmt);
+        void writeBlock(Block* block);
+        void writePosition(int position);
+        void writeId(const std::string& id);
+
+        // methods to encode values
+        static void writeU8(std::string& out, uint8_t value);
+        static void writeU32(std::string& out, uint32_t value);
+        static void writeU64(std::string& out, uint64_t value);
+
+        std::vector<Token*> const& tokens_;
+        std::vector<uint32_t> tokenIndexes_; // new index of each referenced position (UNUSED_TOKEN otherwise)
+        std::vector<Token*> usedTokens_; // referenced tokens, in order of their new index
+        std::unordered_map<std::string, uint32_t> idIndexes_; // index of each identifier in the table of names
+        std::vector<std::string> ids_; // table of names
+        std::string records_;
+};
+
+/**
+ * @struct DecodedNodes
+ * @brief Nodes decoded by a ProgramReader and not attached to the tree yet
+ *
+ * The stacks hold the nodes waiting for their parent record, the held vectors the children
+ * popped by the record being decoded. What is left when the reader stops at an error is deleted.
+ */
+struct DecodedNodes {
+    DecodedNodes() = default;
+    DecodedNodes(DecodedNodes const& dn) = delete;
+    ~DecodedNodes(); // defined in cache.cpp
+
+    // the held children belong to the node of the record just decoded
+    void release() { heldExprs.clear(); heldStmts.clear(); heldBlocks.clear(); }
+
+    std::vector<Expression*> exprs;
+    std::vector<Statement*> stmts;
+    std::vector<Block*> blocks;
+    std::vector<Expression*> heldExprs;
+    std::vector<Statement*> heldStmts;
+    std::vector<Block*> heldBlocks;
+};
+
+/**
+ * @class ProgramReader
+ * @brief Decodes a Syntax Tree from the binary format of the cache
+ *
+ * Every read is bounds checked: a truncated or corrupted file raises an InternalError.
+ * The rebuilt tokens only carry a type, a line and a column, which the nodes copy: the tree does
+ * not refer to them once it is decoded. The identifiers are interned in the NameTable of the program.
+ */
+class ProgramReader{
+    public:
+        // constructors
+        ProgramReader() = delete;
+        ProgramReader(const char* data, size_t size, std::vector<Token*>& tokens) : data_(data), size_(size), tokens_(tokens) {}
+        ProgramReader(ProgramReader const& pr) = delete;
+
+        // destructor
+        ~ProgramReader() = default;
+
+        // overload () operator to decode the Syntax Tree
+        Program* operator()(uint64_t key, const std::string& source);
+
+    private:
+        // methods to decode values
+        uint8_t readU8();
+        uint32_t readU32();
+        uint64_t readU64();
+        int readPosition();
+        const std::string* readId();
+
+        const char* data_;
+        size_t size_;
+        size_t offset_{0};
+        std::vector<Token*>& tokens_;
+        std::shared_ptr<NameTable> names_{std::make_shared<NameTable>()}; // identifiers of the decoded program
+        std::vector<const std::string*> ids_; // table of names, interned
+};
+
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file counters.cpp
+ * @brief Implements the operation counts of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the OperationCounts structure.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <iomanip>
+#include "counters.h"
+
+/**
+ * @brief Writes the counts as text, one per line
+ * @param out The output stream
+ */
+void OperationCounts::writeText(std::ostream& out) const {
+    out << std::left << std::setw(16) << "statements" << std::right << std::setw(16) << statements << std::endl
+        << std::left << std::setw(16) << "iterations" << std::right << std::setw(16) << iterations << std::endl
+        << std::left << std::setw(16) << "expressions" << std::right << std::setw(16) << expressions << std::endl
+        << std::left << std::setw(16) << "type checks" << std::right << std::setw(16) << typeChecks << std::endl
+        << std::left << std::setw(16) << "symbol lookups" << std::right << std::setw(16) << symbolLookups << std::endl
+        << std::left << std::setw(16) << "list accesses" << std::right << std::setw(16) << listAccesses << std::endl
+        << std::left << std::setw(16) << "allocations" << std::right << std::setw(16) << allocations << std::endl
+        << std::left << std::setw(16) << "alloc bytes" << std::right << std::setw(16) << allocatedBytes << std::endl;
+}
+
+/**
+ * @brief Writes the counts as a JSON object on one line
+ * @param out The output stream
+ */
+void OperationCounts::writeJson(std::ostream& out) const {
+    out << "{\"statements\":" << statements << ",\"iterations\":" << iterations
+        << ",\"expressions\":" << expressions << ",\"type_checks\":" << typeChecks
+        << ",\"symbol_lookups\":" << symbolLookups << ",\"list_accesses\":" << listAccesses
+        << ",\"allocations\":" << allocations << ",\"allocated_bytes\":" << allocatedBytes << "}" << std::endl;
+}
@@ -0,0 +1,43 @@
+#if !defined(COUNTERS_H)
+#define COUNTERS_H
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @file counters.h
+ * @brief Defines the operation counts of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the OperationCounts structure, the abstract work done
+ * by a run. Unlike times, the counts of a program are the same on every run of the same build
+ * with the same options, so two builds can be compared exactly on a noisy host.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+/**
+ * @struct OperationCounts
+ * @brief Cost vector of a run
+ *
+ * Statements, iterations and expressions are counted by the Visitor, lookups and element
+ * accesses by the SymbolTable (every search of one of its maps), allocations by the
+ * replacement of operator new of the executable (see Stats).
+ */
+struct OperationCounts {
+    uint64_t statements{0};     // statements executed, compound ones included
+    uint64_t iterations{0};     // checks of the condition of a while statement
+    uint64_t expressions{0};    // expression nodes evaluated
+    uint64_t typeChecks{0};     // expression nodes type checked without being evaluated
+    uint64_t symbolLookups{0};  // searches of an identifier in the symbol table
+    uint64_t listAccesses{0};   // list elements read, written or appended
+    uint64_t allocations{0};    // calls to operator new
+    uint64_t allocatedBytes{0}; // bytes requested from operator new
+
+    // methods to write the counts
+    void writeText(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+};
+
+
+#endif
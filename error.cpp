@@ -12,12 +12,15 @@
 
 #include <iostream>
 #include "error.h"
+#include "output.h"
 
 /**
  * Outputs an error message to stderr
+ * The buffered output of the program is flushed first, so it precedes the message
  * @param e The Error object containing error details
  */
 void error(const Error& e) {
+    OutputSink::flushAll();
     std::cerr << "Error: " << ErrorName(e.getErrorCode()) << " [" << e.getLine() << ":" << e.getColumn() << "] - " << e.what() << std::endl;
     exit(EXIT_FAILURE);
 }
@@ -41,6 +44,7 @@ std::string ErrorName(int error_code) {
         case EVALUATION_ERROR: return "EVALUATION_ERROR";
         case ZERO_DIVISION: return "ZERO_DIVISION";
         case TYPE_ERROR: return "TYPE_ERROR";
+        case LIMIT_ERROR: return "LIMIT_ERROR";
         default: return "UNKNOWN_ERROR";
     }
 }
\ No newline at end of file
@@ -27,7 +27,8 @@ enum ErrorCode {
     INDEX_ERROR,
     EVALUATION_ERROR,
     ZERO_DIVISION,
-    TYPE_ERROR
+    TYPE_ERROR,
+    LIMIT_ERROR
 };
 
 /**
@@ -182,6 +183,16 @@ class TypeError : public Error {
             : Error(line, column, TYPE_ERROR, message) {}
 };
 
+/**
+ * @class LimitError
+ * @brief Error class for runs exceeding their execution limits (statements, time or memory)
+ */
+class LimitError : public Error {
+    public:
+        LimitError(int line, int column, const std::string& message = "")
+            : Error(line, column, LIMIT_ERROR, message) {}
+};
+
 /**
  * Outputs an error message to stderr and exits the program
  * @param e The Error object containing error details
@@ -0,0 +1,114 @@
+/**
+ * @file interpreter.cpp
+ * @brief Implements the embeddable interface of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the compile() and run() functions and of the
+ * CompiledProgram class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <sstream>
+#include "interpreter.h"
+#include "lexer.h"
+#include "visitor.h"
+#include "error.h"
+
+/**
+ * @brief Formats the diagnostic as the command line interpreter does
+ * @return The formatted diagnostic, without the trailing newline
+ */
+std::string Diagnostic::toString() const {
+    return "Error: " + ErrorName(errorCode) + " [" + std::to_string(line) + ":" + std::to_string(column) + "] - " + message;
+}
+
+/**
+ * @brief Builds the diagnostic of an error
+ * @param e The error
+ * @return The diagnostic
+ */
+Diagnostic Diagnostic::fromError(const Error& e) {
+    return Diagnostic{e.getErrorCode(), e.getLine(), e.getColumn(), e.what()};
+}
+
+/**
+ * @brief Constructs a compiled program from its tokens (the Syntax Tree is built by parse())
+ * @param tokens The tokens of the source code, owned by the compiled program
+ * @param lazyBlocks Parse the bodies of blocks on their first execution
+ */
+CompiledProgram::CompiledProgram(std::vector<Token*> tokens, bool lazyBlocks)
+    : tokens_(tokens), parser_(std::move(tokens), lazyBlocks) {}
+
+/**
+ * @brief Deletes the Syntax Tree and the tokens
+ */
+CompiledProgram::~CompiledProgram() {
+    delete program_;
+    for (auto t : tokens_) {
+        delete t;
+    }
+}
+
+/**
+ * @brief Parses the tokens and builds the Syntax Tree, then frees the tokens
+ *
+ * Only the lazy blocks still parse from the tokens: without them the tokens are deleted here.
+ * @param threads The largest number of threads parsing the top-level statements
+ */
+void CompiledProgram::parse(size_t threads) {
+    parser_.setThreads(threads);
+    program_ = parser_();
+    if (parser_.freeTokens()) {
+        tokens_.clear();
+    }
+}
+
+/**
+ * @brief Lexes and parses a source code
+ * @param source The source code
+ * @param options The compile options
+ * @return The handle of the compiled program, or the diagnostic of the lexical or syntax error
+ */
+CompileResult compile(const std::string& source, const CompileOptions& options) {
+    CompileResult result;
+    std::istringstream input(source);
+    Lexer lexer(input);
+    try {
+        std::vector<Token*> tokens = options.lexerThreads > 1 ? Lexer::tokenizeParallel(source, options.lexerThreads) : lexer();
+        auto program = std::make_shared<CompiledProgram>(std::move(tokens), options.lazyBlocks);
+        program->parse(options.parserThreads);
+        result.program = std::move(program);
+    } catch (const Error& e) {
+        result.diagnostics.push_back(Diagnostic::fromError(e));
+    } catch (const std::exception& e) {
+        result.diagnostics.push_back(Diagnostic::fromError(InternalError(0, 0, e.what())));
+    }
+    return result;
+}
+
+/**
+ * @brief Runs a compiled program with its own Symbol Table and output sink
+ * @param program The handle of the compiled program
+ * @param options The run options
+ * @return Success, or the diagnostic of the runtime error
+ */
+RunResult run(const ProgramHandle& program, const RunOptions& options) {
+    RunResult result;
+    if (!program || !program->getProgram()) {
+        result.diagnostics.push_back(Diagnostic::fromError(InternalError(0, 0, "Null program")));
+        return result;
+    }
+    // the output written before an error is flushed by the destructor of the sink
+    OutputSink output(options.output ? options.output : [](const char*, size_t) {}, options.flushPolicy);
+    Visitor visitor(program->getProgram(), output);
+    visitor.setLimits(options.limits);
+    try {
+        visitor();
+    } catch (const Error& e) {
+        result.diagnostics.push_back(Diagnostic::fromError(e));
+    } catch (const std::exception& e) {
+        result.diagnostics.push_back(Diagnostic::fromError(InternalError(0, 0, e.what())));
+    }
+    return result;
+}
@@ -0,0 +1,121 @@
+#if !defined(INTERPRETER_H)
+#define INTERPRETER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "token.h"
+#include "syntax.h"
+#include "parser.h"
+#include "output.h"
+#include "error.h"
+#include "visitor.h"
+
+/**
+ * @file interpreter.h
+ * @brief Defines the embeddable interface of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the compile() and run() functions, which let an
+ * application compile a source code once and run the compiled program many times, also from
+ * several threads at once. Errors are returned as diagnostics instead of terminating the process.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+/**
+ * @struct Diagnostic
+ * @brief Description of an error raised while compiling or running a program
+ */
+struct Diagnostic {
+    int errorCode;       // one of the values of ErrorCode
+    int line;
+    int column;
+    std::string message;
+
+    // format the diagnostic as the command line interpreter does: Error: NAME [line:column] - message
+    std::string toString() const;
+    // build the diagnostic of an error
+    static Diagnostic fromError(const Error& e);
+};
+
+/**
+ * @class CompiledProgram
+ * @brief Syntax Tree of a program together with its parser (and its tokens, with lazy blocks)
+ *
+ * A compiled program is never modified by its runs (lazily parsed blocks are parsed once,
+ * under a lock), so it can be shared by concurrent runs.
+ */
+class CompiledProgram{
+    public:
+        // constructors
+        CompiledProgram() = delete;
+        CompiledProgram(std::vector<Token*> tokens, bool lazyBlocks);
+        CompiledProgram(CompiledProgram const& cp) = delete;
+
+        // destructor
+        ~CompiledProgram();
+
+        // methods
+        void parse(size_t threads = 1);
+        Program* getProgram() const { return program_; }
+
+    private:
+        std::vector<Token*> tokens_; // owned tokens until parsed (the parser holds a copy of the pointers)
+        Parser parser_;
+        Program* program_{nullptr};
+};
+
+// Handle of a compiled program, shared by the application and the runs in progress
+typedef std::shared_ptr<const CompiledProgram> ProgramHandle;
+
+/**
+ * @struct CompileOptions
+ * @brief Options of compile()
+ */
+struct CompileOptions {
+    bool lazyBlocks{false}; // parse the bodies of blocks on their first execution
+    size_t lexerThreads{1}; // lex large sources in chunks on up to this many threads (see Lexer::tokenizeParallel)
+    size_t parserThreads{1}; // parse the top-level statements of large sources on up to this many threads
+};
+
+/**
+ * @struct CompileResult
+ * @brief Result of compile(): the program handle or the diagnostic of the error
+ */
+struct CompileResult {
+    ProgramHandle program; // null if the compilation failed
+    std::vector<Diagnostic> diagnostics;
+
+    bool ok() const { return program != nullptr; }
+};
+
+/**
+ * @struct RunOptions
+ * @brief Options of run()
+ */
+struct RunOptions {
+    std::function<void(const char*, size_t)> output; // receives the output of the print statements (discarded if empty)
+    FlushPolicy flushPolicy{FLUSH_ON_SIZE};          // when the output is passed to the function
+    ExecutionLimits limits;                          // statement, time and memory limits (none by default)
+};
+
+/**
+ * @struct RunResult
+ * @brief Result of run(): success or the diagnostic of the runtime error
+ */
+struct RunResult {
+    std::vector<Diagnostic> diagnostics;
+
+    bool ok() const { return diagnostics.empty(); }
+};
+
+// Lexes and parses a source code
+CompileResult compile(const std::string& source, const CompileOptions& options = CompileOptions());
+
+// Runs a compiled program with a fresh Symbol Table (the output written before an error is kept)
+RunResult run(const ProgramHandle& program, const RunOptions& options = RunOptions());
+
+
+#endif
@@ -13,57 +13,359 @@
 #include "error.h"
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <exception>
+#include <streambuf>
+#include <thread>
+
+/**
+ * @class MemoryBuffer
+ * @brief Stream buffer reading a range of characters in place
+ */
+class MemoryBuffer : public std::streambuf{
+    public:
+        MemoryBuffer(const char* begin, const char* end) {
+            char* first = const_cast<char*>(begin); // the characters are only read
+            setg(first, first, first + (end - begin));
+        }
+};
+
+/**
+ * @struct LexerChunk
+ * @brief Part of the source lexed by one thread of tokenizeParallel()
+ */
+struct LexerChunk {
+    const char* begin;                  // first character (at the beginning of a line)
+    const char* end;                    // after the last character (a newline, except for the last chunk)
+    int line;                           // line of the first character
+    std::vector<Token*> tokens;         // tokens of the chunk, without the indentation tokens
+    std::vector<IndentationMark> marks; // indentation of the lines of the chunk
+    std::exception_ptr error;           // error that stopped the chunk (its tokens end there)
+    int endLine;                        // position after the last character
+    int endColumn;
+};
 
 /**
  * @brief Tokenizes the input file into a vector of tokens
- * @param file The input file stream to be tokenized
  * @return A vector of pointers to Token objects representing the tokenized input
  */
-std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
-
+std::vector<Token*> Lexer::tokenizeInputFile(){
     std::vector<Token*> res;
+    try {
+        while (Token* token = next()) {
+            res.push_back(token);
+        }
+    } catch (...) {
+        // the tokens lexed before the error are not returned
+        for (Token* token : res) {
+            delete token;
+        }
+        throw;
+    }
+    return res;
+}
+
+/**
+ * @brief Lexes a source in chunks of whole lines on several threads
+ *
+ * The source is split after newlines, so every chunk starts where a lexer is at the beginning
+ * of a line, with no token pending; the line of its first character is counted beforehand.
+ * The chunk lexers cannot know the blocks and the parentheses opened before their chunk, so
+ * they record the indentation of each line and skip the checks of the parentheses. A
+ * sequential pass then merges the chunks in order, producing the INDENT and DEDENT tokens from
+ * the indentation stack and checking the parentheses, so the tokens and the first error are
+ * the ones of a single lexer.
+ * @param source The source code
+ * @param threads The largest number of threads (chunks are at least LEXER_CHUNK_SIZE bytes)
+ * @return The tokens, ending with the EOF token
+ */
+std::vector<Token*> Lexer::tokenizeParallel(const std::string& source, size_t threads){
+    const char* begin = source.data();
+    const char* end = begin + source.size();
+    size_t count = std::max<size_t>(1, std::min(threads, source.size() / LEXER_CHUNK_SIZE));
+    if (count == 1) {
+        MemoryBuffer buffer(begin, end);
+        std::istream input(&buffer);
+        Lexer lexer(input);
+        return lexer();
+    }
+
+    // Split the source after the first newline following each share of its size
+    std::vector<LexerChunk> chunks;
+    const char* start = begin;
+    int line = 1;
+    for (size_t c = 1; c <= count && start < end; c++) {
+        const char* stop = std::max(start, begin + source.size() / count * c);
+        if (c == count) {
+            stop = end;
+        } else {
+            stop = std::find(stop, end, '\n');
+            if (stop != end) stop++;
+        }
+        chunks.push_back(LexerChunk{start, stop, line, {}, {}, nullptr, 0, 0});
+        line += std::count(start, stop, '\n');
+        start = stop;
+    }
+
+    // Lex the chunks, the first one on the calling thread
+    std::vector<std::thread> workers;
+    for (size_t c = 1; c < chunks.size(); c++) {
+        workers.emplace_back(&Lexer::tokenizeChunk, std::ref(chunks[c]));
+    }
+    tokenizeChunk(chunks[0]);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return mergeChunks(chunks);
+}
+
+/**
+ * @brief Lexes one chunk of tokenizeParallel(), keeping its tokens up to its first error
+ * @param chunk The chunk
+ */
+void Lexer::tokenizeChunk(LexerChunk& chunk){
+    MemoryBuffer buffer(chunk.begin, chunk.end);
+    std::istream input(&buffer);
+    Lexer lexer(input, chunk.line, &chunk.marks);
+    try {
+        while (Token* token = lexer.next()) {
+            chunk.tokens.push_back(token);
+        }
+    } catch (...) {
+        chunk.error = std::current_exception();
+    }
+    chunk.endLine = lexer.line_;
+    chunk.endColumn = lexer.column_;
+}
+
+/**
+ * @brief Merges the tokens of the chunks in order, resolving the indentation and checking the parentheses
+ *
+ * The checks are the ones of scan(), done in the order of the source, so the first error raised
+ * (here or by a chunk lexer) is the one a single lexer raises. After an error every token is deleted.
+ * @param chunks The lexed chunks
+ * @return The tokens, ending with the EOF token
+ */
+std::vector<Token*> Lexer::mergeChunks(std::vector<LexerChunk>& chunks){
+    size_t total = 0;
+    for (const LexerChunk& chunk : chunks) {
+        total += chunk.tokens.size() + chunk.marks.size();
+    }
+    std::vector<Token*> tokens;
+    tokens.reserve(total + 1);
+    std::vector<int> indentStack{0};
+    std::vector<int> parStack;
+    size_t c = 0;
+    size_t t = 0; // next token of chunks[c] to merge
+    try {
+        for (; c < chunks.size(); c++) {
+            LexerChunk& chunk = chunks[c];
+            size_t m = 0;
+            for (t = 0; t <= chunk.tokens.size(); t++) {
+                // Indentation tokens of the line starting at this token
+                for (; m < chunk.marks.size() && chunk.marks[m].token == t; m++) {
+                    const IndentationMark& mark = chunk.marks[m];
+                    if (mark.level > indentStack.back()) {
+                        indentStack.push_back(mark.level);
+                        tokens.push_back(new IndentationToken(true, mark.line, mark.column));
+                    }
+                    else if (mark.level < indentStack.back()) {
+                        int dedents = 0;
+                        while (mark.level < indentStack.back()) {
+                            indentStack.pop_back();
+                            dedents++;
+                        }
+                        if (mark.level != indentStack.back()) {
+                            throw IndentationError(mark.line, mark.column, "Invalid indentation level");
+                        }
+                        for (int d = 0; d < dedents; d++) {
+                            tokens.push_back(new IndentationToken(false, mark.line, mark.column));
+                        }
+                    }
+                }
+                if (t == chunk.tokens.size()) break;
+
+                // Parentheses and brackets
+                Token* token = chunk.tokens[t];
+                if (token->getType() == TokenType::PUNCTUATION_TOKEN) {
+                    int punctuation = token->getIntValue();
+                    if (punctuation == PunctuationToken::LPAR) parStack.push_back(1);
+                    else if (punctuation == PunctuationToken::LBRACK) parStack.push_back(0);
+                    else if (punctuation == PunctuationToken::RPAR) {
+                        if (parStack.empty() || (parStack.back() == 0)) {
+                            throw LexicalError(token->getLine(), token->getColumn(), "Mismatched parenthesis");
+                        }
+                        parStack.pop_back();
+                    }
+                    else if (punctuation == PunctuationToken::RBRACK) {
+                        if (parStack.empty() || (parStack.back() == 1)) {
+                            throw LexicalError(token->getLine(), token->getColumn(), "Mismatched brackets");
+                        }
+                        parStack.pop_back();
+                    }
+                }
+                tokens.push_back(token);
+            }
+            // The chunk stopped at its error
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+        }
+
+        // The end of the file: unclosed parentheses, then the blocks still open and the EOF token
+        const LexerChunk& last = chunks.back();
+        if (!parStack.empty()) {
+            throw LexicalError(last.endLine, last.endColumn, "Mismatched parenthesis or brackets");
+        }
+        for (size_t d = 1; d < indentStack.size(); d++) {
+            tokens.push_back(new IndentationToken(false, last.endLine, last.endColumn));
+        }
+        tokens.push_back(new EndOfFileToken(last.endLine, last.endColumn));
+    } catch (...) {
+        // Delete the merged tokens and the ones of the chunks not merged yet
+        for (Token* token : tokens) {
+            delete token;
+        }
+        for (; c < chunks.size(); c++, t = 0) {
+            for (; t < chunks[c].tokens.size(); t++) {
+                delete chunks[c].tokens[t];
+            }
+        }
+        throw;
+    }
+    return tokens;
+}
+
+/**
+ * @brief Deletes the tokens looked ahead and never returned
+ */
+Lexer::~Lexer() {
+    for (size_t i = 0; i < buffered_; i++) {
+        delete lookahead_[(head_ + i) % LEXER_LOOKAHEAD];
+    }
+}
+
+/**
+ * @brief Returns the next token
+ * @return The token (owned by the caller), nullptr after the EOF token
+ */
+Token* Lexer::next() {
+    if (buffered_ == 0) {
+        return scan();
+    }
+    Token* token = lookahead_[head_];
+    head_ = (head_ + 1) % LEXER_LOOKAHEAD;
+    buffered_--;
+    return token;
+}
+
+/**
+ * @brief Returns a token ahead without consuming it
+ * @param k The number of tokens to skip (0 for the token returned by the next call to next())
+ * @return The token (still owned by the lexer), nullptr if the file ends before it
+ */
+Token* Lexer::peek(size_t k) {
+    if (k >= LEXER_LOOKAHEAD) {
+        throw InternalError(line_, column_, "Lookahead beyond the capacity of the lexer");
+    }
+    while (buffered_ <= k) {
+        Token* token = scan();
+        if (!token) {
+            return nullptr;
+        }
+        lookahead_[(head_ + buffered_) % LEXER_LOOKAHEAD] = token;
+        buffered_++;
+    }
+    return lookahead_[(head_ + k) % LEXER_LOOKAHEAD];
+}
+
+/**
+ * @brief Records the last token produced, which decides if the following spaces are an indentation
+ * @param token The token
+ * @return The token
+ */
+Token* Lexer::produce(Token* token) {
+    lineStart_ = token->getType() == TokenType::NEWLINE_TOKEN;
+    produced_++;
+    return token;
+}
+
+/**
+ * @brief Reads the characters of the next token from the file
+ *
+ * A change of indentation is found on the first character of a line, before its own token:
+ * the INDENT or DEDENT tokens are returned first and the character is held for the next call.
+ * @return The token, nullptr after the EOF token
+ */
+Token* Lexer::scan(){
+    // Dedentations of the same line are returned one per call
+    if (pendingDedents_ > 0) {
+        pendingDedents_--;
+        return produce(new IndentationToken(false, line_, column_));
+    }
+    if (finished_) {
+        return nullptr;
+    }
+
     // Read the file content 1 character at a time
     char ch;
-    int n_t = 0; // indentation level
-    bool indent = true; // bool variable used to track if we are at the beginning of a new line
-
-    while (getChar(file, ch)) {
-        // Indentation handling
-
-        // check for spaces and tabs at the beginning of a line
-        if (
-            ((ch == ' ') || (ch == '\t')) &&
-            (res.empty() || (res.back()->getType() == TokenType::NEWLINE_TOKEN) && 
-            indent)
-        ) {
-            // if we find any, we increase the indentation level counter
-            n_t++;
-            if (ch == '\t') n_t+=3; // tabs count as 4 spaces
-            continue;
-        }
-        // If we find a non-space/tab character, we check the indentation level
-        else if (((ch != ' ') && (ch != '\t') && (ch != '\n') && (ch != '\r')) && indent) {
-            indent = false;
-            if (n_t > indentStack_.back()) {
-                indentStack_.push_back(n_t);
-                res.push_back(new IndentationToken(true, line_, column_));
+    while (true) {
+        // The character held by a change of indentation has already been through its handling
+        if (held_) {
+            ch = heldChar_;
+            held_ = false;
+        }
+        else {
+            if (ended_ || !getChar(file_, ch)) break;
+
+            // Indentation handling
+
+            // check for spaces and tabs at the beginning of a line
+            if (
+                ((ch == ' ') || (ch == '\t')) &&
+                (lineStart_ && indent_)
+            ) {
+                // if we find any, we increase the indentation level counter
+                indentLevel_++;
+                if (ch == '\t') indentLevel_+=3; // tabs count as 4 spaces
+                continue;
             }
-            else if (n_t < indentStack_.back()) {
-                // Check if the indentation level is valid (n_t must be in the stack)
-                while (n_t < indentStack_.back()) {
-                    indentStack_.pop_back();
-                    res.push_back(new IndentationToken(false, line_, column_));
+            // If we find a non-space/tab character, we check the indentation level
+            else if (((ch != ' ') && (ch != '\t') && (ch != '\n') && (ch != '\r')) && indent_) {
+                indent_ = false;
+                int level = indentLevel_;
+                indentLevel_ = 0; // reset the indentation level counter
+                if (marks_) {
+                    // A chunk lexer does not know the blocks opened before its chunk: the character is
+                    // lexed now and the merge produces the indentation tokens before its token
+                    marks_->push_back(IndentationMark{produced_, level, line_, column_});
                 }
-                if (n_t != indentStack_.back()) {
-                    throw IndentationError(line_, column_, "Invalid indentation level");
+                else if (level > indentStack_.back()) {
+                    indentStack_.push_back(level);
+                    held_ = true;
+                    heldChar_ = ch;
+                    return produce(new IndentationToken(true, line_, column_));
+                }
+                else if (level < indentStack_.back()) {
+                    // Check if the indentation level is valid (level must be in the stack)
+                    while (level < indentStack_.back()) {
+                        indentStack_.pop_back();
+                        pendingDedents_++;
+                    }
+                    if (level != indentStack_.back()) {
+                        throw IndentationError(line_, column_, "Invalid indentation level");
+                    }
+                    held_ = true;
+                    heldChar_ = ch;
+                    pendingDedents_--;
+                    return produce(new IndentationToken(false, line_, column_));
                 }
             }
-            n_t = 0; // reset the indentation level counter
-        }
-        // if we find a newline character, we reset the indentation tracking variable
-        else if ((ch == '\n') || (ch == '\r')) {
-            indent = true;
-            n_t = 0; // reset the indentation level counter
+            // if we find a newline character, we reset the indentation tracking variable
+            else if ((ch == '\n') || (ch == '\r')) {
+                indent_ = true;
+                indentLevel_ = 0; // reset the indentation level counter
+            }
         }
 
         // Check if the character is a letter (identifier or reserved keyword)
@@ -71,8 +373,8 @@ std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
             // Entering an internal loop to read the full word (id or reserved keyword or boolean operator)
             std::string word;
             word += ch; // Add the first character
-            while ((file.peek() >= 'a' && file.peek() <= 'z') || (file.peek() >= 'A' && file.peek() <= 'Z') || (file.peek() >= '0' && file.peek() <= '9')) {
-                getChar(file, ch); // consume the next character
+            while ((file_.peek() >= 'a' && file_.peek() <= 'z') || (file_.peek() >= 'A' && file_.peek() <= 'Z') || (file_.peek() >= '0' && file_.peek() <= '9')) {
+                getChar(file_, ch); // consume the next character
                 word += ch; // add it to the word
             }
 
@@ -88,8 +390,7 @@ std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
                 word == "append" ||
                 word == "print"
             ) {
-                res.push_back(new ReservedKeywordToken(word, line_, column_));
-                continue;
+                return produce(new ReservedKeywordToken(word, line_, column_));
             }
 
             // Check if the word is a boolean operator
@@ -98,23 +399,19 @@ std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
                 word == "or" ||
                 word == "not"
             ) {
-                res.push_back(new BoolOpToken(word, line_, column_));
-                continue;
+                return produce(new BoolOpToken(word, line_, column_));
             }
 
             // Check if the word is a boolean literal
             if (word == "True") {
-                res.push_back(new BoolToken(true, line_, column_));
-                continue;
+                return produce(new BoolToken(true, line_, column_));
             }
             else if (word == "False") {
-                res.push_back(new BoolToken(false, line_, column_));
-                continue;
+                return produce(new BoolToken(false, line_, column_));
             }
 
             // If the word is not a ReservedKeyword or a BoolOperator, than it is an Id
-            res.push_back(new IdToken(word, line_, column_));
-            continue;
+            return produce(new IdToken(word, line_, column_));
         }
 
         // Check if the character is a digit
@@ -123,151 +420,131 @@ std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
             numStr += ch;
 
             // if the number is longer than 1 digit, we enter an internal loop to read the full number
-            while(file.peek() >= '0' && file.peek() <= '9') {
-                getChar(file, ch); // consume the next character
+            while(file_.peek() >= '0' && file_.peek() <= '9') {
+                getChar(file_, ch); // consume the next character
                 numStr += ch; // add it to the number string
             }
             
             // create the token and add it to the vector
-            res.push_back(new NumberToken(numStr, line_, column_));
-            continue;
+            return produce(new NumberToken(numStr, line_, column_));
         }
 
         // Check if the character is a newline or carriage return
         if ((ch == '\n') || (ch == '\r')) {
-            res.push_back(new NewLineToken(line_, column_));
-
             // Reset indentation tracking variable
-            indent = true;
-            continue;
+            indent_ = true;
+            return produce(new NewLineToken(line_, column_));
         }
 
         // Check if the character is a zero (0)
         if (ch == '0') {
             // Check if the next character is a digit (invalid number)
-            if (file.peek() >= '0' && file.peek() <= '9') {
+            if (file_.peek() >= '0' && file_.peek() <= '9') {
                 throw LexicalError(line_, column_, "Invalid integer value: leading zeros are not allowed");
             }
             else {
-                res.push_back(new NumberToken("0", line_, column_));
-                continue;
+                return produce(new NumberToken("0", line_, column_));
             }
         }
 
         // Check if the character is an assignment operator
         if (ch == '=') {
             // We need 1 character lookahead to distinguish between '=' and '=='
-            if (file.peek() == '=') {
-                getChar(file, ch); // consume the next character
-                res.push_back(new RelationalToken(RelationalToken::EQ, line_, column_));
-                continue;
+            if (file_.peek() == '=') {
+                getChar(file_, ch); // consume the next character
+                return produce(new RelationalToken(RelationalToken::EQ, line_, column_));
             } else {
-                res.push_back(new AssignmentToken(line_, column_));
-                continue;
+                return produce(new AssignmentToken(line_, column_));
             }
         }
 
         // Check for occurrences of the remaining relational operators (!=, <, >, <=, >=)
-        if ((ch == '!') && (file.peek() == '=')){
-            getChar(file, ch); // consume the next character
-            res.push_back(new RelationalToken(RelationalToken::NEQ, line_, column_));
-            continue;
+        if ((ch == '!') && (file_.peek() == '=')){
+            getChar(file_, ch); // consume the next character
+            return produce(new RelationalToken(RelationalToken::NEQ, line_, column_));
         }
         else if (ch == '<'){
-            if (file.peek() == '=') {
-                getChar(file, ch); // consume the next character
-                res.push_back(new RelationalToken(RelationalToken::LE, line_, column_));
-                continue;
+            if (file_.peek() == '=') {
+                getChar(file_, ch); // consume the next character
+                return produce(new RelationalToken(RelationalToken::LE, line_, column_));
             }
             else {
-                res.push_back(new RelationalToken(RelationalToken::LT, line_, column_));
-                continue;
+                return produce(new RelationalToken(RelationalToken::LT, line_, column_));
             }
         }
         else if (ch == '>'){
-            if (file.peek() == '=') {
-                getChar(file, ch); // consume the next character
-                res.push_back(new RelationalToken(RelationalToken::GE, line_, column_));
-                continue;
+            if (file_.peek() == '=') {
+                getChar(file_, ch); // consume the next character
+                return produce(new RelationalToken(RelationalToken::GE, line_, column_));
             }
             else {
-                res.push_back(new RelationalToken(RelationalToken::GT, line_, column_));
-                continue;
+                return produce(new RelationalToken(RelationalToken::GT, line_, column_));
             }
         }
 
         // Check if the character is an arithmetic operator
         if (ch == '+') {
-            res.push_back(new ArithmeticToken(ArithmeticToken::ADD, line_, column_));
-            continue;
+            return produce(new ArithmeticToken(ArithmeticToken::ADD, line_, column_));
         }
         else if (ch == '-') {
-            res.push_back(new ArithmeticToken(ArithmeticToken::SUB, line_, column_ ));
-            continue;
+            return produce(new ArithmeticToken(ArithmeticToken::SUB, line_, column_ ));
         }
         else if (ch == '*') {
-            res.push_back(new ArithmeticToken(ArithmeticToken::MUL, line_, column_));
-            continue;
+            return produce(new ArithmeticToken(ArithmeticToken::MUL, line_, column_));
         }
         else if (ch == '/') {
-            if (file.peek() == '/') {
-                getChar(file, ch); // consume the next character
-                res.push_back(new ArithmeticToken(ArithmeticToken::DIV, line_, column_));
+            if (file_.peek() == '/') {
+                getChar(file_, ch); // consume the next character
+                return produce(new ArithmeticToken(ArithmeticToken::DIV, line_, column_));
             }
             else {
                 throw LexicalError(line_, column_, "Invalid character '/' (did you mean '//' for integer division?)");
             }
-            continue;
         }
 
         // Check if the character is a punctuation character
         if (ch == ':') {
-            res.push_back(new PunctuationToken(PunctuationToken::COL, line_, column_));
-            continue;
+            return produce(new PunctuationToken(PunctuationToken::COL, line_, column_));
         }
         else if (ch == '.') {
-            res.push_back(new PunctuationToken(PunctuationToken::PERIOD, line_, column_));
-            continue;
+            return produce(new PunctuationToken(PunctuationToken::PERIOD, line_, column_));
         }
 
         // Check if the character is a parenthesis
+        // (a chunk lexer does not know the parentheses opened before its chunk: the merge checks them)
         if (ch == '(') {
-            res.push_back(new PunctuationToken(PunctuationToken::LPAR, line_, column_));
-            
-            parStack_.push_back(1); // update the parenthesis stack
-            continue;
+            if (!marks_) parStack_.push_back(1); // update the parenthesis stack
+            return produce(new PunctuationToken(PunctuationToken::LPAR, line_, column_));
         }
         else if (ch == ')') {
-            res.push_back(new PunctuationToken(PunctuationToken::RPAR, line_, column_));
+            if (!marks_) {
+                // check for mismatched parenthesis
+                if (parStack_.empty() || (parStack_.back() == 0)) {
+                    throw LexicalError(line_, column_, "Mismatched parenthesis");
+                }
 
-            // check for mismatched parenthesis
-            if (parStack_.empty() || (parStack_.back() == 0)) {
-                throw LexicalError(line_, column_, "Mismatched parenthesis");
+                // update the parenthesis stack
+                parStack_.pop_back();
             }
-
-            // update the parenthesis stack
-            parStack_.pop_back();
-            continue;
+            return produce(new PunctuationToken(PunctuationToken::RPAR, line_, column_));
         }
 
         // Check if the character is a bracket
         if (ch == '[') {
-            res.push_back(new PunctuationToken(PunctuationToken::LBRACK, line_, column_));
-
-            parStack_.push_back(0); // update the parenthesis stack
-            continue;
+            if (!marks_) parStack_.push_back(0); // update the parenthesis stack
+            return produce(new PunctuationToken(PunctuationToken::LBRACK, line_, column_));
         }
         else if (ch == ']') {
-            res.push_back(new PunctuationToken(PunctuationToken::RBRACK, line_, column_));
+            if (!marks_) {
+                // check for mismatched brackets
+                if (parStack_.empty() || (parStack_.back() == 1)) {
+                    throw LexicalError(line_, column_, "Mismatched brackets");
+                }
 
-            // check for mismatched brackets
-            if ((parStack_.back() == 1) || (parStack_.empty())) {
-                throw LexicalError(line_, column_, "Mismatched brackets");
+                // update the bracket stack
+                parStack_.pop_back();
             }
-
-            // update the bracket stack
-            parStack_.pop_back();
-            continue;
+            return produce(new PunctuationToken(PunctuationToken::RBRACK, line_, column_));
         }
 
 
@@ -277,23 +554,36 @@ std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
         }
     }
 
-    // Check for mismatched parenthesis at the end of the file
-    if (!parStack_.empty()) {
-        throw LexicalError(line_, column_, "Mismatched parenthesis or brackets");
-    }
-    
-    // Check if the indentation stack is back to the initial state
-    while(indentStack_.size() > 1) {
-        indentStack_.pop_back();
-        res.push_back(new IndentationToken(false, line_, column_));
+    // The end of a chunk is not the end of the file: the merge closes the blocks
+    if (marks_) {
+        finished_ = true;
+        return nullptr;
     }
 
-    // Add EOF token at the end of the vector
-    if (file.eof()) {
-        res.push_back(new EndOfFileToken(line_, column_));
+    // The end of the file closes the blocks still open (once, even if more tokens are pulled)
+    if (!ended_) {
+        ended_ = true;
+
+        // Check for mismatched parenthesis at the end of the file
+        if (!parStack_.empty()) {
+            throw LexicalError(line_, column_, "Mismatched parenthesis or brackets");
+        }
+
+        // Check if the indentation stack is back to the initial state
+        pendingDedents_ = indentStack_.size() - 1;
+        indentStack_.resize(1);
+        if (pendingDedents_ > 0) {
+            pendingDedents_--;
+            return produce(new IndentationToken(false, line_, column_));
+        }
     }
 
-    return res;
+    // Add EOF token at the end of the tokens
+    finished_ = true;
+    if (file_.eof()) {
+        return produce(new EndOfFileToken(line_, column_));
+    }
+    return nullptr;
 }
 
 /**
@@ -301,7 +591,7 @@ std::vector<Token*> Lexer::tokenizeInputFile(std::ifstream& file){
  * @param file The input file stream
  * @param ch The character to be updated
  */
-bool Lexer::getChar(std::ifstream& file, char& ch){
+bool Lexer::getChar(std::istream& file, char& ch){
     if(file.get(ch)){
         if(ch == '\n'){
             line_++;
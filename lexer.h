@@ -3,6 +3,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 #include "token.h"
 #include "error.h"
@@ -18,41 +19,116 @@
  * @date 08-2025
  */
 
+// Largest lookahead of peek() (capacity of the ring buffer of the lexer)
+#define LEXER_LOOKAHEAD 4
+
+// Smallest chunk of the source lexed by one thread of tokenizeParallel() (bytes)
+#define LEXER_CHUNK_SIZE (1 << 16)
+
+/**
+ * @struct IndentationMark
+ * @brief Indentation of a line lexed by a chunk lexer, compared with the open blocks when the chunks are merged
+ */
+struct IndentationMark {
+    size_t token; // number of tokens of the chunk before the first token of the line
+    int level;    // indentation of the line
+    int line;     // position of the first character of the line
+    int column;
+};
+
+// Part of the source lexed by one thread of tokenizeParallel() (defined in lexer.cpp)
+struct LexerChunk;
+
+/**
+ * @class TokenSource
+ * @brief Producer of the tokens pulled by a streaming Parser
+ *
+ * next() returns the tokens in order, then nullptr after the EOF token, and raises the lexical
+ * error at the position where the lexer stopped. The tokens returned belong to the caller.
+ */
+class TokenSource{
+    public:
+        // destructor (virtual)
+        virtual ~TokenSource() = default;
+
+        // method to pull the next token
+        virtual Token* next() = 0;
+};
+
 /**
  * @class Lexer
  * @brief Lexical analyzer for the Python-Sublanguage interpreter
  *
  * The Lexer class is responsible for splitting the input file into
  * a token vector that can be used by the parser.
+ * Tokens are produced on demand: next() returns the next token and peek(k) looks k tokens
+ * ahead, reading only the characters needed. The tokens looked ahead wait in a small ring
+ * buffer, so a consumer pulling the tokens one by one keeps O(lookahead) of them in the lexer.
+ * The tokens returned by next() belong to the caller.
+ * A source held in memory can also be lexed by several threads with tokenizeParallel().
  */
-class Lexer{
+class Lexer : public TokenSource{
     public:
         // constructors
         Lexer() = delete;
-        Lexer(std::ifstream& file) : file_(file) {}
+        Lexer(std::istream& file) : file_(file) {}
         Lexer(Lexer const& l) = delete;
 
         // destructor
-        ~Lexer() = default;
+        ~Lexer() override;
 
         // overload () operator to perform the lexing (the output overwrites the attribute tokens_)
         std::vector<Token*> operator()() {
-            return tokenizeInputFile(file_);
+            return tokenizeInputFile();
         }
 
+        // method to lex a source in chunks of whole lines on up to threads threads (same tokens and errors as a single lexer)
+        static std::vector<Token*> tokenizeParallel(const std::string& source, size_t threads);
+
+        // methods to pull the tokens one at a time (next() returns nullptr after the EOF token)
+        Token* next() override;
+        Token* peek(size_t k = 0);
+
         // method to get the next char and update the line and column counters
-        bool getChar(std::ifstream& file, char& ch);
+        bool getChar(std::istream& file, char& ch);
 
     private:
+        // constructor of a chunk lexer, which leaves the indentation and the parentheses to the merge of the chunks
+        Lexer(std::istream& file, int line, std::vector<IndentationMark>* marks) : file_(file), line_(line), marks_(marks) {}
+
+        // methods to lex the chunks of tokenizeParallel() and to merge them
+        static void tokenizeChunk(LexerChunk& chunk);
+        static std::vector<Token*> mergeChunks(std::vector<LexerChunk>& chunks);
+
         // method to tokenize the input file
-        std::vector<Token*> tokenizeInputFile(std::ifstream& file);
+        std::vector<Token*> tokenizeInputFile();
+        // methods to read the next token from the file
+        Token* scan();
+        Token* produce(Token* token);
 
         // indentation stack to keep track of indentation levels
-        std::ifstream& file_;
+        std::istream& file_;
         std::vector<int> indentStack_{0};
         std::vector<int> parStack_;
         int line_{1};
         int column_{0};
+
+        // state of the scan between two tokens
+        int indentLevel_{0};                  // indentation of the current line read so far
+        bool indent_{true};                   // we are at the beginning of a new line
+        bool lineStart_{true};                // no token or a newline token was produced last
+        bool held_{false};                    // heldChar_ was read but its token is not produced yet
+        char heldChar_{0};
+        int pendingDedents_{0};               // dedentations to produce before the held character
+        bool ended_{false};                   // the end of the file was reached
+        bool finished_{false};                // the EOF token was produced
+        size_t produced_{0};                  // tokens produced so far
+        std::vector<IndentationMark>* marks_{nullptr}; // indentation of the lines (chunk lexers only)
+
+        // ring buffer of the tokens looked ahead
+        Token* lookahead_[LEXER_LOOKAHEAD]{};
+        size_t head_{0};
+        size_t buffered_{0};
 };
 
 #endif
\ No newline at end of file
@@ -11,6 +11,12 @@
 
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <memory>
+#include <unistd.h>
 #include "token.h"
 #include "lexer.h"
 #include "parser.h"
@@ -19,60 +25,360 @@
 #include "syntax.h"
 #include "semantics.h"
 #include "types.h"
+#include "cache.h"
+#include "output.h"
+#include "batch.h"
+#include "server.h"
+#include "profiler.h"
+#include "sampler.h"
+#include "stats.h"
+#include "tracer.h"
+#include "perf.h"
+#include "pipeline.h"
+
+/**
+ * @brief Writes the results of the profiler
+ * @param profiler The profiler
+ * @param path The file of the text report (the folded stacks go to path.folded), empty for stderr
+ */
+static void writeProfile(Profiler& profiler, const std::string& path) {
+    profiler.finish();
+    if(path.empty()){
+        profiler.writeReport(std::cerr);
+        return;
+    }
+    std::ofstream report(path);
+    profiler.writeReport(report);
+    std::ofstream folded(path + ".folded");
+    profiler.writeFolded(folded);
+}
+
+/**
+ * @brief Stops the sampler and writes its histogram
+ * @param path The file of the histogram, empty for stderr
+ */
+static void writeSamples(const std::string& path) {
+    Sampler::stop();
+    if(path.empty()){
+        Sampler::writeHistogram(std::cerr);
+        return;
+    }
+    std::ofstream histogram(path);
+    Sampler::writeHistogram(histogram);
+}
+
+/**
+ * @brief Ends the last phase and writes the statistics of the run to stderr
+ * @param stats The statistics
+ * @param program The Syntax Tree (null if the parser failed)
+ * @param visitor The visitor that ran the program (null if it did not start)
+ * @param json Write the report as JSON instead of text
+ */
+static void writeStats(Stats& stats, Program* program, Visitor* visitor, bool json) {
+    stats.end();
+    if(program) stats.countNodes(program);
+    if(visitor) stats.setSymbolTable(visitor->getSymbolTable());
+    if(json) stats.writeJson(std::cerr);
+    else stats.writeText(std::cerr);
+}
+
+/**
+ * @brief Writes the operation counts of the run to stderr
+ * @param visitor The visitor that ran the program (null if it did not start)
+ * @param allocations The allocations of the process before the lexer started
+ * @param allocatedBytes The bytes allocated before the lexer started
+ * @param json Write the counts as JSON instead of text
+ */
+static void writeCounts(Visitor* visitor, uint64_t allocations, uint64_t allocatedBytes, bool json) {
+    OperationCounts counts;
+    if(visitor) counts = visitor->getOperationCounts();
+    counts.allocations = Stats::getThreadAllocations() - allocations;
+    counts.allocatedBytes = Stats::getThreadAllocatedBytes() - allocatedBytes;
+    if(json) counts.writeJson(std::cerr);
+    else counts.writeText(std::cerr);
+}
+
+/**
+ * @brief Ends the regions still open and writes the report of the perf counters to stderr
+ * @param perf The perf counters
+ * @param visitor The visitor that ran the program (null if it did not start)
+ */
+static void writePerf(PerfCounters& perf, Visitor* visitor) {
+    uint64_t executed = visitor ? visitor->getOperationCounts().statements : 0;
+    perf.finish(executed);
+    perf.writeReport(std::cerr, executed);
+}
+
+/**
+ * @brief Ends the spans still open and writes the trace
+ * @param tracer The tracer
+ * @param path The file of the trace
+ */
+static void writeTrace(Tracer& tracer, const std::string& path) {
+    tracer.finish();
+    std::ofstream trace(path);
+    tracer.write(trace);
+}
 
 int main(int argc, char* argv[]) {
+    // Parse the command line: options, then the input file
+    bool lazyBlocks = false; // --lazy-blocks: parse block bodies on their first execution
+    std::string cacheDir; // --cache-dir=DIR: reuse the Syntax Tree of previous runs of the same source
+    FlushPolicy flushPolicy = OutputSink::getDefaultPolicy(STDOUT_FILENO); // --flush=exit|size|line|async
+    bool batch = false; // --batch: the input file is a manifest of scripts to run in this process
+    bool interleave = false; // --interleave: run the batch as cooperative tasks on a single thread
+    size_t jobs = std::max(1u, std::thread::hardware_concurrency()); // --jobs=N: workers of the batch
+    std::string socketPath; // --serve=SOCKET: run the scripts sent by clients on a Unix domain socket
+    ExecutionLimits limits; // --max-steps=N, --max-time=MS, --max-memory=BYTES: limits of the run
+    bool profile = false; // --profile[=FILE]: report of the time of each statement (and folded stacks in FILE.folded)
+    std::string profilePath;
+    bool sample = false; // --sample[=FILE]: histogram of the lines hit by SIGPROF samples
+    std::string samplePath;
+    bool showStats = false; // --stats[=json]: time, allocations and memory of each phase, sizes of the program
+    bool statsJson = false;
+    std::string tracePath; // --trace=FILE: Chrome trace of the phases, top-level statements and loops
+    uint64_t traceLoops = 1; // --trace-loops=N: trace one execution of a while statement every N (0 for none)
+    bool count = false; // --count[=json]: deterministic cost vector (statements, expressions, lookups, allocations...)
+    bool countJson = false;
+    bool perf = false; // --perf[=statements]: hardware counters of each phase (and of each top-level statement)
+    bool perfStatements = false;
+    bool pipeline = false; // --pipeline[=stream]: lex, parse and execute concurrently (streaming: output before a later syntax error)
+    bool streaming = false;
+    size_t lexThreads = 1; // --lex-threads=N: lex the whole source in chunks on N threads before parsing
+    size_t parseThreads = 1; // --parse-threads=N: parse the top-level statements of the whole token vector on N threads
+    const char* inputPath = nullptr;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--lazy-blocks") lazyBlocks = true;
+        else if(arg == "--batch") batch = true;
+        else if(arg == "--interleave") interleave = true;
+        else if(arg == "--profile") profile = true;
+        else if(arg.rfind("--profile=", 0) == 0){
+            profile = true;
+            profilePath = arg.substr(10);
+        }
+        else if(arg == "--stats") showStats = true;
+        else if(arg == "--stats=json") showStats = statsJson = true;
+        else if(arg == "--count") count = true;
+        else if(arg == "--count=json") count = countJson = true;
+        else if(arg == "--perf") perf = true;
+        else if(arg == "--perf=statements") perf = perfStatements = true;
+        else if(arg == "--pipeline") pipeline = true;
+        else if(arg == "--pipeline=stream") pipeline = streaming = true;
+        else if(arg.rfind("--trace=", 0) == 0) tracePath = arg.substr(8);
+        else if(arg.rfind("--trace-loops=", 0) == 0) traceLoops = std::strtoull(arg.c_str() + 14, nullptr, 10);
+        else if(arg == "--sample") sample = true;
+        else if(arg.rfind("--sample=", 0) == 0){
+            sample = true;
+            samplePath = arg.substr(9);
+        }
+        else if(arg.rfind("--serve=", 0) == 0) socketPath = arg.substr(8);
+        else if(arg.rfind("--max-steps=", 0) == 0) limits.maxSteps = std::strtoull(arg.c_str() + 12, nullptr, 10);
+        else if(arg.rfind("--max-time=", 0) == 0) limits.maxMilliseconds = std::strtoull(arg.c_str() + 11, nullptr, 10);
+        else if(arg.rfind("--max-memory=", 0) == 0) limits.maxMemory = std::strtoull(arg.c_str() + 13, nullptr, 10);
+        else if(arg.rfind("--lex-threads=", 0) == 0) lexThreads = std::max(1L, std::atol(arg.c_str() + 14));
+        else if(arg.rfind("--parse-threads=", 0) == 0) parseThreads = std::max(1L, std::atol(arg.c_str() + 16));
+        else if(arg.rfind("--jobs=", 0) == 0) jobs = std::max(1L, std::atol(arg.c_str() + 7));
+        else if(arg.rfind("--cache-dir=", 0) == 0) cacheDir = arg.substr(12);
+        else if(arg.rfind("--flush=", 0) == 0){
+            if(!OutputSink::parsePolicy(arg.substr(8), flushPolicy)){
+                error(InternalError(0, 0, "Invalid flush policy: " + arg.substr(8)));
+            }
+        }
+        else if(!inputPath) inputPath = argv[i];
+    }
+
+    // Serve the clients of the socket (no input file)
+    if(!socketPath.empty()){
+        try{
+            CompileOptions options;
+            options.lazyBlocks = lazyBlocks;
+            Server server(socketPath, options, limits);
+            server();
+        } catch(const Error& e){
+            error(e);
+        }
+    }
+
     // Check for input arguments
-    if(argc < 2){
+    if(!inputPath){
         error(MissingFileError(0, 0, "No input file provided"));
     }
 
+    // Run a batch of scripts: each one gets its own output and exit status, reported in order
+    if(batch){
+        size_t failed = 0;
+        try{
+            CompileOptions options;
+            options.lazyBlocks = lazyBlocks;
+            BatchRunner runner(BatchRunner::readManifest(inputPath), jobs, options, limits, interleave);
+            failed = runner();
+        } catch(const Error& e){
+            error(e);
+        }
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // Try to open input file
     std::ifstream inputFile;
-    inputFile.open(argv[1]);
+    inputFile.open(inputPath);
     
     // Check if file is open
     if(!inputFile.is_open()){
-        error(FileOpenError(0, 0, "Could not open input file: " + std::string(argv[1])));
+        error(FileOpenError(0, 0, "Could not open input file: " + std::string(inputPath)));
     }
 
-    // Initialize the lexer
-    Lexer lexer(inputFile);
-    // Initialize the vector and run the lexer
-    std::vector<Token*> tokens;
-    try{
-        tokens = lexer();
-    } catch(const Error& e){
-        error(e);
+    // Measure the phases of the run (and trace them)
+    Stats stats;
+    std::unique_ptr<Tracer> tracer;
+    if(!tracePath.empty()){
+        tracer.reset(new Tracer(TRACE_CAPACITY, traceLoops));
+    }
+    // Open the perf counters (the run goes on without them if the host does not provide them)
+    std::unique_ptr<PerfCounters> counters;
+    if(perf){
+        counters.reset(new PerfCounters());
     }
 
-    // Close the input file
-    inputFile.close();
+    // Count the allocations of the run from here (the counts exclude the setup of the reports)
+    uint64_t startAllocations = Stats::getThreadAllocations();
+    uint64_t startAllocatedBytes = Stats::getThreadAllocatedBytes();
 
-    
-    // Initialize the parser
-    Parser parser(tokens);
-    // Initialize the syntax tree and run the parser
-    Program* program;
-    try{
-        program = parser();
-    } catch(const Error& e){
-        error(e);
+    // Look for the compiled program in the cache (the source is read, then the file is rewound for the lexer)
+    ProgramCache cache(cacheDir);
+    std::string source;
+    std::vector<Token*> cachedTokens;
+    Program* program = nullptr;
+    if(!cacheDir.empty()){
+        stats.begin("cache");
+        if(tracer) tracer->beginPhase("cache");
+        if(counters) counters->beginPhase("cache");
+        source.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+        inputFile.clear();
+        inputFile.seekg(0);
+        program = cache.load(source, cachedTokens);
+        if(tracer) tracer->endPhase();
     }
+    // The syntax tree does not refer to the tokens: they are freed before the program runs
+    size_t tokenCount = cachedTokens.size();
+    for(auto t : cachedTokens) {
+        delete t;
+    }
+    cachedTokens.clear();
+
+    // Initialize the lexer and the parser, which pulls the tokens from the lexer as it needs them
+    // (cached programs are parsed completely)
+    Lexer lexer(inputFile);
+    std::unique_ptr<Parser> parser(new Parser(lexer, lazyBlocks && cacheDir.empty()));
+    // (the tokens of the parsed statements are deleted as the parsing advances, unless the cache stores them)
+    if(!cacheDir.empty()) parser->keepTokens();
+    // The pipeline lexes and parses on its own threads while the program runs (the cache, the
+    // lazy blocks and the lexing or parsing on several threads need the whole program before it
+    // runs, so they disable it)
+    std::unique_ptr<Pipeline> stages;
+    if(pipeline && cacheDir.empty() && !lazyBlocks && lexThreads == 1 && parseThreads == 1){
+        stages.reset(new Pipeline(inputFile, STDOUT_FILENO, flushPolicy, streaming));
+        program = stages->getProgram();
+    }
+    // Initialize the syntax tree and run the parser (unless the program was found in the cache):
+    // the parse phase includes the lexing
+    if(!program){
+        stats.begin("parse");
+        if(tracer) tracer->beginPhase("parse");
+        if(counters) counters->beginPhase("parse");
+        try{
+            // Lex the whole source (on several threads) first: the parser then reads the token
+            // vector, whose top-level statements can be parsed on several threads
+            if(lexThreads > 1 || parseThreads > 1){
+                if(cacheDir.empty()) source.assign(std::istreambuf_iterator<char>(inputFile), std::istreambuf_iterator<char>());
+                parser.reset(new Parser(Lexer::tokenizeParallel(source, lexThreads), lazyBlocks && cacheDir.empty()));
+                parser->setThreads(parseThreads);
+            }
+            program = (*parser)();
+        } catch(const Error& e){
+            if(showStats) writeStats(stats, nullptr, nullptr, statsJson);
+            if(count) writeCounts(nullptr, startAllocations, startAllocatedBytes, countJson);
+            if(counters) writePerf(*counters, nullptr);
+            if(tracer) writeTrace(*tracer, tracePath);
+            error(e);
+        }
+        if(tracer) tracer->endPhase();
+        // Only successfully parsed programs reach the cache
+        if(!cacheDir.empty()){
+            stats.begin("cache");
+            if(tracer) tracer->beginPhase("cache");
+            if(counters) counters->beginPhase("cache");
+            cache.store(source, program, parser->getTokens());
+            if(tracer) tracer->endPhase();
+        }
+        // The tokens are freed before the program runs (the lazy blocks keep them to parse their bodies)
+        tokenCount = parser->getTokens().size();
+        parser->freeTokens();
+    }
+
+    // Close the input file (the pipeline reads it while the program runs)
+    if(!stages) inputFile.close();
     
-    // Initialize the visitor
-    Visitor visitor(program);
+    // Initialize the output of the print statements and the visitor
+    std::unique_ptr<OutputSink> fileOutput;
+    if(!stages) fileOutput.reset(new OutputSink(STDOUT_FILENO, flushPolicy));
+    OutputSink& output = stages ? stages->getOutput() : *fileOutput;
+    Visitor visitor(program, output);
+    visitor.setLimits(limits);
+    // Attach the profiler (its results are written after an error as well)
+    std::unique_ptr<Profiler> profiler;
+    if(profile){
+        profiler.reset(new Profiler());
+        visitor.setProfiler(profiler.get());
+    }
+    // Attach the tracer (the execution phase contains the top-level statements)
+    if(tracer){
+        visitor.setTracer(tracer.get());
+    }
+    // Attach the perf counters to read them around the top-level statements
+    if(counters && perfStatements){
+        visitor.setPerfCounters(counters.get());
+    }
+    // Start the sampler (the Visitor publishes the statement it is executing)
+    if(sample){
+        visitor.setSampleSlot(Sampler::getSlot());
+        if(!Sampler::start()){
+            error(InternalError(0, 0, "Cannot start the sampling profiler"));
+        }
+    }
     // Run the visitor
+    // (the phases of the pipeline overlap, so they are measured as one)
+    if(!stages) stats.setTokenCount(tokenCount);
+    const char* phase = stages ? "pipeline" : "execute";
+    stats.begin(phase);
+    if(tracer) tracer->beginPhase(phase);
+    if(counters) counters->beginPhase(phase);
     try{
-        visitor();
+        if(stages) (*stages)(visitor);
+        else visitor();
     } catch(const Error& e){
+        if(stages) stats.setTokenCount(stages->getTokenCount());
+        if(profiler) writeProfile(*profiler, profilePath);
+        if(sample) writeSamples(samplePath);
+        if(showStats) writeStats(stats, program, &visitor, statsJson);
+        if(count) writeCounts(&visitor, startAllocations, startAllocatedBytes, countJson);
+        if(counters) writePerf(*counters, &visitor);
+        if(tracer) writeTrace(*tracer, tracePath);
         error(e);
     }
+    output.flush();
+    if(stages) stats.setTokenCount(stages->getTokenCount());
+    if(profiler) writeProfile(*profiler, profilePath);
+    if(sample) writeSamples(samplePath);
+    if(showStats) writeStats(stats, program, &visitor, statsJson);
+    if(count) writeCounts(&visitor, startAllocations, startAllocatedBytes, countJson);
+    if(counters) writePerf(*counters, &visitor);
+    if(tracer) writeTrace(*tracer, tracePath);
 
-    // Cleanup the tokens
-    for(auto t : tokens) {
+    // Cleanup the tokens kept for the lazy blocks
+    for(auto t : stages ? stages->getTokens() : parser->getTokens()) {
         delete t;
     }
-    tokens.clear();
     
     // Clean up the syntax tree
     delete program;
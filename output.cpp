@@ -0,0 +1,268 @@
+/**
+ * @file output.cpp
+ * @brief Implements the buffered output of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the OutputSink class: formatting of the printed
+ * values, flush policies and the optional background writer thread.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "output.h"
+
+// Two-digit decimal representations of the numbers from 00 to 99
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Sinks writing to a file descriptor, flushed by flushAll() before the process exits on an error
+static std::vector<OutputSink*> sinks;
+static std::mutex sinksMutex;
+
+/**
+ * @brief Constructs a sink writing to a file descriptor
+ * @param fd The file descriptor to write to
+ * @param policy When the buffer is written to the file descriptor
+ * @param capacity The size of the buffer (bytes)
+ */
+OutputSink::OutputSink(int fd, FlushPolicy policy, size_t capacity)
+    : fd_(fd), policy_(policy), capacity_(std::max<size_t>(capacity, 64)) {
+    start();
+    std::lock_guard<std::mutex> lock(sinksMutex);
+    sinks.push_back(this);
+}
+
+/**
+ * @brief Constructs a sink passing its output to a function
+ * @param writer The function receiving the buffered bytes
+ * @param policy When the buffer is passed to the function
+ * @param capacity The size of the buffer (bytes)
+ */
+OutputSink::OutputSink(std::function<void(const char*, size_t)> writer, FlushPolicy policy, size_t capacity)
+    : fd_(-1), writeFunction_(std::move(writer)), policy_(policy), capacity_(std::max<size_t>(capacity, 64)) {
+    start();
+}
+
+/**
+ * @brief Flushes the remaining output and stops the background writer
+ */
+OutputSink::~OutputSink() {
+    if (!writeFunction_) {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        sinks.erase(std::find(sinks.begin(), sinks.end(), this));
+    }
+    flush();
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        writer_.join();
+    }
+}
+
+/**
+ * @brief Writes an integer in decimal notation
+ * @param value The integer to write
+ */
+void OutputSink::writeInt(int value) {
+    // 10 digits and the sign are enough for any 32-bit integer
+    char digits[16];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    // the magnitude is computed as unsigned, so INT_MIN does not overflow
+    unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    while (magnitude >= 100) {
+        unsigned int pair = (magnitude % 100) * 2;
+        magnitude /= 100;
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+    }
+    if (magnitude >= 10) {
+        *--p = DIGIT_PAIRS[magnitude * 2 + 1];
+        *--p = DIGIT_PAIRS[magnitude * 2];
+    } else {
+        *--p = static_cast<char>('0' + magnitude);
+    }
+    if (value < 0) *--p = '-';
+    write(p, end - p);
+}
+
+/**
+ * @brief Writes a boolean as True or False
+ * @param value The boolean to write
+ */
+void OutputSink::writeBool(bool value) {
+    if (value) write("True", 4);
+    else write("False", 5);
+}
+
+/**
+ * @brief Ends a line, flushing it if the sink is line buffered
+ */
+void OutputSink::writeNewline() {
+    write("\n", 1);
+    if (policy_ == FLUSH_ON_LINE) flush();
+}
+
+/**
+ * @brief Appends bytes to the buffer, draining it when it is full
+ * @param data The bytes to write
+ * @param size The number of bytes
+ */
+void OutputSink::write(const char* data, size_t size) {
+    reserve(size);
+    memcpy(buffer_.data() + size_, data, size);
+    size_ += size;
+}
+
+/**
+ * @brief Writes all the buffered output to the file descriptor
+ *
+ * With the background writer, waits until the writer has written everything.
+ */
+void OutputSink::flush() {
+    drain();
+    if (policy_ == FLUSH_ASYNC) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return pendingSize_ == 0; });
+    }
+}
+
+/**
+ * @brief Flushes every sink writing to a file descriptor
+ */
+void OutputSink::flushAll() {
+    std::lock_guard<std::mutex> lock(sinksMutex);
+    for (OutputSink* sink : sinks) {
+        sink->flush();
+    }
+}
+
+/**
+ * @brief Parses the name of a flush policy
+ * @param name The name of the policy (exit, size, line or async)
+ * @param policy The parsed policy
+ * @return True if the name is valid, false otherwise
+ */
+bool OutputSink::parsePolicy(const std::string& name, FlushPolicy& policy) {
+    if (name == "exit") policy = FLUSH_ON_EXIT;
+    else if (name == "size") policy = FLUSH_ON_SIZE;
+    else if (name == "line") policy = FLUSH_ON_LINE;
+    else if (name == "async") policy = FLUSH_ASYNC;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Returns the default flush policy of a file descriptor
+ * @param fd The file descriptor
+ * @return FLUSH_ON_LINE for terminals, FLUSH_ON_SIZE otherwise
+ */
+FlushPolicy OutputSink::getDefaultPolicy(int fd) {
+    return isatty(fd) ? FLUSH_ON_LINE : FLUSH_ON_SIZE;
+}
+
+/**
+ * @brief Makes room in the buffer for the given number of bytes
+ * @param size The number of bytes about to be written
+ */
+void OutputSink::reserve(size_t size) {
+    if (size_ + size <= buffer_.size()) return;
+    if (policy_ == FLUSH_ON_EXIT) {
+        // the output is kept until the end, so the buffer grows
+        buffer_.resize(std::max(buffer_.size() * 2, size_ + size));
+        return;
+    }
+    drain();
+    if (size > buffer_.size()) {
+        buffer_.resize(size);
+    }
+}
+
+/**
+ * @brief Moves the buffered output to the file descriptor (or to the background writer)
+ */
+void OutputSink::drain() {
+    if (size_ == 0) return;
+    if (policy_ != FLUSH_ASYNC) {
+        writeAll(buffer_.data(), size_);
+        size_ = 0;
+        return;
+    }
+    // wait for the writer to finish the previous buffer, then hand this one over
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pendingSize_ == 0; });
+    buffer_.swap(pending_);
+    pendingSize_ = size_;
+    size_ = 0;
+    if (buffer_.size() < pending_.size()) {
+        buffer_.resize(pending_.size());
+    }
+    lock.unlock();
+    cv_.notify_all();
+}
+
+/**
+ * @brief Writes bytes to the file descriptor, retrying partial and interrupted writes
+ * @param data The bytes to write
+ * @param size The number of bytes
+ */
+void OutputSink::writeAll(const char* data, size_t size) {
+    if (writeFunction_) {
+        writeFunction_(data, size);
+        return;
+    }
+    while (size > 0) {
+        ssize_t written = ::write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            // the output is lost, as it would be with a failed stream
+            return;
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+/**
+ * @brief Allocates the buffers and starts the background writer (FLUSH_ASYNC only)
+ */
+void OutputSink::start() {
+    buffer_.resize(capacity_);
+    if (policy_ == FLUSH_ASYNC) {
+        pending_.resize(capacity_);
+        writer_ = std::thread(&OutputSink::writerLoop, this);
+    }
+}
+
+/**
+ * @brief Body of the background writer: writes every buffer handed over by drain()
+ */
+void OutputSink::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return pendingSize_ > 0 || stop_; });
+        if (pendingSize_ == 0) return;
+        // the buffer is written without holding the lock; drain() waits for pendingSize_ == 0
+        lock.unlock();
+        writeAll(pending_.data(), pendingSize_);
+        lock.lock();
+        pendingSize_ = 0;
+        cv_.notify_all();
+    }
+}
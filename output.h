@@ -0,0 +1,98 @@
+#if !defined(OUTPUT_H)
+#define OUTPUT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @file output.h
+ * @brief Defines the buffered output of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the OutputSink class, which collects the output of the
+ * print statements in a user-space buffer and writes it to a file descriptor according to a
+ * flush policy, instead of flushing the stream after every line.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Default size of the output buffer (bytes)
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+
+/**
+ * @enum FlushPolicy
+ * @brief When the buffered output is written to the file descriptor
+ */
+enum FlushPolicy {
+    FLUSH_ON_EXIT,  // only when the sink is flushed explicitly or destroyed (the buffer grows as needed)
+    FLUSH_ON_SIZE,  // whenever the buffer is full
+    FLUSH_ON_LINE,  // after every line (default for terminals)
+    FLUSH_ASYNC     // full buffers are handed to a background writer thread
+};
+
+/**
+ * @class OutputSink
+ * @brief Buffered writer of the output of the print statements
+ *
+ * The output goes either to a file descriptor or to a function supplied by the embedding
+ * application, which receives the buffered bytes in order.
+ * Integers are formatted directly in the buffer with a table of digit pairs. The sink is not
+ * thread-safe: each one is meant to be used by a single Visitor.
+ */
+class OutputSink{
+    public:
+        // constructors
+        OutputSink() = delete;
+        OutputSink(int fd, FlushPolicy policy, size_t capacity = OUTPUT_BUFFER_SIZE);
+        OutputSink(std::function<void(const char*, size_t)> writer, FlushPolicy policy, size_t capacity = OUTPUT_BUFFER_SIZE);
+        OutputSink(OutputSink const& os) = delete;
+
+        // destructor
+        ~OutputSink();
+
+        // methods
+        void writeInt(int value);
+        void writeBool(bool value);
+        void writeNewline();
+        void write(const char* data, size_t size);
+        void flush();
+        FlushPolicy getPolicy() const { return policy_; }
+
+        // flush every sink writing to a file descriptor (used by error() before the process exits)
+        static void flushAll();
+        // parse the name of a flush policy (exit, size, line, async)
+        static bool parsePolicy(const std::string& name, FlushPolicy& policy);
+        // default policy for a file descriptor: line buffered for terminals, on size otherwise
+        static FlushPolicy getDefaultPolicy(int fd);
+
+    private:
+        // methods to move the buffer to the file descriptor
+        void reserve(size_t size);
+        void drain();
+        void writeAll(const char* data, size_t size);
+        void writerLoop();
+        void start();
+
+        int fd_;
+        std::function<void(const char*, size_t)> writeFunction_; // destination of the output instead of fd_ (if set)
+        FlushPolicy policy_;
+        size_t capacity_;
+        std::vector<char> buffer_;
+        size_t size_{0};
+
+        // background writer (FLUSH_ASYNC only): the full buffer is swapped with pending_
+        std::thread writer_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::vector<char> pending_;
+        size_t pendingSize_{0};
+        bool stop_{false};
+};
+
+
+#endif
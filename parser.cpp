@@ -11,27 +11,318 @@
 #include "parser.h"
 #include "syntax.h"
 #include "error.h"
+#include <algorithm>
+#include <climits>
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 
+/**
+ * @struct ParserChunk
+ * @brief Range of top-level statements parsed by one thread of a parallel parse
+ *
+ * A chunk owns its statements until they are joined to the program, so the statements of the
+ * chunks dropped after an error (or after a statement spanning a border) are deleted with them.
+ */
+struct ParserChunk {
+    ParserChunk(int begin, int end) : begin(begin), end(end) {}
+    ParserChunk(ParserChunk&& other) = default;
+    ParserChunk(ParserChunk const& c) = delete;
+    ~ParserChunk() {
+        for (Statement* stmt : statements) {
+            delete stmt;
+        }
+    }
+
+    int begin;                         // position of the first statement
+    int end;                           // position where the range ends
+    std::vector<Statement*> statements;
+    int stop{0};                       // position where the chunk parser stopped (end, unless a statement spans the border)
+    std::exception_ptr error;          // error that stopped the chunk parser
+    std::shared_ptr<NameTable> names;  // identifiers of the statements of the chunk
+};
+
+/**
+ * @brief Moves a block frame, emptying the other one
+ * @param other The frame moved
+ */
+BlockFrame::BlockFrame(BlockFrame&& other) noexcept :
+    statements(std::move(other.statements)), blockType(other.blockType), stmtType(other.stmtType),
+    condition(other.condition), elifCondition(other.elifCondition), blocks(std::move(other.blocks)), lazyBegin(other.lazyBegin) {
+    other.statements.clear();
+    other.condition = nullptr;
+    other.elifCondition = nullptr;
+    other.blocks.clear();
+}
+
+/**
+ * @brief Deletes the nodes still held by the frame (after a syntax error)
+ */
+BlockFrame::~BlockFrame() {
+    for (Statement* stmt : statements) {
+        delete stmt;
+    }
+    delete condition;
+    delete elifCondition;
+    for (Block* block : blocks) {
+        delete block;
+    }
+}
+
 /**
  * @brief Parses the token vector and creates the Syntax Tree
- * @param tokens The vector of pointers to Token objects to be parsed
  * @return A pointer to the root of the Syntax Tree (Program object)
  */
 Program* Parser::parseProgram(){
-    // Run through the token vector and initialize the Program object
-    std::vector<Statement*> statements = {};
+    if (!lexer_) {
+        if (threads_ > 1 && !lazyBlocks_ && !statementSink_) {
+            return new Program(parseStatementsParallel(), names_);
+        }
+        return new Program(parseStatements(tokens_.size()), names_);
+    }
+    // Streamed tokens: the program ends at the EOF token, the last one of the lexer
+    std::vector<Statement*> statements;
+    try {
+        statements = parseStatements(INT_MAX);
+    } catch (const Error&) {
+        // A lexical error after the syntax error is still the one reported, as when the whole file is lexed first
+        drainLexer();
+        throw;
+    }
+    lexer_ = nullptr;
+    return new Program(statements, names_);
+}
+
+/**
+ * @brief Parses the top-level statements of the token vector in ranges on several threads
+ *
+ * A top-level statement starts after a NEWLINE token outside of any block (unless it is an
+ * elif or an else), so the token vector is split at such positions, one after each share of
+ * the tokens, and each range is parsed by a chunk parser on its own thread.
+ * A chunk parser is in the state of the sequential parser at the start of its range only if
+ * the previous chunk parser stopped exactly there; when a statement spans the border (after
+ * unbalanced indentation tokens, for instance), the rest of the tokens is parsed again on this
+ * thread from where the previous chunk parser stopped. The error of the first chunk still in
+ * step with the sequential parser is therefore the error the sequential parser raises.
+ * @return The vector of the top-level statements
+ */
+std::vector<Statement*> Parser::parseStatementsParallel(){
+    int size = tokens_.size();
+    size_t count = std::min(threads_, tokens_.size() / PARSER_CHUNK_TOKENS);
+    if (count <= 1) {
+        return parseStatements(size);
+    }
+
+    // Split the tokens at the first top-level statement after each share
+    std::vector<ParserChunk> chunks;
+    chunks.emplace_back(index_, size);
+    int depth = 0;
+    for (int p = index_; p + 1 < size && chunks.size() < count; p++) {
+        Token* token = tokens_[p];
+        if (token->getType() == TokenType::INDENTATION_TOKEN) {
+            depth += token->getBoolValue() ? 1 : -1;
+            continue;
+        }
+        if (token->getType() != TokenType::NEWLINE_TOKEN || depth != 0 || p + 1 < (long)size * (long)chunks.size() / (long)count) {
+            continue;
+        }
+        Token* first = tokens_[p + 1];
+        if (
+            first->getType() == TokenType::INDENTATION_TOKEN ||
+            first->getType() == TokenType::EOF_TOKEN ||
+            (first->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
+             (first->getIntValue() == ReservedKeywordToken::ELIF || first->getIntValue() == ReservedKeywordToken::ELSE))
+        ) {
+            continue;
+        }
+        chunks.back().end = p + 1;
+        chunks.emplace_back(p + 1, size);
+    }
+
+    // Parse the chunks, the first one on the calling thread
+    std::vector<std::thread> workers;
+    for (size_t c = 1; c < chunks.size(); c++) {
+        workers.emplace_back(&Parser::parseChunk, this, std::ref(chunks[c]));
+    }
+    parseChunk(chunks[0]);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Join the chunks in order, as long as each one starts where the previous one stopped
+    // (the chunks still holding statements delete them when they go out of scope)
+    ParserChunk joined(index_, size);
+    for (size_t c = 0; c < chunks.size(); c++) {
+        ParserChunk& chunk = chunks[c];
+        if (chunk.error) {
+            std::rethrow_exception(chunk.error);
+        }
+        joined.statements.insert(joined.statements.end(), chunk.statements.begin(), chunk.statements.end());
+        chunk.statements.clear();
+        names_->adopt(*chunk.names);
+        if (c + 1 < chunks.size() && chunk.stop != chunks[c + 1].begin) {
+            // The statements of the following chunks are dropped
+            index_ = chunk.stop;
+            std::vector<Statement*> rest = parseStatements(size);
+            joined.statements.insert(joined.statements.end(), rest.begin(), rest.end());
+            return std::move(joined.statements);
+        }
+    }
+    index_ = chunks.back().stop;
+    return std::move(joined.statements);
+}
+
+/**
+ * @brief Parses the statements of one chunk with a chunk parser sharing the token vector
+ * @param chunk The chunk (receives its statements, or the error that stopped it)
+ */
+void Parser::parseChunk(ParserChunk& chunk){
+    Parser parser(*this, chunk.begin);
+    try {
+        chunk.statements = parser.parseStatements(chunk.end);
+    } catch (...) {
+        chunk.error = std::current_exception();
+    }
+    chunk.stop = parser.index_;
+    chunk.names = parser.names_;
+}
+
+/**
+ * @brief Pulls tokens from the lexer until a position is available or the lexer ends
+ * @param position The position of the token needed
+ */
+void Parser::pullTokens(int position){
+    while (lexer_ && position >= (int)tokens_.size()) {
+        Token* next;
+        try {
+            next = lexer_->next();
+        } catch (const Error&) {
+            // The lexer cannot go on after its error
+            lexer_ = nullptr;
+            throw;
+        }
+        if (!next) {
+            lexer_ = nullptr;
+            break;
+        }
+        tokens_.push_back(next);
+    }
+}
+
+/**
+ * @brief Pulls the remaining tokens from the lexer (raising its error, if any)
+ */
+void Parser::drainLexer(){
+    pullTokens(INT_MAX);
+}
+
+/**
+ * @brief Deletes the streamed tokens before the last one read
+ *
+ * Called between statements, when no token is referred to but the last one read (the position
+ * of the nodes closing a block, and of an error at the end of the file). The slots of the
+ * deleted tokens are set to null.
+ */
+void Parser::releaseTokens(){
+    for (; released_ < index_ - 1; released_++) {
+        delete tokens_[released_];
+        tokens_[released_] = nullptr;
+    }
+}
+
+/**
+ * @brief Deletes the tokens once the Syntax Tree is built
+ *
+ * The tree copies what it needs from the tokens, so they do not have to stay in memory while
+ * the program runs. The bodies of lazy blocks are still to be parsed from them: with lazy
+ * blocks the tokens are kept.
+ * @return Whether the tokens were deleted
+ */
+bool Parser::freeTokens(){
+    if (lazyBlocks_) {
+        return false;
+    }
+    for (Token* t : tokens_) {
+        delete t;
+    }
+    tokens_.clear();
+    tokens_.shrink_to_fit();
+    return true;
+}
+
+/**
+ * @brief Parses the body of a block whose parsing was deferred until its first execution
+ *
+ * Called by SimpleBlock::getStatements(). Lazy blocks of different threads share the
+ * parser, so the parsing is serialized.
+ * @param begin The position of the first token of the body (after the indentation)
+ * @param end The position of the dedentation closing the body
+ * @return The vector of the statements of the block
+ */
+std::vector<Statement*> Parser::parseBlockBody(int begin, int end){
+    std::lock_guard<std::mutex> lock(lazyMutex_);
+    index_ = begin;
+    return parseStatements(end);
+}
+
+/**
+ * @brief Parses the statements from the current position up to the given position
+ *
+ * Compound statements are not parsed recursively: their blocks are kept on an explicit
+ * stack of BlockFrame objects, opened at the INDENT token and closed at the matching DEDENT.
+ * @param end The position where the sequence of statements ends
+ * @return The vector of the parsed statements
+ */
+std::vector<Statement*> Parser::parseStatements(int end){
+    // The bottom frame collects the statements of the sequence
+    std::vector<BlockFrame> frames(1);
+
+    while (true) {
+        // The tokens of the complete statements are no longer needed
+        if (releaseTokens_) releaseTokens();
+        // The statements completed at the top level go to the sink, if any
+        if (statementSink_ && frames.size() == 1 && !frames[0].statements.empty()) {
+            emitStatements(frames[0]);
+        }
+        // Close the innermost block when its dedentation (or the end of the tokens) is reached
+        if (frames.size() > 1 && (!hasToken(index_) || isDedent())) {
+            closeBlock(frames);
+            continue;
+        }
+        // (a block open at the end position is parsed to its end: a chunk parser then stops after its range)
+        if ((index_ >= end && frames.size() == 1) || !hasToken(index_)) break;
+
+        // Compound statements open a new block
+        if (isKeyword(ReservedKeywordToken::IF) || isKeyword(ReservedKeywordToken::WHILE)) {
+            openCompoundStatement(frames);
+            continue;
+        }
 
-    while(index_ < tokens_.size()){
         Statement* stmt = parseStatement();
-        if(stmt) statements.push_back(stmt);
-        else if (tokens_[index_]->getType() == TokenType::EOF_TOKEN) break;
-        else index_++;
+        if (stmt) frames.back().statements.push_back(stmt);
+        else if (frames.size() == 1 && token(index_)->getType() == TokenType::EOF_TOKEN) break;
+        // if the statement is null and the token is not EOF, increment the index to avoid infinite loops
+        else if (token(index_)->getType() != TokenType::EOF_TOKEN || frames.size() > 1) index_++;
     }
 
-    Program* program = new Program(statements);
-    return program;
+    if (statementSink_) emitStatements(frames[0]);
+    return std::move(frames[0].statements);
+}
+
+/**
+ * @brief Hands the statements collected by the bottom frame to the statement sink
+ *
+ * An if statement only reaches the bottom frame once the token after its last block shows
+ * that no elif or else block follows, so every statement handed over is complete.
+ * @param frame The bottom frame (its statements now belong to the sink)
+ */
+void Parser::emitStatements(BlockFrame& frame){
+    for (Statement* stmt : frame.statements) {
+        statementSink_(stmt);
+    }
+    frame.statements.clear();
 }
 
 /**
@@ -41,38 +332,38 @@ Program* Parser::parseProgram(){
 Statement* Parser::parseStatement(){
     // Check for 'print', 'break' and 'continue' statements
     if (
-        tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() == ReservedKeywordToken::PRINT
+        token(index_)->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() == ReservedKeywordToken::PRINT
     ) {
         return parsePrintStatement();
     }
     else if (
-        tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() == ReservedKeywordToken::BREAK
+        token(index_)->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() == ReservedKeywordToken::BREAK
     ) {
         return parseBreakStatement();
     }
     else if (
-        tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() == ReservedKeywordToken::CONTINUE
+        token(index_)->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() == ReservedKeywordToken::CONTINUE
     ) {
         return parseContinueStatement();
     }
 
     // Check for ids (list append or list declaration) or else it is an assignment
-    else if (tokens_[index_]->getType() == TokenType::ID_TOKEN) {
+    else if (token(index_)->getType() == TokenType::ID_TOKEN) {
         if (
-            tokens_[index_ + 1]->getType() == TokenType::PUNCTUATION_TOKEN && 
-            tokens_[index_ + 1]->getIntValue() == PunctuationToken::PERIOD &&
-            tokens_[index_ + 2]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-            tokens_[index_ + 2]->getIntValue() == ReservedKeywordToken::APPEND
+            token(index_ + 1)->getType() == TokenType::PUNCTUATION_TOKEN && 
+            token(index_ + 1)->getIntValue() == PunctuationToken::PERIOD &&
+            token(index_ + 2)->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
+            token(index_ + 2)->getIntValue() == ReservedKeywordToken::APPEND
         ) {
             return parseListAppendStatement();
         }
         else if (
-            tokens_[index_ + 1]->getType() == TokenType::ASSIGNMENT_TOKEN &&
-            tokens_[index_ + 2]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-            tokens_[index_ + 2]->getIntValue() == ReservedKeywordToken::LIST
+            token(index_ + 1)->getType() == TokenType::ASSIGNMENT_TOKEN &&
+            token(index_ + 2)->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
+            token(index_ + 2)->getIntValue() == ReservedKeywordToken::LIST
         ) {
             return parseListDeclarationStatement();
         }
@@ -81,19 +372,7 @@ Statement* Parser::parseStatement(){
         }
     }
 
-    // Check for compound statements
-    else if (
-        tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() == ReservedKeywordToken::IF
-    ) {
-        return parseCompoundStatement();
-    }
-    else if (
-        tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN &&
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() == ReservedKeywordToken::WHILE
-    ) {
-        return parseCompoundStatement();
-    }
+    // Compound statements are opened by parseProgram, any other token is not a statement
     return nullptr;
 }
 
@@ -102,31 +381,31 @@ Statement* Parser::parseStatement(){
  * @return A pointer to the parsed AssignmentStatement object
  */
 AssignmentStatement* Parser::parseAssignmentStatement(){
-    // Calls the parsing functions for the location
-    Location* location = parseLocation();
+    // Calls the parsing functions for the location (the nodes are deleted if the statement is invalid)
+    std::unique_ptr<Location> location(parseLocation());
 
     // Check for the '=' token
-    if (tokens_[index_]->getType() != TokenType::ASSIGNMENT_TOKEN) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '=' in assignment statement" );
+    if (token(index_)->getType() != TokenType::ASSIGNMENT_TOKEN) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected '=' in assignment statement" );
     }
     // Skip the '=' token
     index_++;
 
     // Calls the parsing function for the expression
-    Expression* expr = parseExpression();
+    std::unique_ptr<Expression> expr(parseExpression());
 
     // Check for the newline token
     if (
-        tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN &&
-        tokens_[index_]->getType() != TokenType::EOF_TOKEN
+        token(index_)->getType() != TokenType::NEWLINE_TOKEN &&
+        token(index_)->getType() != TokenType::EOF_TOKEN
     ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline at the end of assignment statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline at the end of assignment statement" );
     }
     // Skip the newline token
     index_++;
 
     // Create and return the AssignmentStatement object
-    return new AssignmentStatement(location, expr, index_ - 1, tokens_);
+    return new AssignmentStatement(location.release(), expr.release(), index_ - 1, tokens_);
 }
 
 /**
@@ -135,57 +414,57 @@ AssignmentStatement* Parser::parseAssignmentStatement(){
  */
 ListDeclarationStatement* Parser::parseListDeclarationStatement(){
     // Check for the id token
-    if (tokens_[index_]->getType() != TokenType::ID_TOKEN) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected identifier in list declaration statement" );
+    if (token(index_)->getType() != TokenType::ID_TOKEN) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected identifier in list declaration statement" );
     }
 
     // Define the id token
-    IdToken* id = static_cast<IdToken*>(tokens_[index_]);
+    IdToken* id = static_cast<IdToken*>(token(index_));
     index_++;
 
     // Check for the '=' token
-    if (tokens_[index_]->getType() != TokenType::ASSIGNMENT_TOKEN) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '=' in list declaration statement" );
+    if (token(index_)->getType() != TokenType::ASSIGNMENT_TOKEN) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected '=' in list declaration statement" );
     }
     // Skip the '=' token
     index_++;
 
     // Check for the 'list' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN || 
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::LIST) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'list' in list declaration statement" );
+    if (token(index_)->getType() != TokenType::RESERVEDKEYWORD_TOKEN || 
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() != ReservedKeywordToken::LIST) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected 'list' in list declaration statement" );
     }
     // Skip the list token
     index_++;
 
     // Check for the '(' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::LPAR) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '(' in list declaration statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN || 
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::LPAR) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected '(' in list declaration statement" );
     }
     // Skip the '(' token
     index_++;
 
     // Check for the ')' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::RPAR) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ')' in list declaration statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN || 
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::RPAR) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected ')' in list declaration statement" );
     }
     // Skip the ')' token
     index_++;
 
     // Check for the newline token
     if (
-        tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN &&
-        tokens_[index_]->getType() != TokenType::EOF_TOKEN
+        token(index_)->getType() != TokenType::NEWLINE_TOKEN &&
+        token(index_)->getType() != TokenType::EOF_TOKEN
     ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline at the end of list declaration statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline at the end of list declaration statement" );
     }
     // Skip the newline token
     index_++;
 
     // Create and return the ListDeclarationStatement object
-    return new ListDeclarationStatement(id, index_ - 1, tokens_);
+    return new ListDeclarationStatement(intern(id), id->getLine(), index_ - 1, tokens_);
 }
 
 /**
@@ -194,60 +473,60 @@ ListDeclarationStatement* Parser::parseListDeclarationStatement(){
  */
 ListAppendStatement* Parser::parseListAppendStatement(){
     // Check for the id token
-    if (tokens_[index_]->getType() != TokenType::ID_TOKEN) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected identifier in list append statement" );
+    if (token(index_)->getType() != TokenType::ID_TOKEN) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected identifier in list append statement" );
     }
     // Define the id token
-    IdToken* id = static_cast<IdToken*>(tokens_[index_]);
+    IdToken* id = static_cast<IdToken*>(token(index_));
     index_++;
 
 
     // Check for the '.' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN ||
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::PERIOD) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '.' in list append statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN ||
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::PERIOD) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected '.' in list append statement" );
     }
     // Skip the period token
     index_++;
 
     // Check for the 'append' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::APPEND) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'append' in list append statement" );
+    if (token(index_)->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() != ReservedKeywordToken::APPEND) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected 'append' in list append statement" );
     }
     // Skip the append token
     index_++;
 
     // Check for the '(' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::LPAR) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '(' in list append statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN || 
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::LPAR) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected '(' in list append statement" );
     }
     // Skip the '(' token
     index_++;
 
-    // Calls the parsing function for the expression
-    Expression* expr = parseExpression();
+    // Calls the parsing function for the expression (deleted if the statement is invalid)
+    std::unique_ptr<Expression> expr(parseExpression());
 
     // Check for the ')' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::RPAR) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ')' in list append statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN || 
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::RPAR) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected ')' in list append statement" );
     }
     // Skip the ')' token
     index_++;
 
     // Check for the newline token
-    if (tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN &&
-        tokens_[index_]->getType() != TokenType::EOF_TOKEN
+    if (token(index_)->getType() != TokenType::NEWLINE_TOKEN &&
+        token(index_)->getType() != TokenType::EOF_TOKEN
     ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline at the end of list append statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline at the end of list append statement" );
     }
     // Skip the newline token
     index_++;
 
     // Create and return the ListAppendStatement object
-    return new ListAppendStatement(id, expr, index_ - 1, tokens_);
+    return new ListAppendStatement(intern(id), id->getLine(), expr.release(), index_ - 1, tokens_);
 }
 
 /**
@@ -256,19 +535,19 @@ ListAppendStatement* Parser::parseListAppendStatement(){
  */
 BreakStatement* Parser::parseBreakStatement(){
     // Check for the 'break' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::BREAK) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'break' in break statement" );
+    if (token(index_)->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() != ReservedKeywordToken::BREAK) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected 'break' in break statement" );
     }
     // Skip the 'break' token
     index_++;
 
     // Check for the newline token
     if (
-        tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN &&
-        tokens_[index_]->getType() != TokenType::EOF_TOKEN
+        token(index_)->getType() != TokenType::NEWLINE_TOKEN &&
+        token(index_)->getType() != TokenType::EOF_TOKEN
     ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline at the end of break statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline at the end of break statement" );
     }
     // Skip the newline token
     index_++;
@@ -283,19 +562,19 @@ BreakStatement* Parser::parseBreakStatement(){
  */
 ContinueStatement* Parser::parseContinueStatement(){
     // Check for the 'continue' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::CONTINUE) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'continue' in continue statement" );
+    if (token(index_)->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() != ReservedKeywordToken::CONTINUE) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected 'continue' in continue statement" );
     }
     // Skip the 'continue' token
     index_++;
 
     // Check for the newline token
     if (
-        tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN &&
-        tokens_[index_]->getType() != TokenType::EOF_TOKEN
+        token(index_)->getType() != TokenType::NEWLINE_TOKEN &&
+        token(index_)->getType() != TokenType::EOF_TOKEN
     ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline at the end of continue statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline at the end of continue statement" );
     }
     // Skip the newline token
     index_++;
@@ -310,886 +589,384 @@ ContinueStatement* Parser::parseContinueStatement(){
  */
 PrintStatement* Parser::parsePrintStatement(){
     // Check for the 'print' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::PRINT) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'print' in print statement" );
+    if (token(index_)->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
+        static_cast<ReservedKeywordToken*>(token(index_))->getIntValue() != ReservedKeywordToken::PRINT) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected 'print' in print statement" );
     }
     // Skip the 'print' token
     index_++;
 
     // Check for the '(' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::LPAR) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '(' in print statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN || 
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::LPAR) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected '(' in print statement" );
     }
     // Skip the '(' token
     index_++;
 
-    // Calls the parsing function for the expression
-    Expression* expr = parseExpression();
+    // Calls the parsing function for the expression (deleted if the statement is invalid)
+    std::unique_ptr<Expression> expr(parseExpression());
 
     // Check for the ')' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::RPAR) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ')' in print statement" );
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN || 
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::RPAR) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected ')' in print statement" );
     }
     // Skip the ')' token
     index_++;
 
     // Check for the newline token
     if (
-        tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN &&
-        tokens_[index_]->getType() != TokenType::EOF_TOKEN
+        token(index_)->getType() != TokenType::NEWLINE_TOKEN &&
+        token(index_)->getType() != TokenType::EOF_TOKEN
     ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline at the end of print statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline at the end of print statement" );
     }
     // Skip the newline token
     index_++;
 
     // Create and return the PrintStatement object
-    return new PrintStatement(expr, index_ - 1, tokens_);
+    return new PrintStatement(expr.release(), index_ - 1, tokens_);
 }
 
 /**
- * @brief Parses a compound statement from the token vector
- * @return A pointer to the parsed CompoundStatement object
+ * @brief Parses the header of a compound statement ('if' or 'while', condition and ':') and opens its block
+ * @param frames The stack of open blocks
  */
-CompoundStatement* Parser::parseCompoundStatement(){
+void Parser::openCompoundStatement(std::vector<BlockFrame>& frames){
     // Compound statements can be 'if' or 'while'
-    StatementType StatementType;
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN || 
-        (
-            tokens_[index_]->getIntValue() != ReservedKeywordToken::IF && 
-            tokens_[index_]->getIntValue() != ReservedKeywordToken::WHILE
-        )
-    ) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'if' or 'while' in compound statement" );
-    }
-    if (tokens_[index_]->getIntValue() == ReservedKeywordToken::IF) StatementType = StatementType::IF_STMT;
-    else if (tokens_[index_]->getIntValue() == ReservedKeywordToken::WHILE) StatementType = StatementType::WHILE_STMT;
+    BlockFrame frame;
+    if (isKeyword(ReservedKeywordToken::IF)) frame.stmtType = StatementType::IF_STMT;
+    else if (isKeyword(ReservedKeywordToken::WHILE)) frame.stmtType = StatementType::WHILE_STMT;
     else {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'if' or 'while' in compound statement" );
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected 'if' or 'while' in compound statement" );
     }
 
     // Increment the index to skip the 'if' or 'while' token
     index_++;
 
     // Calls the parsing function for the expression
-    Expression* expr = parseExpression();
+    frame.condition = parseExpression();
 
     // Check for the ':' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::COL) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ':' in compound statement" );
+    if (!isPunctuation(PunctuationToken::COL)) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected ':' in compound statement" );
     }
     // Skip the ':' token
     index_++;
 
-    // Initialize the vector of blocks
-    std::vector<Block*> blocks;
-
-    // Calls the parsing function for the block
-    Block* block = parseBlock();
-    if (block) blocks.push_back(block);
-    else {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected block in compound statement" );
-    }
-
-    // In case of 'if' statements, check for 'elif' and 'else' blocks
-    if (StatementType == StatementType::IF_STMT) {
-        // Check for 'elif' blocks
-        while (tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN && 
-               tokens_[index_]->getIntValue() == ReservedKeywordToken::ELIF) {
-            ElifBlock* elifBlock = parseElifBlock();
-            if (elifBlock) blocks.push_back(elifBlock);
-            else {
-                throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected elif block in compound statement" );
-            }
-        }
-
-        // Check for 'else' block
-        if (tokens_[index_]->getType() == TokenType::RESERVEDKEYWORD_TOKEN && 
-            tokens_[index_]->getIntValue() == ReservedKeywordToken::ELSE) {
-            ElseBlock* elseBlock = parseElseBlock();
-            if (elseBlock) blocks.push_back(elseBlock);
-            else {
-                throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected else block in compound statement" );
-            }
-        }
-    }
-
-    // Create and return the CompoundStatement object
-    return new CompoundStatement(StatementType, expr, blocks, index_ - 1, tokens_);
+    // Open the block of the compound statement
+    openBlock(frames, std::move(frame));
 }
 
 /**
- * @brief Parses a block from the token vector
- * @return A pointer to the parsed Block object
+ * @brief Parses the beginning of a block (newline and indentation) and pushes its frame
+ * @param frames The stack of open blocks
+ * @param frame The frame of the block, carrying the compound statement parsed so far
  */
-Block* Parser::parseBlock(){
+void Parser::openBlock(std::vector<BlockFrame>& frames, BlockFrame frame){
     // Check for the newline token
-    if (tokens_[index_]->getType() != TokenType::NEWLINE_TOKEN) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected newline in block" );
+    if (token(index_)->getType() != TokenType::NEWLINE_TOKEN) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected newline in block" );
     }
     // Skip the newline token
     index_++;
 
     // Check for the indentation token
-    if (tokens_[index_]->getType() != TokenType::INDENTATION_TOKEN ||
-        !static_cast<IndentationToken*>(tokens_[index_])->getBoolValue()) {
-        throw IndentationError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected indentation in block" );
+    if (token(index_)->getType() != TokenType::INDENTATION_TOKEN ||
+        !static_cast<IndentationToken*>(token(index_))->getBoolValue()) {
+        throw IndentationError( token(index_)->getLine(), token(index_)->getColumn(), "Expected indentation in block" );
     }
     // Skip the indentation token
     index_++;
 
-    // Initialize the vector of statements
-    std::vector<Statement*> statements;
-
-    // Parse statements until the DEDENT token is found
-    while (
-        index_ < tokens_.size() &&
-        (
-            tokens_[index_]->getType() != TokenType::INDENTATION_TOKEN ||
-            static_cast<IndentationToken*>(tokens_[index_])->getBoolValue() == true
-        )
-    ) {
-        Statement* stmt = parseStatement();
-        if (stmt) statements.push_back(stmt);
-        // if the statement is null and the token is not EOF, increment the index to avoid infinite loops
-        else if (tokens_[index_]->getType() != TokenType::EOF_TOKEN) index_++;
-    }
-
-    // Check for the dedentation token
-    if (tokens_[index_]->getType() != TokenType::INDENTATION_TOKEN ||
-        static_cast<IndentationToken*>(tokens_[index_])->getBoolValue()) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected dedentation in block" );
-    }
-    // Skip the dedentation token
-    index_++;
-
-    // Create and return the Block object
-    return new SimpleBlock(statements, index_ - 1, tokens_);
-}
-
-/**
- * @brief Parses an elif block from the token vector
- * @return A pointer to the parsed ElifBlock object
- */
-ElifBlock* Parser::parseElifBlock(){
-    // Check for the 'elif' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::ELIF) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'elif' in elif block" );
-    }
-    // Skip the 'elif' token
-    index_++;
-
-    // Calls the parsing function for the expression
-    Expression* expr = parseExpression();
-
-    // Check for the ':' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::COL) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ':' in elif block" );
-    }
-    // skip the ':' token
-    index_++;
-
-    // Calls the parsing function for the block
-    Block* block = parseBlock();
-    if (!block) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected block in elif block" );
-    }
-
-    // Create and return the ElifBlock object
-    return new ElifBlock(expr, block, index_ - 1, tokens_);
-}
-
-/**
- * @brief Parses an else block from the token vector
- * @return A pointer to the parsed ElseBlock object
- */
-ElseBlock* Parser::parseElseBlock(){
-    // Check for the 'else' token
-    if (tokens_[index_]->getType() != TokenType::RESERVEDKEYWORD_TOKEN ||
-        static_cast<ReservedKeywordToken*>(tokens_[index_])->getIntValue() != ReservedKeywordToken::ELSE) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'else' in else block" );
-    }
-    // Skip the 'else' token
-    index_++;
-
-    // Check for the ':' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN || 
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::COL) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ':' in else block" );
-    }
-    // Skip the ':' token
-    index_++;
-
-    // Calls the parsing function for the block
-    Block* block = parseBlock();
-    if (!block) {
-        throw SyntaxError( tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected block in else block" );
-    }
-
-    // Create and return the ElseBlock object
-    return new ElseBlock(block, index_ - 1, tokens_);
-}
-
-/**
- * @brief Parses an expression from the token vector
- * @return A pointer to the parsed Expression object
- */
-Expression* Parser::parseExpression(){
-    // Calls the Join parsing function (try and catch TypeError or other errors)
-    Join* join = nullptr;
-    try {
-        join = parseJoin();
-        if (!join) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-    
-    // Check for 'or' expressions
-    if (
-        tokens_[index_]->getType() == TokenType::BOOLOP_TOKEN &&
-        static_cast<BoolOpToken*>(tokens_[index_])->getIntValue() == BoolOpToken::OR
-    ) {
-        // Calls the OrExpr parsing function (try and catch TypeError or other errors)
-        OrExpr* orExpr = nullptr;
-        try{
-            orExpr = parseOrExpr(join);
-            if (!orExpr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'or' expression");
-        } catch (const TypeError& e) {
-            error(e);
+    // In lazy mode only the range of the body is recorded: skip to the matching dedentation
+    if (lazyBlocks_) {
+        frame.lazyBegin = index_;
+        int depth = 1;
+        for (; hasToken(index_); index_++) {
+            if (token(index_)->getType() != TokenType::INDENTATION_TOKEN) continue;
+            if (token(index_)->getBoolValue()) depth++;
+            else if (--depth == 0) break;
         }
-
-        // if an OrExpr was found, return it
-        return orExpr;
-    }
-    else {
-        // if no OrExpr was found, return the Join
-        return join;
-    }
-}
-
-/**
- * @brief Parses an OrExpr from the token vector
- * @return A pointer to the parsed OrExpr object
- */
-OrExpr* Parser::parseOrExpr(Join* left){
-    // Check for the 'or' token
-    if (
-        tokens_[index_]->getType() != TokenType::BOOLOP_TOKEN ||
-        static_cast<BoolOpToken*>(tokens_[index_])->getIntValue() != BoolOpToken::OR
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'or' in or expression");
-    }
-    // Skip the 'or' token
-    index_++;
-
-    // Calls the parsing function for the right Expression
-    Expression* right = nullptr;
-    try {
-        right = parseExpression();
-        if (!right) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after 'or'");
-    } catch (const TypeError e) {
-        error(e);
-    }
-
-    // Create and return the OrExpr object
-    return new OrExpr(left, right, index_ - 1, tokens_);
-}
-
-/**
- * @brief Parses a Join from the token vector
- * @return A pointer to the parsed Join object
- */
-Join* Parser::parseJoin(){
-    // Calls the parsing function for the Equality
-    Equality* equality = nullptr;
-    try {
-        equality = parseEquality();
-        if (!equality) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Check for 'and' expressions
-    if (
-        tokens_[index_]->getType() == TokenType::BOOLOP_TOKEN &&
-        static_cast<BoolOpToken*>(tokens_[index_])->getIntValue() == BoolOpToken::AND
-    ) {
-        AndExpr* andExpr = nullptr;
-        try {
-            andExpr = parseAndExpr(equality);
-            if (!andExpr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'and' expression");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-        // if an AndExpr was found, return it
-        return andExpr;
-    }
-    else {
-        // if no AndExpr was found, return the Equality
-        return equality;
-    }
-}
-
-/**
- * @brief Parses an AndExpr from the token vector
- * @return A pointer to the parsed AndExpr object
- */
-AndExpr* Parser::parseAndExpr(Equality* left){
-    // Increment the index to skip the left expression
-    index_++;
-
-    // Check for the 'and' token
-    if (
-        tokens_[index_]->getType() == TokenType::BOOLOP_TOKEN &&
-        static_cast<BoolOpToken*>(tokens_[index_])->getIntValue() == BoolOpToken::AND
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'and' in and expression");
-    }
-    // skip the 'and' token
-    // index_++;
-
-    // Calls the parsing function for the right Expression
-    Equality* right = nullptr;
-    try {
-        right = parseEquality();
-        if (!right) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after 'and'");
-    } catch (const TypeError& e) {
-        error(e);
     }
 
-    // Create and return the AndExpr object
-    return new AndExpr(left, right, index_ - 1, tokens_);
+    frames.push_back(std::move(frame));
 }
 
 /**
- * @brief Parses an Equality from the token vector
- * @return A pointer to the parsed Equality object
+ * @brief Closes the innermost block at its dedentation
+ *
+ * The block is attached to its compound statement. An 'if' statement then continues with
+ * its 'elif' and 'else' blocks; otherwise the compound statement is complete and is added
+ * to the enclosing block.
+ * @param frames The stack of open blocks
  */
-Equality* Parser::parseEquality(){
-    // Calls the parsing function for the Relation
-    Relation* relation = nullptr;
-    try {
-        relation = parseRelation();
-        if (!relation) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Check for '==' or '!=' expressions
-    if (
-        tokens_[index_]->getType() == TokenType::RELATIONAL_TOKEN &&
-        (
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() == RelationalToken::EQ ||
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() == RelationalToken::NEQ
-        )
-    ) {
-        EqualExpr* equalExpr = nullptr;
-        try {
-            equalExpr = parseEqualExpr(relation);
-            if (!equalExpr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '==' or '!=' expression");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-
-        // if an EqualExpr was found, return it
-        return equalExpr;
-    }
-    else {
-        // if no EqualExpr was found, return the Relation
-        return relation;
+void Parser::closeBlock(std::vector<BlockFrame>& frames){
+    // Check for the dedentation token
+    if (!hasToken(index_)) {
+        throw SyntaxError( tokens_.back()->getLine(), tokens_.back()->getColumn(), "Expected dedentation in block" );
     }
-}
-
-/**
- * @brief Parses an EqualExpr from the token vector
- * @return A pointer to the parsed EqualExpr object
- */
-EqualExpr* Parser::parseEqualExpr(Relation* left){
-    // Check for the '==' or '!=' token
-    if (
-        tokens_[index_]->getType() != TokenType::RELATIONAL_TOKEN ||
-        (
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() != RelationalToken::EQ &&
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() != RelationalToken::NEQ
-        )
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '==' or '!=' in equality expression");
+    if (!isDedent()) {
+        throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected dedentation in block" );
     }
-    // Define the equality token
-    RelationalToken* eqToken = static_cast<RelationalToken*>(tokens_[index_]);
+    // Skip the dedentation token
     index_++;
 
-    // Calls the parsing function for the right Expression
-    Relation* right = nullptr;
-    try {
-        right = parseRelation();
-        if (!right) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after '==' or '!='");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Create and return the EqualExpr object
-    return new EqualExpr(left, eqToken, right, index_ - 1, tokens_);
-}
+    BlockFrame frame = std::move(frames.back());
+    frames.pop_back();
 
-/**
- * @brief Parses a Relation from the token vector
- * @return A pointer to the parsed Relation object
- */
-Relation* Parser::parseRelation(){
-    // Calls the parsing function for the NumExpr
-    NumExpr* numExpr = nullptr;
-    try {
-        numExpr = parseNumExpr();
-        if (!numExpr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Check for comparative relations
-    if (
-        tokens_[index_]->getType() == TokenType::RELATIONAL_TOKEN &&
-        (
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() == RelationalToken::LE ||
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() == RelationalToken::GT ||
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() == RelationalToken::GE ||
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() == RelationalToken::LT
-        )
-    ) {
-        ComparativeRelation* compRel = nullptr;
-        try {
-            compRel = parseComparativeRelation(numExpr);
-            if (!compRel) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected comparative relation");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-        return compRel;
+    // Attach the block to its compound statement
+    Block* block;
+    if (frame.lazyBegin >= 0) {
+        block = new SimpleBlock(this, frame.lazyBegin, index_ - 1, index_ - 1, tokens_);
+        frame.lazyBegin = -1;
     }
     else {
-        // if no ComparativeRelation was found, return the NumExpr
-        return numExpr;
+        block = new SimpleBlock(frame.statements, index_ - 1, tokens_);
     }
-}
-
-/**
- * @brief Parses a ComparativeRelation from the token vector
- * @return A pointer to the parsed ComparativeRelation object
- */
-ComparativeRelation* Parser::parseComparativeRelation(NumExpr* left){
-    // Check for the '<', '<=', '>', '>=' token
-    if (
-        tokens_[index_]->getType() != TokenType::RELATIONAL_TOKEN ||
-        (
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() != RelationalToken::LT &&
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() != RelationalToken::LE &&
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() != RelationalToken::GT &&
-            static_cast<RelationalToken*>(tokens_[index_])->getIntValue() != RelationalToken::GE
-        )
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '<', '<=', '>', '>=' in comparative relation");
+    frame.statements.clear();
+    if (frame.blockType == BlockType::ELIF_BLOCK) {
+        frame.blocks.push_back(new ElifBlock(frame.elifCondition, block, index_ - 1, tokens_));
+        frame.elifCondition = nullptr;
     }
-    // Define the comparative token
-    RelationalToken* compToken = static_cast<RelationalToken*>(tokens_[index_]);
-    index_++;
-
-    // Calls the parsing function for the right Expression
-    NumExpr* right = nullptr;
-    try {
-        right = parseNumExpr();
-        if (!right) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after '<', '<=', '>', '>='");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Create and return the ComparativeRelation object
-    return new ComparativeRelation(left, compToken, right, index_ - 1, tokens_);
-}
-
-/**
- * @brief Parses a NumExpr from the token vector
- * @return A pointer to the parsed NumExpr object
- */
-NumExpr* Parser::parseNumExpr(){
-    // Calls the parsing function for the Term
-    Term* term = nullptr;
-    try {
-        term = parseTerm();
-        if (!term) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Check for '+' or '-' expressions
-    if (
-        tokens_[index_]->getType() == TokenType::ARITHMETIC_TOKEN &&
-        (
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() == ArithmeticToken::ADD || 
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() == ArithmeticToken::SUB
-        )
-    ) {
-        AritExpr* aritExpr = nullptr;
-        try {
-            aritExpr = parseAritExpr(term);
-            if (!aritExpr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '+' or '-' expression");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-
-        // if an AritExpr was found, return it
-        return aritExpr;
+    else if (frame.blockType == BlockType::ELSE_BLOCK) {
+        frame.blocks.push_back(new ElseBlock(block, index_ - 1, tokens_));
     }
     else {
-        // if no AritExpr was found, return the Term
-        return term;
+        frame.blocks.push_back(block);
     }
-}
 
-/**
- * @brief Parses an AritExpr from the token vector
- * @return A pointer to the parsed AritExpr object
- */
-AritExpr* Parser::parseAritExpr(Term* left){
-    // Check for the '+' or '-' token
-    if (tokens_[index_]->getType() != TokenType::ARITHMETIC_TOKEN ||
-        (
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() != ArithmeticToken::ADD &&
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() != ArithmeticToken::SUB
-        )
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '+' or '-' in arithmetic expression");
-    }
-    // Define the arithmetic token
-    ArithmeticToken* aritToken = static_cast<ArithmeticToken*>(tokens_[index_]);
-    index_++;
-    
-    // Calls the parsing function for the right Expression
-    Term* right = nullptr;
-    try {
-        right = parseTerm();
-        if (!right) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after '+' or '-'");
-    } catch (const TypeError& e) {
-        error(e);
-    }
+    // In case of 'if' statements, check for 'elif' and 'else' blocks
+    if (frame.stmtType == StatementType::IF_STMT && frame.blockType != BlockType::ELSE_BLOCK) {
+        if (isKeyword(ReservedKeywordToken::ELIF)) {
+            // Skip the 'elif' token
+            index_++;
 
-    // Create and return the AritExpr object
-    return new AritExpr(left, aritToken, right, index_ - 1, tokens_);
-}
+            // Calls the parsing function for the expression
+            frame.elifCondition = parseExpression();
 
-/**
- * @brief Parses a Term from the token vector
- * @return A pointer to the parsed Term object
- */
-Term* Parser::parseTerm(){
-    // Calls the parsing function for the Unary
-    Unary* unary = nullptr;
-    try {
-        unary = parseUnary();
-        if (!unary) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression");
-    } catch (const TypeError& e) {
-        error(e);
-    }
+            // Check for the ':' token
+            if (!isPunctuation(PunctuationToken::COL)) {
+                throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected ':' in elif block" );
+            }
+            // skip the ':' token
+            index_++;
 
-    // Check for '*' or '//' expressions
-    if (
-        tokens_[index_]->getType() == TokenType::ARITHMETIC_TOKEN && 
-        (
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() == ArithmeticToken::MUL ||
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() == ArithmeticToken::DIV
-        )
-    ) {
-        MulDivTerm* mulDivTerm = nullptr;
-        try {
-            mulDivTerm = parseMulDivTerm(unary);
-            if (!mulDivTerm) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '*' or '/' expression");
-        } catch (const TypeError& e) {
-            error(e);
+            frame.blockType = BlockType::ELIF_BLOCK;
+            openBlock(frames, std::move(frame));
+            return;
         }
+        else if (isKeyword(ReservedKeywordToken::ELSE)) {
+            // Skip the 'else' token
+            index_++;
 
-        // if a MulDivTerm was found, return it
-        return mulDivTerm;
-    }
-    else {
-        // if no MulDivTerm was found, return the Unary
-        return unary;
-    }
-}
-
-/**
- * @brief Parses a MulDivTerm from the token vector
- * @return A pointer to the parsed MulDivTerm object
- */
-MulDivTerm* Parser::parseMulDivTerm(Unary* left){
-    // Check for the '*' or '//' token
-    if (tokens_[index_]->getType() != TokenType::ARITHMETIC_TOKEN ||
-        (
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() != ArithmeticToken::MUL &&
-            static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() != ArithmeticToken::DIV
-        )
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '*' or '/' in multiplication/division expression");
-    }
-    // Define the multiplication/division token
-    ArithmeticToken* mulDivToken = static_cast<ArithmeticToken*>(tokens_[index_]);
-    index_++;
-    
-    // Calls the parsing function for the right Expression
-    Term* right = nullptr;
-    try {
-        right = parseTerm();
-        if (!right) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after '*' or '/'");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Create and return the MulDivTerm object
-    return new MulDivTerm(left, mulDivToken, right, index_ - 1, tokens_);
-}
+            // Check for the ':' token
+            if (!isPunctuation(PunctuationToken::COL)) {
+                throw SyntaxError( token(index_)->getLine(), token(index_)->getColumn(), "Expected ':' in else block" );
+            }
+            // Skip the ':' token
+            index_++;
 
-/**     
- * @brief Parses a Unary from the token vector
- * @return A pointer to the parsed Unary object
- */
-Unary* Parser::parseUnary(){
-    // Check for NOT or '-' unary operators
-    if (
-        tokens_[index_]->getType() == TokenType::BOOLOP_TOKEN &&
-        static_cast<BoolOpToken*>(tokens_[index_])->getIntValue() == BoolOpToken::NOT
-    ) {
-        NotUnary* notUnary = nullptr;
-        try{
-            notUnary = parseNotUnary();
-            if (!notUnary) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'not' unary expression");
-        } catch (const TypeError& e) {
-            error(e);
+            frame.blockType = BlockType::ELSE_BLOCK;
+            openBlock(frames, std::move(frame));
+            return;
         }
-
-        // if a NotUnary was found, return it
-        return notUnary;
     }
-    else if (
-        tokens_[index_]->getType() == TokenType::ARITHMETIC_TOKEN &&
-        static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() == ArithmeticToken::SUB
-    ) {
-        MinusUnary* minusUnary = nullptr;
-        try{
-            minusUnary = parseMinusUnary();
-            if (!minusUnary) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '-' unary expression");
-        } catch (const TypeError& e) {
-            error(e);
-        }
 
-        // if a MinusUnary was found, return it
-        return minusUnary;
-    }
-    else {
-        // If no unary operator was found, parse a Factor
-        Factor* factor = nullptr;
-        try {
-            factor = parseFactor();
-            if (!factor) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected factor");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-        return factor;
-    }
+    // Create the CompoundStatement object and add it to the enclosing block
+    frames.back().statements.push_back(new CompoundStatement(frame.stmtType, frame.condition, frame.blocks, index_ - 1, tokens_));
+    frame.condition = nullptr;
+    frame.blocks.clear();
 }
 
 /**
- * @brief Parses a NotUnary from the token vector
- * @return A pointer to the parsed NotUnary object
+ * @brief Parses an expression from the token vector
+ *
+ * Precedence climbing on an explicit stack of ExpressionFrame objects. Operators of the same
+ * precedence are folded to the left, so 'a - b - c' means '(a - b) - c', and such chains
+ * become a single Nary node. Equality and relational operators are non-associative:
+ * 'a < b < c' is rejected like the previous grammar did, leaving the second operator to the caller.
+ * @return A pointer to the parsed Expression object
  */
-NotUnary* Parser::parseNotUnary(){
-    // Check for the 'not' token
-    if (
-        tokens_[index_]->getType() != TokenType::BOOLOP_TOKEN ||
-        static_cast<BoolOpToken*>(tokens_[index_])->getIntValue() != BoolOpToken::NOT
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected 'not' in not unary expression");
-    }
-    // Skip the 'not' token
-    index_++;
-    
-    // Calls the parsing function for the right Expression
-    Unary* expr = nullptr;
-    try {
-        expr = parseUnary();
-        if (!expr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after 'not'");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Create and return the NotUnary object
-    return new NotUnary(expr, index_ - 1, tokens_);
-}
+Expression* Parser::parseExpression(){
+    std::vector<ExpressionFrame> frames;
+    frames.push_back(ExpressionFrame{Precedence::OR_PRECEDENCE, FrameCloser::CLOSE_EXPRESSION});
 
-/**
- * @brief Parses a MinusUnary from the token vector
- * @return A pointer to the parsed MinusUnary object
- */
-MinusUnary* Parser::parseMinusUnary(){
-    // Check for the '-' token
-    if (
-        tokens_[index_]->getType() != TokenType::ARITHMETIC_TOKEN ||
-        static_cast<ArithmeticToken*>(tokens_[index_])->getIntValue() != ArithmeticToken::SUB
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '-' in minus unary expression");
-    }
-    // Skip the '-' token
-    index_++;
+    // Operand completed by a closed frame, waiting to be delivered to the frame below it
+    Expression* operand = nullptr;
 
-    // Calls the parsing function for the right Expression
-    Unary* expr = nullptr;
+    // The nodes of the frames and the pending operand are deleted after a syntax error
     try {
-        expr = parseUnary();
-        if (!expr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression after '-'");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Create and return the MinusUnary object
-    return new MinusUnary(expr, index_ - 1, tokens_);
-}
+        while (true) {
+            if (!operand) {
+                ExpressionFrame& frame = frames.back();
+
+                // Collect the 'not' and '-' unary operators in front of the operand
+                while (true) {
+                    if (
+                        token(index_)->getType() == TokenType::BOOLOP_TOKEN &&
+                        token(index_)->getIntValue() == BoolOpToken::NOT
+                    ) frame.prefixes.push_back(UnaryOperator::NOT_OP);
+                    else if (
+                        token(index_)->getType() == TokenType::ARITHMETIC_TOKEN &&
+                        token(index_)->getIntValue() == ArithmeticToken::SUB
+                    ) frame.prefixes.push_back(UnaryOperator::MINUS_OP);
+                    else break;
+                    index_++;
+                }
+
+                // Parenthesized expressions open a new frame (parentheses only group, they create no node)
+                if (isPunctuation(PunctuationToken::LPAR)) {
+                    index_++;
+                    frames.push_back(ExpressionFrame{Precedence::OR_PRECEDENCE, FrameCloser::CLOSE_PARENTHESIS});
+                    continue;
+                }
+                // Integer and boolean literals
+                else if (
+                    token(index_)->getType() == TokenType::NUMBER_TOKEN ||
+                    token(index_)->getType() == TokenType::BOOL_TOKEN
+                ) {
+                    operand = parseLiteral();
+                }
+                // Locations: list indexes open a new frame
+                else if (token(index_)->getType() == TokenType::ID_TOKEN) {
+                    IdToken* idToken = static_cast<IdToken*>(token(index_));
+                    index_++;
+                    if (isPunctuation(PunctuationToken::LBRACK)) {
+                        index_++;
+                        ExpressionFrame indexFrame{Precedence::OR_PRECEDENCE, FrameCloser::CLOSE_BRACKET};
+                        indexFrame.listId = intern(idToken);
+                        frames.push_back(std::move(indexFrame));
+                        continue;
+                    }
+                    operand = new IdLocation(intern(idToken), index_ - 1, tokens_);
+                }
+                // If no operand was found, raise an error
+                else {
+                    throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected factor");
+                }
+            }
 
-/**
- * @brief Parses a Factor from the token vector
- * @return A pointer to the parsed Factor object
- */
-Factor* Parser::parseFactor(){
-    // A Factor can be an ExpressionFactor, NumberFactor, BoolFactor or Location
-    // Check for ExpressionFactor
-    if (
-        tokens_[index_]->getType() == TokenType::PUNCTUATION_TOKEN &&
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() == PunctuationToken::LPAR
-    ) {
-        ExpressionFactor* exprFactor = nullptr;
-        try {
-            exprFactor = parseExpressionFactor();
-            if (!exprFactor) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression factor");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-        return exprFactor;
-    }
+            // Deliver the operand to the top frame, applying its unary operators innermost first
+            ExpressionFrame& frame = frames.back();
+            for (auto prefix = frame.prefixes.rbegin(); prefix != frame.prefixes.rend(); ++prefix) {
+                operand = new Unary(*prefix, operand, index_ - 1, tokens_);
+            }
+            frame.prefixes.clear();
+            frame.operands.push_back(operand);
+            operand = nullptr;
+
+            // Check whether the frame continues with a binary operator
+            int precedence = getPrecedence(token(index_));
+            bool accepted = (
+                precedence != Precedence::NO_PRECEDENCE &&
+                precedence >= frame.minPrecedence &&
+                // A tighter operator can only follow if the right operand stopped at a non-associative operator
+                precedence <= frame.lastPrecedence &&
+                !(
+                    precedence == frame.lastPrecedence &&
+                    (precedence == Precedence::EQUALITY_PRECEDENCE || precedence == Precedence::RELATION_PRECEDENCE)
+                )
+            );
+
+            if (accepted) {
+                // A looser operator closes the current chain, which becomes its left operand
+                if (precedence < frame.lastPrecedence && !frame.operators.empty()) {
+                    Expression* chain = buildChain(frame.operands, frame.operators);
+                    frame.operands = { chain };
+                    frame.operators.clear();
+                }
+
+                // Define the operator and skip its token
+                frame.operators.push_back(getBinaryOperator(token(index_)));
+                frame.lastPrecedence = precedence;
+                index_++;
+
+                // The right operand only takes operators that bind tighter than this one (left associativity)
+                frames.push_back(ExpressionFrame{precedence + 1, FrameCloser::CLOSE_OPERAND});
+                continue;
+            }
 
-    // Check for NumberFactor
-    else if (tokens_[index_]->getType() == TokenType::NUMBER_TOKEN) {
-        NumberFactor* numFactor = nullptr;
-        try {
-            numFactor = parseNumberFactor();
-            if (!numFactor) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected number factor");
-        } catch (const TypeError& e) {
-            error(e);
-        }
-        return numFactor;
-    }
+            // The frame is complete: build its node and hand it to the frame below
+            Expression* expr = buildChain(frame.operands, frame.operators);
+            FrameCloser closer = frame.closer;
+            const std::string* listId = frame.listId;
+            frames.pop_back();
 
-    // Check for BoolFactor
-    else if (tokens_[index_]->getType() == TokenType::BOOL_TOKEN) {
-        BoolFactor* boolFactor = nullptr;
-        try {
-            boolFactor = parseBoolFactor();
-            if (!boolFactor) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected boolean factor");
-        } catch (const TypeError& e) {
-            error(e);
+            if (closer == FrameCloser::CLOSE_EXPRESSION) {
+                return expr;
+            }
+            else if (closer == FrameCloser::CLOSE_PARENTHESIS) {
+                operand = expr;
+                // Check for the ')' token
+                if (!isPunctuation(PunctuationToken::RPAR)) {
+                    throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected ')' in expression factor");
+                }
+                // Skip the ')' token
+                index_++;
+            }
+            else if (closer == FrameCloser::CLOSE_BRACKET) {
+                operand = expr;
+                // Check for the ']' token
+                if (!isPunctuation(PunctuationToken::RBRACK)) {
+                    throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected ']' in list element location");
+                }
+                // Skip the ']' token
+                index_++;
+                operand = new ListElementLocation(listId, expr, index_ - 1, tokens_);
+            }
+            else {
+                operand = expr;
+            }
         }
-        return boolFactor;
-    }
 
-    // Check for Location
-    else if (tokens_[index_]->getType() == TokenType::ID_TOKEN) {
-        Location* location = nullptr;
-        try {
-            location = parseLocation();
-            if (!location) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected location");
-        } catch (const TypeError& e) {
-            error(e);
+    } catch (...) {
+        delete operand;
+        for (ExpressionFrame& frame : frames) {
+            for (Expression* expr : frame.operands) {
+                delete expr;
+            }
         }
-        return location;
-    }
-
-    // If no Factor was found, return nullptr
-    else {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected factor");
-        return nullptr;
+        throw;
     }
 }
 
 /**
- * @brief Parses an ExpressionFactor from the token vector
- * @return A pointer to the parsed ExpressionFactor object
+ * @brief Builds the node for a chain of operators of the same precedence
+ * @param operands The operands of the chain
+ * @param operators The operators between consecutive operands
+ * @return The single operand, a Binary node for one operator or a Nary node for longer chains
  */
-ExpressionFactor* Parser::parseExpressionFactor(){
-    // Check for the '(' token
-    if (
-        tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN ||
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::LPAR
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '(' in expression factor");
+Expression* Parser::buildChain(std::vector<Expression*>& operands, std::vector<BinaryOperator>& operators){
+    if (operators.empty()) {
+        return operands[0];
     }
-    // Skip the '(' token
-    index_++;
-
-    // Calls the parsing function for the expression
-    Expression* expr = nullptr;
-    try {
-        expr = parseExpression();
-        if (!expr) throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression in expression factor");
-    } catch (const TypeError& e) {
-        error(e);
-    }
-
-    // Check for the ')' token
-    if (
-        tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN ||
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::RPAR
-    ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ')' in expression factor");
+    else if (operators.size() == 1) {
+        return new Binary(operands[0], operators[0], operands[1], index_ - 1, tokens_);
     }
-    // Skip the ')' token
-    index_++;
-
-    // Create and return the ExpressionFactor object
-    return new ExpressionFactor(expr, index_ - 1, tokens_);
+    return new Nary(std::move(operands), std::move(operators), index_ - 1, tokens_);
 }
 
 /**
- * @brief Parses a NumberFactor from the token vector
- * @return A pointer to the parsed NumberFactor object
+ * @brief Parses an integer or boolean Literal from the token vector
+ * @return A pointer to the parsed Literal object
  */
-NumberFactor* Parser::parseNumberFactor(){
+Literal* Parser::parseLiteral(){
     // Check for the 'NUM' token
-    if (tokens_[index_]->getType() != TokenType::NUMBER_TOKEN) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected number in number factor");
+    if (token(index_)->getType() == TokenType::NUMBER_TOKEN) {
+        int value = static_cast<NumberToken*>(token(index_))->getIntValue();
+        index_++;
+        return new Literal(value, index_ - 1, tokens_);
     }
-    // Define the number token
-    NumberToken* numberToken = static_cast<NumberToken*>(tokens_[index_]);
-    index_++;
-
-    // Create and return the NumberFactor object
-    return new NumberFactor(numberToken, index_ - 1, tokens_);
-}
-
-/**
- * @brief Parses a BoolFactor from the token vector
- * @return A pointer to the parsed BoolFactor object
- */
-BoolFactor* Parser::parseBoolFactor(){
     // Check for the 'BOOL' token
-    if (tokens_[index_]->getType() != TokenType::BOOL_TOKEN) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected boolean in boolean factor");
+    else if (token(index_)->getType() == TokenType::BOOL_TOKEN) {
+        bool value = static_cast<BoolToken*>(token(index_))->getBoolValue();
+        index_++;
+        return new Literal(value, index_ - 1, tokens_);
     }
-    // Define the bool token
-    BoolToken* boolToken = static_cast<BoolToken*>(tokens_[index_]);
-    index_++;
 
-    // Create and return the BoolFactor object
-    return new BoolFactor(boolToken, index_ - 1, tokens_);
+    throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected number or boolean in literal");
 }
 
 /**
@@ -1198,27 +975,27 @@ BoolFactor* Parser::parseBoolFactor(){
  */
 Location* Parser::parseLocation(){
     // Check for the 'ID' token
-    if (tokens_[index_]->getType() != TokenType::ID_TOKEN) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected identifier in location");
+    if (token(index_)->getType() != TokenType::ID_TOKEN) {
+        throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected identifier in location");
     }
     // Define the id token
-    IdToken* idToken = static_cast<IdToken*>(tokens_[index_]);
+    IdToken* idToken = static_cast<IdToken*>(token(index_));
     index_++;
 
     // Check for ListElementLocation
     if (
-        tokens_[index_]->getType() == TokenType::PUNCTUATION_TOKEN &&
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() == PunctuationToken::LBRACK
+        token(index_)->getType() == TokenType::PUNCTUATION_TOKEN &&
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() == PunctuationToken::LBRACK
     ) {
         ListElementLocation* listElemLoc = parseListElementLocation(idToken);
         if (!listElemLoc) {
-            throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected list element location");
+            throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected list element location");
         }
         return listElemLoc;
     }
     else {
         // If no ListElementLocation was found, return the IdToken as a simple Location
-        IdLocation* location = new IdLocation(idToken, index_ - 1, tokens_);
+        IdLocation* location = new IdLocation(intern(idToken), index_ - 1, tokens_);
         return location;
     }
 }
@@ -1230,30 +1007,114 @@ Location* Parser::parseLocation(){
  */
 ListElementLocation* Parser::parseListElementLocation(IdToken* idToken){
     // Check for the '[' token
-    if (tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN ||
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::LBRACK
+    if (token(index_)->getType() != TokenType::PUNCTUATION_TOKEN ||
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::LBRACK
     ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected '[' in list element location");
+        throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected '[' in list element location");
     }
     // Skip the '[' token
     index_++;
 
-    // Calls the parsing function for the expression
-    Expression* expr = parseExpression();
+    // Calls the parsing function for the expression (deleted if the location is invalid)
+    std::unique_ptr<Expression> expr(parseExpression());
     if (!expr) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected expression in list element location");
+        throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected expression in list element location");
     }
 
     // Check for the ']' token
     if (
-        tokens_[index_]->getType() != TokenType::PUNCTUATION_TOKEN ||
-        static_cast<PunctuationToken*>(tokens_[index_])->getIntValue() != PunctuationToken::RBRACK
+        token(index_)->getType() != TokenType::PUNCTUATION_TOKEN ||
+        static_cast<PunctuationToken*>(token(index_))->getIntValue() != PunctuationToken::RBRACK
     ) {
-        throw SyntaxError(tokens_[index_]->getLine(), tokens_[index_]->getColumn(), "Expected ']' in list element location");
+        throw SyntaxError(token(index_)->getLine(), token(index_)->getColumn(), "Expected ']' in list element location");
     }
     // Skip the ']' token
     index_++;
 
     // Create and return the ListElementLocation object
-    return new ListElementLocation(idToken, expr, index_ - 1, tokens_);
+    return new ListElementLocation(intern(idToken), expr.release(), index_ - 1, tokens_);
+}
+
+/**
+ * @brief Returns the precedence of a binary operator token
+ * @param token The token to classify
+ * @return The Precedence of the operator, or NO_PRECEDENCE if the token is not a binary operator
+ */
+int Parser::getPrecedence(Token* token) const {
+    switch (token->getType()) {
+        case TokenType::BOOLOP_TOKEN:
+            if (token->getIntValue() == BoolOpToken::OR) return Precedence::OR_PRECEDENCE;
+            if (token->getIntValue() == BoolOpToken::AND) return Precedence::AND_PRECEDENCE;
+            return Precedence::NO_PRECEDENCE;
+        case TokenType::RELATIONAL_TOKEN:
+            if (
+                token->getIntValue() == RelationalToken::EQ ||
+                token->getIntValue() == RelationalToken::NEQ
+            ) return Precedence::EQUALITY_PRECEDENCE;
+            return Precedence::RELATION_PRECEDENCE;
+        case TokenType::ARITHMETIC_TOKEN:
+            if (
+                token->getIntValue() == ArithmeticToken::ADD ||
+                token->getIntValue() == ArithmeticToken::SUB
+            ) return Precedence::ADDITIVE_PRECEDENCE;
+            return Precedence::MULTIPLICATIVE_PRECEDENCE;
+        default:
+            return Precedence::NO_PRECEDENCE;
+    }
+}
+
+/**
+ * @brief Maps a binary operator token to the corresponding BinaryOperator
+ * @param token The operator token (must have a precedence)
+ * @return The BinaryOperator represented by the token
+ */
+BinaryOperator Parser::getBinaryOperator(Token* token) const {
+    if (token->getType() == TokenType::BOOLOP_TOKEN) {
+        return token->getIntValue() == BoolOpToken::OR ? BinaryOperator::OR_OP : BinaryOperator::AND_OP;
+    }
+    else if (token->getType() == TokenType::RELATIONAL_TOKEN) {
+        switch (token->getIntValue()) {
+            case RelationalToken::EQ: return BinaryOperator::EQ_OP;
+            case RelationalToken::NEQ: return BinaryOperator::NEQ_OP;
+            case RelationalToken::LT: return BinaryOperator::LT_OP;
+            case RelationalToken::LE: return BinaryOperator::LE_OP;
+            case RelationalToken::GT: return BinaryOperator::GT_OP;
+            case RelationalToken::GE: return BinaryOperator::GE_OP;
+        }
+    }
+    else if (token->getType() == TokenType::ARITHMETIC_TOKEN) {
+        switch (token->getIntValue()) {
+            case ArithmeticToken::ADD: return BinaryOperator::ADD_OP;
+            case ArithmeticToken::SUB: return BinaryOperator::SUB_OP;
+            case ArithmeticToken::MUL: return BinaryOperator::MUL_OP;
+            case ArithmeticToken::DIV: return BinaryOperator::DIV_OP;
+        }
+    }
+    throw InternalError(token->getLine(), token->getColumn(), "Invalid binary operator");
+}
+
+/**
+ * @brief Checks if the current token is the given reserved keyword
+ * @param keyword The ReservedKeywordToken value to look for
+ * @return true if the current token is that keyword
+ */
+bool Parser::isKeyword(int keyword) {
+    return token(index_)->getType() == TokenType::RESERVEDKEYWORD_TOKEN && token(index_)->getIntValue() == keyword;
+}
+
+/**
+ * @brief Checks if the current token is the given punctuation character
+ * @param punctuation The PunctuationToken value to look for
+ * @return true if the current token is that punctuation character
+ */
+bool Parser::isPunctuation(int punctuation) {
+    return token(index_)->getType() == TokenType::PUNCTUATION_TOKEN && token(index_)->getIntValue() == punctuation;
+}
+
+/**
+ * @brief Checks if the current token is a dedentation
+ * @return true if the current token is an IndentationToken closing a block
+ */
+bool Parser::isDedent() {
+    return token(index_)->getType() == TokenType::INDENTATION_TOKEN && !token(index_)->getBoolValue();
 }
\ No newline at end of file
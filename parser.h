@@ -2,7 +2,11 @@
 #define PARSER_H
 
 #include <vector>
+#include <mutex>
+#include <functional>
+#include <memory>
 #include "token.h"
+#include "lexer.h"
 #include "syntax.h"
 #include "error.h"
 
@@ -18,17 +22,106 @@
  */
 
 
+// Smallest number of tokens parsed by one thread of a parallel parse
+#define PARSER_CHUNK_TOKENS (1 << 14)
+
+// Range of top-level statements parsed by one thread of a parallel parse (defined in parser.cpp)
+struct ParserChunk;
+
+/**
+ * @enum Precedence
+ * @brief Binding power of the binary operators, from the loosest ('or') to the tightest ('*' and '//')
+ */
+enum Precedence {
+    NO_PRECEDENCE,
+    OR_PRECEDENCE,
+    AND_PRECEDENCE,
+    EQUALITY_PRECEDENCE,
+    RELATION_PRECEDENCE,
+    ADDITIVE_PRECEDENCE,
+    MULTIPLICATIVE_PRECEDENCE
+};
+
+/**
+ * @enum FrameCloser
+ * @brief What ends an ExpressionFrame and what is done with its result
+ */
+enum FrameCloser {
+    CLOSE_EXPRESSION,   // the whole expression (the result is returned)
+    CLOSE_OPERAND,      // the right operand of a binary operator
+    CLOSE_PARENTHESIS,  // a parenthesized expression, ended by ')'
+    CLOSE_BRACKET       // a list index, ended by ']'
+};
+
+/**
+ * @struct ExpressionFrame
+ * @brief State of one precedence-climbing loop on the explicit expression stack
+ *
+ * Each frame replaces one recursive call, so nested parentheses, brackets and unary
+ * operators only grow a heap-allocated vector instead of the call stack.
+ */
+struct ExpressionFrame {
+    int minPrecedence;                       // loosest operator the frame may consume
+    FrameCloser closer;                      // what ends the frame
+    const std::string* listId{nullptr};      // interned list identifier (CLOSE_BRACKET frames only)
+    int lastPrecedence{Precedence::MULTIPLICATIVE_PRECEDENCE + 1}; // precedence of the chain being collected
+    std::vector<Expression*> operands{};     // operands of the chain being collected
+    std::vector<BinaryOperator> operators{}; // operators of the chain being collected
+    std::vector<UnaryOperator> prefixes{};   // unary operators waiting for their operand
+};
+
+/**
+ * @struct BlockFrame
+ * @brief State of one open block on the explicit block stack
+ *
+ * The bottom frame collects the statements of the Program, every other frame collects the body
+ * of a compound statement and carries what has been parsed of that statement so far.
+ * A frame owns the nodes it holds until they are handed over to the tree (the fields are then
+ * cleared), so the partial tree of a syntax error is deleted with the frames.
+ */
+struct BlockFrame {
+    BlockFrame() = default;
+    BlockFrame(BlockFrame&& other) noexcept; // defined in parser.cpp (the other frame is emptied)
+    BlockFrame(BlockFrame const& f) = delete;
+    ~BlockFrame(); // defined in parser.cpp (deletes the nodes still held)
+
+    std::vector<Statement*> statements;      // statements of the block being parsed
+    BlockType blockType{SIMPLE_BLOCK};       // kind of block (SIMPLE_BLOCK for 'if'/'while' bodies)
+    StatementType stmtType{IF_STMT};         // compound statement owning the block
+    Expression* condition{nullptr};          // condition of the compound statement
+    Expression* elifCondition{nullptr};      // condition of the elif block being parsed
+    std::vector<Block*> blocks;              // blocks of the compound statement parsed so far
+    int lazyBegin{-1};                       // first token of the body of a lazy block (-1 if parsed)
+};
+
 /**
  * @class Parser
  * @brief Syntactic analyzer for the Python-Sublanguage interpreter
  * 
  * The Parser class is responsible for creating the Syntax Tree from the token vector.
+ * Blocks and expressions are parsed with explicit stacks, so the nesting depth of the
+ * input is not limited by the size of the call stack. In lazy mode the bodies of blocks are
+ * only delimited by their INDENT/DEDENT tokens and parsed the first time they are executed,
+ * so the parser must outlive the Syntax Tree.
+ * A parser constructed on a Lexer (or any TokenSource) pulls the tokens on demand, looking at
+ * most two tokens ahead, so lexing and parsing proceed together. Without lazy blocks the tokens
+ * of each complete statement are deleted as the parsing advances (unless keepTokens() is called):
+ * only their null slots stay in the token vector, so positions keep their meaning.
+ * The Syntax Tree does not refer to the tokens: the nodes copy their values and positions and
+ * point to the identifiers interned in the NameTable of the parser, which the Program shares.
+ * The tokens can therefore be freed once the program is parsed (see freeTokens()), unless the
+ * lazy blocks still have to parse their bodies.
+ * With a statement sink, each top-level statement is handed to the sink as soon as it is
+ * complete instead of being collected in the Program (see Pipeline).
+ * A complete token vector can also be parsed by several threads, each one parsing a range of
+ * top-level statements (see setThreads()).
  */
 class Parser{
     public:
         // constructors
         Parser() = delete;
-        Parser(std::vector<Token*> tokens) : tokens_(std::move(tokens)) {} // move the token vector
+        Parser(std::vector<Token*> tokens, bool lazyBlocks = false) : lazyBlocks_(lazyBlocks), ownTokens_(std::move(tokens)) {} // move the token vector
+        Parser(TokenSource& lexer, bool lazyBlocks = false) : lazyBlocks_(lazyBlocks), lexer_(&lexer), releaseTokens_(!lazyBlocks) {} // pull the tokens from the lexer
         Parser(Parser const& p) = delete;
 
         // destructor
@@ -40,8 +133,27 @@ class Parser{
             return parseProgram();
         }
 
+        // method to access the token vector
+        std::vector<Token*> const& getTokens() const { return tokens_; }
+
+        // method to delete the tokens once the Syntax Tree is built (not with lazy blocks)
+        bool freeTokens();
+
+        // method to keep the streamed tokens until the end of the parsing (to store the program in the cache)
+        void keepTokens() { releaseTokens_ = false; }
+
+        // method to access the identifiers of the Syntax Tree
+        std::shared_ptr<NameTable> const& getNames() const { return names_; }
+
+        // method to parse a token vector on up to threads threads (not with lazy blocks nor streamed tokens)
+        void setThreads(size_t threads) { threads_ = threads; }
+
+        // method to receive the top-level statements as they are parsed (not with lazy blocks)
+        void setStatementSink(std::function<void(Statement*)> sink) { statementSink_ = std::move(sink); }
+
         // methods to parse the token vector and create the Syntax Tree
         Program* parseProgram();
+        std::vector<Statement*> parseBlockBody(int begin, int end);
         Statement* parseStatement();
         AssignmentStatement* parseAssignmentStatement();
         ListDeclarationStatement* parseListDeclarationStatement();
@@ -49,36 +161,64 @@ class Parser{
         BreakStatement* parseBreakStatement();
         ContinueStatement* parseContinueStatement();
         PrintStatement* parsePrintStatement();
-        CompoundStatement* parseCompoundStatement();
-        Block* parseBlock();
-        ElifBlock* parseElifBlock();
-        ElseBlock* parseElseBlock();
 
         Expression* parseExpression();
-        OrExpr* parseOrExpr(Join* left);
-        Join* parseJoin();
-        AndExpr* parseAndExpr(Equality* left);
-        Equality* parseEquality();
-        EqualExpr* parseEqualExpr(Relation* left);
-        Relation* parseRelation();
-        ComparativeRelation* parseComparativeRelation(NumExpr* left);
-        NumExpr* parseNumExpr();
-        AritExpr* parseAritExpr(Term* left);
-        Term* parseTerm();
-        MulDivTerm* parseMulDivTerm(Unary* left);
-        Unary* parseUnary();
-        NotUnary* parseNotUnary();
-        MinusUnary* parseMinusUnary();
-        Factor* parseFactor();
-        ExpressionFactor* parseExpressionFactor();
-        NumberFactor* parseNumberFactor();
-        BoolFactor* parseBoolFactor();
+        Literal* parseLiteral();
         Location* parseLocation();
         ListElementLocation* parseListElementLocation(IdToken* idToken);
         
     private:
+        // constructor of a chunk parser, which reads the token vector of its parent from a position
+        Parser(Parser& parent, int position) : lazyBlocks_(false), tokens_(parent.tokens_), index_(position) {}
+
+        // methods to parse the top-level statements in ranges on several threads
+        std::vector<Statement*> parseStatementsParallel();
+        void parseChunk(ParserChunk& chunk);
+
+        // methods to parse sequences of statements and to open and close the blocks of compound statements
+        std::vector<Statement*> parseStatements(int end);
+        void openCompoundStatement(std::vector<BlockFrame>& frames);
+        void openBlock(std::vector<BlockFrame>& frames, BlockFrame frame);
+        void closeBlock(std::vector<BlockFrame>& frames);
+        void emitStatements(BlockFrame& frame);
+
+        // method to build the node of an operator chain
+        Expression* buildChain(std::vector<Expression*>& operands, std::vector<BinaryOperator>& operators);
+
+        // methods to access the tokens, pulling them from the lexer when they are streamed
+        Token* token(int position) {
+            if (position >= (int)tokens_.size()) pullTokens(position);
+            return tokens_[position];
+        }
+        bool hasToken(int position) {
+            if (position >= (int)tokens_.size()) pullTokens(position);
+            return position < (int)tokens_.size();
+        }
+        void pullTokens(int position);
+        void drainLexer();
+        void releaseTokens();
+
+        // method to intern the name of an identifier token in the NameTable
+        const std::string* intern(IdToken* idToken) { return names_->intern(idToken->getStringValue()); }
+
+        // methods to classify tokens
+        int getPrecedence(Token* token) const;
+        BinaryOperator getBinaryOperator(Token* token) const;
+        bool isKeyword(int keyword);
+        bool isPunctuation(int punctuation);
+        bool isDedent();
+
+        bool lazyBlocks_; // record the token range of block bodies, parse them on first execution
+        std::mutex lazyMutex_;
+        std::vector<Token*> ownTokens_;        // tokens of the parser
+        std::vector<Token*>& tokens_{ownTokens_}; // tokens read (those of the parent for a chunk parser)
         int index_{0};
-        std::vector<Token*> tokens_;
+        size_t threads_{1};
+        TokenSource* lexer_{nullptr}; // source of the streamed tokens, until its last one
+        bool releaseTokens_{false}; // delete the streamed tokens of the complete statements
+        int released_{0};           // position of the first token not deleted yet
+        std::function<void(Statement*)> statementSink_; // receiver of the complete top-level statements (if set)
+        std::shared_ptr<NameTable> names_{std::make_shared<NameTable>()}; // identifiers of the Syntax Tree (a chunk parser has its own)
 };
 
 
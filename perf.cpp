@@ -0,0 +1,231 @@
+/**
+ * @file perf.cpp
+ * @brief Implements the hardware performance counters of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the PerfCounters class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "perf.h"
+#include "profiler.h"
+
+static const char* const EventName[PERF_EVENTS] = {"task-clock", "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"};
+
+/**
+ * @brief Opens the counters of the events on the calling thread
+ */
+PerfCounters::PerfCounters() {
+    const uint32_t types[PERF_EVENTS] = {PERF_TYPE_SOFTWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                         PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    const uint64_t configs[PERF_EVENTS] = {
+        PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES};
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[e];
+        attr.config = configs[e];
+        // User space only: allowed with perf_event_paranoid up to 2
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // The times let the counts be scaled when the PMU multiplexes more events than it has counters
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds_[e] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (fds_[e] < 0 && reason_.empty()) {
+            reason_ = std::string(EventName[e]) + ": " + std::strerror(errno);
+        }
+    }
+    std::fill(phaseStart_, phaseStart_ + PERF_EVENTS, 0.0);
+    std::fill(statementStart_, statementStart_ + PERF_EVENTS, 0.0);
+}
+
+/**
+ * @brief Closes the counters
+ */
+PerfCounters::~PerfCounters() {
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        if (fds_[e] >= 0) close(fds_[e]);
+    }
+}
+
+/**
+ * @brief Checks if at least one hardware event is counted
+ * @return False if only the task clock (or nothing) could be opened
+ */
+bool PerfCounters::isAvailable() const {
+    for (int e = CYCLES_EVENT; e < PERF_EVENTS; e++) {
+        if (fds_[e] >= 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Begins a phase of the run, ending the previous one
+ * @param name The name of the phase (a string literal)
+ */
+void PerfCounters::beginPhase(const char* name) {
+    endPhase();
+    phases_.push_back(PerfRegion{name, nullptr, 1, 0, {}});
+    phaseOpen_ = true;
+    read(phaseStart_);
+}
+
+/**
+ * @brief Ends the phase being counted, if any
+ */
+void PerfCounters::endPhase() {
+    if (phaseOpen_) {
+        accumulate(phases_.back(), phaseStart_);
+        phaseOpen_ = false;
+    }
+}
+
+/**
+ * @brief Ends the statement and the phase still open (after an error)
+ * @param executed The statements executed by the run
+ */
+void PerfCounters::finish(uint64_t executed) {
+    exitStatement(executed);
+    endPhase();
+}
+
+/**
+ * @brief Begins a top-level statement, ending the previous one
+ * @param stmt The statement
+ * @param executed The statements executed so far, this one included
+ */
+void PerfCounters::enterStatement(Statement* stmt, uint64_t executed) {
+    exitStatement(executed - 1);
+    current_ = stmt;
+    currentExecuted_ = executed - 1;
+    read(statementStart_);
+}
+
+/**
+ * @brief Ends the top-level statement being executed, if any
+ * @param executed The statements executed so far
+ */
+void PerfCounters::exitStatement(uint64_t executed) {
+    if (!current_) {
+        return;
+    }
+    auto found = index_.find(current_);
+    if (found == index_.end()) {
+        found = index_.emplace(current_, statements_.size()).first;
+        statements_.push_back(PerfRegion{nullptr, current_, 0, 0, {}});
+    }
+    PerfRegion& region = statements_[found->second];
+    accumulate(region, statementStart_);
+    region.executions++;
+    region.statements += executed - currentExecuted_;
+    current_ = nullptr;
+}
+
+/**
+ * @brief Writes the counts of the phases and of the top-level statements
+ *
+ * The counts of the execution are also divided by the number of statements it ran.
+ * @param out The output stream
+ * @param executed The statements executed by the run
+ */
+void PerfCounters::writeReport(std::ostream& out, uint64_t executed) const {
+    if (!isAvailable()) {
+        out << "Perf counters unavailable (" << (reason_.empty() ? "no hardware event" : reason_) << "), only the task clock is reported" << std::endl;
+    } else if (!reason_.empty()) {
+        out << "Some perf counters are unavailable (" << reason_ << ")" << std::endl;
+    }
+    auto value = [this](std::ostream& o, const PerfRegion& region, int e, double divisor, int width) {
+        if (fds_[e] < 0 || divisor <= 0) o << std::setw(width) << "n/a";
+        else o << std::setw(width) << region.values[e] / divisor;
+    };
+    auto ipc = [this](std::ostream& o, const PerfRegion& region) {
+        if (fds_[CYCLES_EVENT] < 0 || fds_[INSTRUCTIONS_EVENT] < 0 || region.values[CYCLES_EVENT] <= 0) o << std::setw(7) << "n/a";
+        else o << std::setw(7) << region.values[INSTRUCTIONS_EVENT] / region.values[CYCLES_EVENT];
+    };
+
+    out << std::fixed << std::setprecision(0);
+    out << std::left << std::setw(10) << "phase" << std::right << std::setw(12) << "task ms";
+    for (int e = CYCLES_EVENT; e < PERF_EVENTS; e++) out << std::setw(16) << EventName[e];
+    out << std::setw(7) << "IPC" << std::endl;
+    for (const PerfRegion& phase : phases_) {
+        out << std::left << std::setw(10) << phase.name << std::right << std::setprecision(3);
+        value(out, phase, TASK_CLOCK_EVENT, 1e6, 12);
+        out << std::setprecision(0);
+        for (int e = CYCLES_EVENT; e < PERF_EVENTS; e++) value(out, phase, e, 1, 16);
+        out << std::setprecision(2);
+        ipc(out, phase);
+        out << std::setprecision(0) << std::endl;
+    }
+
+    // Cost of an executed statement, over the whole execution phase
+    for (const PerfRegion& phase : phases_) {
+        if (std::strcmp(phase.name, "execute") != 0 || !executed) continue;
+        out << "per executed statement (" << executed << "):" << std::setprecision(2);
+        for (int e = TASK_CLOCK_EVENT; e < PERF_EVENTS; e++) {
+            if (fds_[e] < 0) continue;
+            out << " " << (e == TASK_CLOCK_EVENT ? "task-ns" : EventName[e]) << " " << phase.values[e] / executed;
+        }
+        out << std::setprecision(0) << std::endl;
+    }
+
+    if (statements_.empty()) {
+        return;
+    }
+    std::vector<const PerfRegion*> sorted;
+    for (const PerfRegion& region : statements_) sorted.push_back(&region);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const PerfRegion* a, const PerfRegion* b) {
+        return Profiler::getSourceLine(a->stmt) < Profiler::getSourceLine(b->stmt);
+    });
+    out << "top-level statements (counts per executed statement):" << std::endl;
+    out << std::setw(8) << "line" << std::setw(12) << "statement" << std::setw(12) << "executed" << std::setw(12) << "task ns";
+    for (int e = CYCLES_EVENT; e < PERF_EVENTS; e++) out << std::setw(16) << EventName[e];
+    out << std::setw(7) << "IPC" << std::endl;
+    for (const PerfRegion* region : sorted) {
+        std::string name = Profiler::getFrameName(region->stmt);
+        double count = double(region->statements);
+        out << std::setw(8) << Profiler::getSourceLine(region->stmt) << std::setw(12) << name.substr(0, name.find(':'))
+            << std::setw(12) << region->statements << std::setprecision(1);
+        value(out, *region, TASK_CLOCK_EVENT, count, 12);
+        for (int e = CYCLES_EVENT; e < PERF_EVENTS; e++) value(out, *region, e, count, 16);
+        out << std::setprecision(2);
+        ipc(out, *region);
+        out << std::setprecision(0) << std::endl;
+    }
+}
+
+/**
+ * @brief Reads the current value of every event
+ * @param values The values, scaled by the fraction of time the event was counted (0 if missing)
+ */
+void PerfCounters::read(double values[PERF_EVENTS]) const {
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        uint64_t data[3]; // value, time enabled, time running
+        values[e] = 0;
+        if (fds_[e] < 0 || ::read(fds_[e], data, sizeof(data)) != sizeof(data)) continue;
+        values[e] = data[2] ? double(data[0]) * data[1] / data[2] : 0;
+    }
+}
+
+/**
+ * @brief Adds the counts since a reading to a region
+ * @param region The region
+ * @param start The reading at the start of the region
+ */
+void PerfCounters::accumulate(PerfRegion& region, const double start[PERF_EVENTS]) const {
+    double now[PERF_EVENTS];
+    read(now);
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        region.values[e] += now[e] - start[e];
+    }
+}
@@ -0,0 +1,100 @@
+#if !defined(PERF_H)
+#define PERF_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "syntax.h"
+
+/**
+ * @file perf.h
+ * @brief Defines the hardware performance counters of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the PerfCounters class, which reads the Linux
+ * perf_event_open counters (cycles, instructions, branch misses, L1 data and last level cache
+ * misses) around the phases of a run and, optionally, around its top-level statements.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+/**
+ * @enum PerfEvent
+ * @brief Events counted by the PerfCounters
+ */
+enum PerfEvent {
+    TASK_CLOCK_EVENT,    // CPU time of the thread (a software event, available without a PMU)
+    CYCLES_EVENT,
+    INSTRUCTIONS_EVENT,
+    BRANCH_MISSES_EVENT,
+    L1D_MISSES_EVENT,    // L1 data cache read misses
+    LLC_MISSES_EVENT,    // last level cache misses
+    PERF_EVENTS
+};
+
+/**
+ * @struct PerfRegion
+ * @brief Counts of a phase or of a top-level statement
+ */
+struct PerfRegion {
+    const char* name;             // name of the phase (phases only)
+    Statement* stmt;              // statement (statements only)
+    uint64_t executions;          // times the region was entered
+    uint64_t statements;          // statements executed in the region (statements only)
+    double values[PERF_EVENTS];   // counts of the events, scaled when the counters were multiplexed
+};
+
+/**
+ * @class PerfCounters
+ * @brief Hardware counters read by main() around the phases and by the Visitor around statements
+ *
+ * Each event is opened on its own for the calling thread, in user space only, so that the
+ * events the host does not provide (no PMU in a container or a virtual machine, a restrictive
+ * perf_event_paranoid) are reported as missing while the others are still counted. When no
+ * event can be opened the run goes on and the report says why.
+ */
+class PerfCounters{
+    public:
+        // constructors
+        PerfCounters();
+        PerfCounters(PerfCounters const& p) = delete;
+
+        // destructor
+        ~PerfCounters();
+
+        // methods to know which events are counted
+        bool isAvailable() const;
+        const std::string& getUnavailableReason() const { return reason_; }
+
+        // methods called by main()
+        void beginPhase(const char* name);
+        void endPhase();
+        void finish(uint64_t executed);
+
+        // methods called by the Visitor (executed: statements executed so far, the current one included)
+        void enterStatement(Statement* stmt, uint64_t executed);
+        void exitStatement(uint64_t executed);
+
+        // method to write the report (executed: statements executed by the run)
+        void writeReport(std::ostream& out, uint64_t executed) const;
+
+    private:
+        void read(double values[PERF_EVENTS]) const;
+        void accumulate(PerfRegion& region, const double start[PERF_EVENTS]) const;
+
+        int fds_[PERF_EVENTS];                         // file descriptors of the events (-1 if missing)
+        std::string reason_;                           // error of the first event that could not be opened
+        std::vector<PerfRegion> phases_;
+        bool phaseOpen_{false};                        // the last phase is being counted
+        double phaseStart_[PERF_EVENTS];
+        std::vector<PerfRegion> statements_;           // top-level statements, in order of first execution
+        std::unordered_map<Statement*, size_t> index_; // position of each statement in statements_
+        Statement* current_{nullptr};                  // top-level statement being executed
+        uint64_t currentExecuted_{0};                  // statements executed before it
+        double statementStart_[PERF_EVENTS];
+};
+
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file pipeline.cpp
+ * @brief Implements the concurrent pipeline of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the TokenQueue and Pipeline classes.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <cerrno>
+#include <unistd.h>
+#include "pipeline.h"
+
+/**
+ * @brief Writes a buffer to a file descriptor, retrying the interrupted and partial writes
+ * @param fd The file descriptor
+ * @param data The bytes to write
+ * @param size The number of bytes
+ */
+static void writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            // the output is lost, as it would be with a failed stream
+            return;
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+/**
+ * @brief Pulls the next token pushed by the lexer thread, waiting for it
+ * @return The token, or nullptr after the EOF token
+ */
+Token* TokenQueue::next() {
+    Token* token = queue_.pop();
+    if (!token && error_) {
+        // The lexer stopped at its error: raise it once, as the Lexer would
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+    return token;
+}
+
+/**
+ * @brief Constructs a pipeline on an input stream (the threads start when it runs)
+ * @param input The source of the program
+ * @param fd The file descriptor of the output of the program
+ * @param policy The flush policy of the output (FLUSH_ASYNC is only kept when streaming)
+ * @param streaming Write the output as it is produced and run the statements before a syntax error
+ */
+Pipeline::Pipeline(std::istream& input, int fd, FlushPolicy policy, bool streaming) :
+    lexer_(input), parser_(tokens_), program_(new Program({}, parser_.getNames())), fd_(fd), streaming_(streaming) {
+    parser_.setStatementSink([this](Statement* stmt) { statements_.push(stmt); });
+    if (streaming_) {
+        output_.reset(new OutputSink(fd_, policy));
+        return;
+    }
+    // The held output is only touched by the executor: a background writer would race with its release
+    if (policy == FLUSH_ASYNC) {
+        policy = FLUSH_ON_SIZE;
+    }
+    output_.reset(new OutputSink([this](const char* data, size_t size) {
+        if (released_) writeAll(fd_, data, size);
+        else held_.append(data, size);
+    }, policy));
+}
+
+/**
+ * @brief Destroys the pipeline, waiting for its threads
+ */
+Pipeline::~Pipeline() {
+    if (lexerThread_.joinable()) lexerThread_.join();
+    if (parserThread_.joinable()) parserThread_.join();
+}
+
+/**
+ * @brief Runs the program: starts the lexer and parser threads and executes the statements as they are parsed
+ *
+ * The visitor must run getProgram() and write to getOutput(). The error of the run is raised
+ * once both threads have ended, after the output has been released (or discarded, before a
+ * syntax error).
+ * @param visitor The visitor executing the statements
+ */
+void Pipeline::operator()(Visitor& visitor) {
+    lexerThread_ = std::thread(&Pipeline::lex, this);
+    parserThread_ = std::thread(&Pipeline::parse, this);
+
+    std::exception_ptr runtimeError;
+    visitor.start();
+    try {
+        while (true) {
+            bool received = takeStatements();
+            if (parsed_) {
+                // Without streaming nothing runs after a syntax error is known
+                if (parseError_ && !streaming_) break;
+                if (!parseError_) release();
+            }
+            bool ended = visitor.extend(PIPELINE_SLICE);
+            if (ended && parsed_) break;
+            // Every statement received has run: wait for the parser
+            if (ended && !received) statements_.waitForElement();
+        }
+    } catch (const Error&) {
+        runtimeError = std::current_exception();
+    }
+
+    // The parser may be waiting for room in the queue: read its statements until it ends
+    while (!parsed_) {
+        if (!takeStatements()) statements_.waitForElement();
+    }
+    lexerThread_.join();
+    parserThread_.join();
+
+    // A syntax error comes first in a sequential run (the output held so far is discarded),
+    // unless the statements before it already ran into a runtime error while streaming
+    if (parseError_ && !(streaming_ && runtimeError)) {
+        std::rethrow_exception(parseError_);
+    }
+    release();
+    if (runtimeError) {
+        std::rethrow_exception(runtimeError);
+    }
+}
+
+/**
+ * @brief Lexes the input, pushing the tokens for the parser thread
+ */
+void Pipeline::lex() {
+    try {
+        while (Token* token = lexer_.next()) {
+            tokens_.push(token);
+        }
+        tokens_.push(nullptr);
+    } catch (...) {
+        tokens_.fail(std::current_exception());
+    }
+}
+
+/**
+ * @brief Parses the tokens of the lexer thread, pushing the top-level statements for the executor
+ *
+ * Once the whole file is parsed the tokens are freed, while the program may still be running.
+ */
+void Pipeline::parse() {
+    try {
+        // The statements went to the sink: the program returned is empty
+        delete parser_();
+    } catch (...) {
+        parseError_ = std::current_exception();
+    }
+    tokenCount_ = parser_.getTokens().size();
+    if (!parseError_) {
+        parser_.freeTokens();
+    }
+    statements_.push(nullptr);
+}
+
+/**
+ * @brief Appends the statements parsed so far to the program
+ * @return True if anything was read from the queue
+ */
+bool Pipeline::takeStatements() {
+    bool received = false;
+    Statement* stmt;
+    while (!parsed_ && statements_.tryPop(stmt)) {
+        received = true;
+        if (stmt) program_->addStatement(stmt);
+        else parsed_ = true;
+    }
+    return received;
+}
+
+/**
+ * @brief Writes the output held so far, after which the output goes straight to the file descriptor
+ *
+ * The buffer of the sink is flushed every time, since error() only flushes the sinks writing to
+ * a file descriptor.
+ */
+void Pipeline::release() {
+    if (streaming_) {
+        return;
+    }
+    output_->flush();
+    if (released_) {
+        return;
+    }
+    released_ = true;
+    writeAll(fd_, held_.data(), held_.size());
+    std::string().swap(held_);
+}
@@ -0,0 +1,125 @@
+#if !defined(PIPELINE_H)
+#define PIPELINE_H
+
+#include <exception>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lexer.h"
+#include "parser.h"
+#include "syntax.h"
+#include "output.h"
+#include "visitor.h"
+#include "queue.h"
+
+/**
+ * @file pipeline.h
+ * @brief Defines the concurrent pipeline of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Pipeline class, which lexes, parses and executes a
+ * program at the same time on three threads, running each top-level statement as soon as it
+ * has been parsed.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Capacity of the queue of the tokens between the lexer and the parser
+#define PIPELINE_TOKENS 4096
+// Capacity of the queue of the top-level statements between the parser and the executor
+#define PIPELINE_STATEMENTS 1024
+// Statements and loop iterations run by the executor between two readings of the parsed statements
+#define PIPELINE_SLICE 4096
+
+/**
+ * @class TokenQueue
+ * @brief Token source of the parser thread, filled by the lexer thread
+ *
+ * The lexer thread pushes nullptr after the EOF token or after its error; the error is stored
+ * before, so the parser raises it at the same position as a parser pulling from the Lexer.
+ */
+class TokenQueue : public TokenSource{
+    public:
+        // constructors
+        TokenQueue() : queue_(PIPELINE_TOKENS) {}
+        TokenQueue(TokenQueue const& q) = delete;
+
+        // destructor
+        ~TokenQueue() override = default;
+
+        // methods of the lexer thread
+        void push(Token* token) { queue_.push(token); }
+        void fail(std::exception_ptr error) { error_ = error; queue_.push(nullptr); }
+
+        // method of the parser thread
+        Token* next() override;
+
+    private:
+        SpscQueue<Token*> queue_;
+        std::exception_ptr error_; // error of the lexer (written before its nullptr is pushed)
+};
+
+/**
+ * @class Pipeline
+ * @brief Lexer, parser and executor of a program running concurrently
+ *
+ * The lexer thread pushes the tokens into a TokenQueue, the parser thread pulls them and pushes
+ * each complete top-level statement into a queue, and the calling thread appends the statements
+ * to the program and runs them with the Visitor as they arrive, in slices of PIPELINE_SLICE
+ * steps so that it keeps reading the queue while a long loop runs.
+ * Errors are reported as by a sequential run: a lexical or syntax error anywhere in the file
+ * wins over a runtime error, and the output of the program is held until the whole file has
+ * been parsed, so nothing is printed before a syntax error. In streaming mode the output is
+ * written as it is produced, and the statements before a syntax error run before it is reported.
+ */
+class Pipeline{
+    public:
+        // constructors
+        Pipeline() = delete;
+        Pipeline(std::istream& input, int fd, FlushPolicy policy, bool streaming);
+        Pipeline(Pipeline const& p) = delete;
+
+        // destructor
+        ~Pipeline();
+
+        // overload () operator to run the program with a visitor on the program and output of the pipeline
+        void operator()(Visitor& visitor);
+
+        // methods to access the program (it grows while it runs), its output and its tokens
+        Program* getProgram() { return program_; }
+        OutputSink& getOutput() { return *output_; }
+        std::vector<Token*> const& getTokens() const { return parser_.getTokens(); } // freed once the whole file is parsed
+        size_t getTokenCount() const { return tokenCount_; }                         // tokens of the file (once it ran)
+
+    private:
+        // methods of the threads
+        void lex();
+        void parse();
+        // methods of the executor
+        bool takeStatements();
+        void release();
+
+        Lexer lexer_;
+        TokenQueue tokens_;
+        Parser parser_;
+        SpscQueue<Statement*> statements_{PIPELINE_STATEMENTS}; // nullptr marks the end of the parse
+        std::exception_ptr parseError_; // error of the lexer or of the parser (written before the nullptr)
+        size_t tokenCount_{0};           // tokens parsed (written before the nullptr)
+        bool parsed_{false};             // the executor received the end of the parse
+        Program* program_;               // statements received so far (owned by the caller)
+
+        // output held until the end of the parse (unless streaming)
+        int fd_;
+        bool streaming_;
+        bool released_{false};
+        std::string held_;
+        std::unique_ptr<OutputSink> output_;
+
+        std::thread lexerThread_;
+        std::thread parserThread_;
+};
+
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file profiler.cpp
+ * @brief Implements the statement profiler of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the Profiler class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <unordered_map>
+#include "profiler.h"
+
+/**
+ * @brief Constructs a profiler and starts its clock
+ */
+Profiler::Profiler() : root_{nullptr, nullptr, 1, 0, 0, {}}, startNs_(now()) {
+    open_.push_back(OpenStatement{&root_, startNs_, 0});
+}
+
+/**
+ * @brief Deletes the tree of the profile
+ */
+Profiler::~Profiler() {
+    deleteNode(&root_);
+}
+
+/**
+ * @brief Records the start of a statement
+ * @param stmt The statement
+ */
+void Profiler::enter(Statement* stmt) {
+    ProfileNode* parent = open_.back().node;
+    // Compound statements have few children, a linear search from the most recent one is enough
+    ProfileNode* node = nullptr;
+    for (auto it = parent->children.rbegin(); it != parent->children.rend(); ++it) {
+        if ((*it)->stmt == stmt) {
+            node = *it;
+            break;
+        }
+    }
+    if (!node) {
+        node = new ProfileNode{stmt, parent, 0, 0, 0, {}};
+        parent->children.push_back(node);
+    }
+    node->count++;
+    open_.push_back(OpenStatement{node, now(), 0});
+}
+
+/**
+ * @brief Records the end of the innermost statement being executed
+ */
+void Profiler::exit() {
+    uint64_t elapsed = now() - open_.back().startNs;
+    OpenStatement closed = open_.back();
+    open_.pop_back();
+    closed.node->inclusiveNs += elapsed;
+    closed.node->exclusiveNs += elapsed - std::min(elapsed, closed.childNs);
+    open_.back().childNs += elapsed;
+}
+
+/**
+ * @brief Ends the statements still open (after an error) and the program
+ */
+void Profiler::finish() {
+    while (open_.size() > 1) {
+        exit();
+    }
+    if (open_.size() == 1) {
+        totalNs_ = now() - startNs_;
+        root_.inclusiveNs = totalNs_;
+        root_.exclusiveNs = totalNs_ - std::min(totalNs_, open_.back().childNs);
+        open_.pop_back();
+    }
+}
+
+/**
+ * @brief Writes the statements sorted by exclusive time
+ * @param out The output stream
+ */
+void Profiler::writeReport(std::ostream& out) const {
+    // Sum the nodes of every statement (without functions a statement is reached by a single
+    // path, so this only flattens the tree)
+    std::unordered_map<Statement*, ProfileNode> totals;
+    std::vector<const ProfileNode*> stack(root_.children.begin(), root_.children.end());
+    uint64_t executed = 0;
+    while (!stack.empty()) {
+        const ProfileNode* node = stack.back();
+        stack.pop_back();
+        ProfileNode& total = totals.emplace(node->stmt, ProfileNode{node->stmt, nullptr, 0, 0, 0, {}}).first->second;
+        total.count += node->count;
+        total.inclusiveNs += node->inclusiveNs;
+        total.exclusiveNs += node->exclusiveNs;
+        executed += node->count;
+        stack.insert(stack.end(), node->children.begin(), node->children.end());
+    }
+    std::vector<ProfileNode*> sorted;
+    for (auto& entry : totals) {
+        sorted.push_back(&entry.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ProfileNode* a, const ProfileNode* b) {
+        if (a->exclusiveNs != b->exclusiveNs) return a->exclusiveNs > b->exclusiveNs;
+        return getSourceLine(a->stmt) < getSourceLine(b->stmt);
+    });
+
+    out << "Profile: " << std::fixed << std::setprecision(3) << totalNs_ / 1e6 << " ms, "
+        << executed << " statements executed" << std::endl;
+    out << std::setw(8) << "line" << std::setw(12) << "statement" << std::setw(14) << "count"
+        << std::setw(14) << "incl ms" << std::setw(14) << "excl ms" << std::setw(9) << "excl %" << std::endl;
+    for (const ProfileNode* node : sorted) {
+        std::string name = getFrameName(node->stmt);
+        out << std::setw(8) << getSourceLine(node->stmt) << std::setw(12) << name.substr(0, name.find(':'))
+            << std::setw(14) << node->count
+            << std::setw(14) << node->inclusiveNs / 1e6 << std::setw(14) << node->exclusiveNs / 1e6
+            << std::setw(8) << std::setprecision(1) << (totalNs_ ? 100.0 * node->exclusiveNs / totalNs_ : 0.0) << "%"
+            << std::setprecision(3) << std::endl;
+    }
+}
+
+/**
+ * @brief Writes the exclusive time of every path of statements as folded stacks
+ *
+ * Each line is a path of frames separated by ';' followed by its exclusive time in
+ * microseconds, the input format of flamegraph.pl.
+ * @param out The output stream
+ */
+void Profiler::writeFolded(std::ostream& out) const {
+    // Depth-first walk keeping the names of the frames of the current path
+    std::vector<std::pair<const ProfileNode*, size_t>> stack{{&root_, 0}};
+    std::vector<std::string> path;
+    while (!stack.empty()) {
+        const ProfileNode* node = stack.back().first;
+        size_t depth = stack.back().second;
+        stack.pop_back();
+        path.resize(depth);
+        path.push_back(node->stmt ? getFrameName(node->stmt) : "program");
+        uint64_t us = node->exclusiveNs / 1000;
+        if (us > 0) {
+            for (size_t i = 0; i < path.size(); i++) {
+                out << (i ? ";" : "") << path[i];
+            }
+            out << " " << us << "\n";
+        }
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+            stack.push_back({*it, depth + 1});
+        }
+    }
+    out.flush();
+}
+
+/**
+ * @brief Returns the line where a statement starts
+ *
+ * The position of a statement is the newline token that ends it, so the line is taken from
+ * its first child (location, identifier or expression) when it has one.
+ * @param stmt The statement
+ * @return The line of the statement
+ */
+int Profiler::getSourceLine(Statement* stmt) {
+    switch (stmt->getStatementType()) {
+        case ASSIGNMENT_STMT:
+            return static_cast<AssignmentStatement*>(stmt)->getLocation()->getLine();
+        case LIST_DECL_STMT:
+            return static_cast<ListDeclarationStatement*>(stmt)->getIdLine();
+        case LIST_APP_STMT:
+            return static_cast<ListAppendStatement*>(stmt)->getIdLine();
+        case PRINT_STMT:
+            return static_cast<PrintStatement*>(stmt)->getExpression()->getLine();
+        case IF_STMT:
+        case WHILE_STMT:
+            return static_cast<CompoundStatement*>(stmt)->getExpression()->getLine();
+        default:
+            // break and continue: the newline token is at the start of the next line
+            return stmt->getColumn() == 0 && stmt->getLine() > 1 ? stmt->getLine() - 1 : stmt->getLine();
+    }
+}
+
+/**
+ * @brief Returns the name of the frame of a statement: its kind and its line
+ * @param stmt The statement
+ * @return The name of the frame, e.g. "while:3"
+ */
+std::string Profiler::getFrameName(Statement* stmt) {
+    const char* kind;
+    switch (stmt->getStatementType()) {
+        case ASSIGNMENT_STMT: kind = "assign"; break;
+        case LIST_DECL_STMT: kind = "list"; break;
+        case LIST_APP_STMT: kind = "append"; break;
+        case PRINT_STMT: kind = "print"; break;
+        case BREAK_STMT: kind = "break"; break;
+        case CONTINUE_STMT: kind = "continue"; break;
+        case IF_STMT: kind = "if"; break;
+        case WHILE_STMT: kind = "while"; break;
+        default: kind = "statement"; break;
+    }
+    return std::string(kind) + ":" + std::to_string(getSourceLine(stmt));
+}
+
+/**
+ * @brief Returns the time of a monotonic clock
+ * @return The time in nanoseconds
+ */
+uint64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Deletes the descendants of a node
+ * @param node The node (not deleted itself)
+ */
+void Profiler::deleteNode(ProfileNode* node) {
+    std::vector<ProfileNode*> stack(node->children.begin(), node->children.end());
+    while (!stack.empty()) {
+        ProfileNode* current = stack.back();
+        stack.pop_back();
+        stack.insert(stack.end(), current->children.begin(), current->children.end());
+        delete current;
+    }
+    node->children.clear();
+}
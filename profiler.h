@@ -0,0 +1,86 @@
+#if !defined(PROFILER_H)
+#define PROFILER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "syntax.h"
+
+/**
+ * @file profiler.h
+ * @brief Defines the statement profiler of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Profiler class, which counts the executions of
+ * every statement and measures its inclusive and exclusive time, following the nesting of the
+ * while and if blocks, and writes them as a text report and as folded stacks.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+/**
+ * @struct ProfileNode
+ * @brief One statement reached through one path of enclosing compound statements
+ */
+struct ProfileNode {
+    Statement* stmt;                   // null for the root (the program)
+    ProfileNode* parent;
+    uint64_t count;                    // executions
+    uint64_t inclusiveNs;              // time including the nested statements
+    uint64_t exclusiveNs;              // time excluding the nested statements
+    std::vector<ProfileNode*> children;
+};
+
+/**
+ * @struct OpenStatement
+ * @brief Statement being executed, on the stack of the profiler
+ */
+struct OpenStatement {
+    ProfileNode* node;
+    uint64_t startNs; // time of the start of the execution
+    uint64_t childNs; // time spent in the nested statements so far
+};
+
+/**
+ * @class Profiler
+ * @brief Per-statement execution profiler driven by the Visitor
+ *
+ * The Visitor calls enter() when a statement starts and exit() when it ends (for compound
+ * statements, when the selected block or the whole loop ends). The time of the conditions of
+ * if and while statements is exclusive time of the statement.
+ */
+class Profiler{
+    public:
+        // constructors
+        Profiler();
+        Profiler(Profiler const& p) = delete;
+
+        // destructor
+        ~Profiler();
+
+        // methods called by the Visitor
+        void enter(Statement* stmt);
+        void exit();
+        void finish();
+
+        // methods to write the results
+        void writeReport(std::ostream& out) const;
+        void writeFolded(std::ostream& out) const;
+
+        // methods to get the line where a statement starts and the name of its frame
+        static int getSourceLine(Statement* stmt);
+        static std::string getFrameName(Statement* stmt);
+
+    private:
+        static uint64_t now();
+        void deleteNode(ProfileNode* node);
+
+        ProfileNode root_;
+        std::vector<OpenStatement> open_;
+        uint64_t startNs_;
+        uint64_t totalNs_{0};
+};
+
+
+#endif
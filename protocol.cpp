@@ -0,0 +1,153 @@
+/**
+ * @file protocol.cpp
+ * @brief Implements the protocol between the interpreter server and its clients
+ *
+ * This file contains the functions to send and receive the requests and the frames described
+ * in protocol.h over a connected socket.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "protocol.h"
+
+/**
+ * @brief Reads exactly the given number of bytes
+ * @param fd The socket
+ * @param data The destination of the bytes
+ * @param size The number of bytes
+ * @return False if the connection was closed or broken before all the bytes were read
+ */
+bool readFully(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::read(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes exactly the given number of bytes
+ * @param fd The socket
+ * @param data The bytes to write
+ * @param size The number of bytes
+ * @return False if the connection was closed or broken before all the bytes were written
+ */
+bool writeFully(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        // MSG_NOSIGNAL: a closed peer is reported as an error instead of raising SIGPIPE
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes a 32-bit integer in big endian order
+ * @param out The destination (4 bytes)
+ * @param value The integer
+ */
+void putU32(char* out, uint32_t value) {
+    out[0] = static_cast<char>(value >> 24);
+    out[1] = static_cast<char>(value >> 16);
+    out[2] = static_cast<char>(value >> 8);
+    out[3] = static_cast<char>(value);
+}
+
+/**
+ * @brief Decodes a 32-bit integer in big endian order
+ * @param in The source (4 bytes)
+ * @return The integer
+ */
+uint32_t getU32(const char* in) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in);
+    return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+/**
+ * @brief Sends a request
+ * @param fd The socket
+ * @param source The source code to run
+ * @return False if the connection is broken or the source code is too large
+ */
+bool writeRequest(int fd, const std::string& source) {
+    if (source.size() > MAX_REQUEST_SIZE) return false;
+    char header[4];
+    putU32(header, static_cast<uint32_t>(source.size()));
+    return writeFully(fd, header, 4) && writeFully(fd, source.data(), source.size());
+}
+
+/**
+ * @brief Receives a request
+ * @param fd The socket
+ * @param source The received source code
+ * @return False if the connection was closed or the request is too large
+ */
+bool readRequest(int fd, std::string& source) {
+    char header[4];
+    if (!readFully(fd, header, 4)) return false;
+    uint32_t size = getU32(header);
+    if (size > MAX_REQUEST_SIZE) return false;
+    source.resize(size);
+    return readFully(fd, &source[0], size);
+}
+
+/**
+ * @brief Sends a frame
+ * @param fd The socket
+ * @param type The type of the frame
+ * @param data The payload
+ * @param size The size of the payload
+ * @return False if the connection is broken
+ */
+bool writeFrame(int fd, char type, const char* data, size_t size) {
+    char header[5];
+    header[0] = type;
+    putU32(header + 1, static_cast<uint32_t>(size));
+    return writeFully(fd, header, 5) && writeFully(fd, data, size);
+}
+
+/**
+ * @brief Receives a frame
+ * @param fd The socket
+ * @param type The type of the frame
+ * @param payload The payload of the frame
+ * @return False if the connection was closed
+ */
+bool readFrame(int fd, char& type, std::string& payload) {
+    char header[5];
+    if (!readFully(fd, header, 5)) return false;
+    type = header[0];
+    payload.resize(getU32(header + 1));
+    return readFully(fd, &payload[0], payload.size());
+}
+
+/**
+ * @brief Connects to the Unix domain socket of a server
+ * @param path The path of the socket
+ * @return The connected socket, -1 on failure
+ */
+int connectSocket(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) return -1;
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
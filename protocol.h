@@ -0,0 +1,56 @@
+#if !defined(PROTOCOL_H)
+#define PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file protocol.h
+ * @brief Defines the protocol between the interpreter server and its clients
+ *
+ * A client connected to the Unix domain socket of the server sends requests, each one made of
+ * the length of a source code (4 bytes, big endian) followed by the source code. For each request
+ * the server answers with a sequence of frames, each one made of a type (1 byte), the length of
+ * the payload (4 bytes, big endian) and the payload:
+ *   OUTPUT_FRAME  a chunk of the output of the print statements (zero or more frames)
+ *   ERROR_FRAME   the error code (4 bytes) followed by the message "Error: NAME [line:column] - ..."
+ *   EXIT_FRAME    the exit status of the script (4 bytes), always the last frame of the answer
+ * Requests on the same connection are answered in order.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Largest source code accepted by the server (bytes)
+#define MAX_REQUEST_SIZE (256u << 20)
+
+/**
+ * @enum FrameType
+ * @brief Types of the frames of an answer
+ */
+enum FrameType {
+    OUTPUT_FRAME = 'O',
+    ERROR_FRAME = 'E',
+    EXIT_FRAME = 'X'
+};
+
+// Methods to transfer whole buffers (false if the connection is closed or broken)
+bool readFully(int fd, char* data, size_t size);
+bool writeFully(int fd, const char* data, size_t size);
+
+// Methods to encode and decode 32-bit big endian integers
+void putU32(char* out, uint32_t value);
+uint32_t getU32(const char* in);
+
+// Methods to send and receive requests and frames
+bool writeRequest(int fd, const std::string& source);
+bool readRequest(int fd, std::string& source);
+bool writeFrame(int fd, char type, const char* data, size_t size);
+bool readFrame(int fd, char& type, std::string& payload);
+
+// Method to connect to the socket of a server (-1 on failure)
+int connectSocket(const std::string& path);
+
+
+#endif
@@ -0,0 +1,167 @@
+#if !defined(QUEUE_H)
+#define QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file queue.h
+ * @brief Defines the queue between the threads of the Python-Sublanguage interpreter
+ *
+ * This file contains the SpscQueue class template, a bounded lock-free queue with a single
+ * producer thread and a single consumer thread, used by the stages of the Pipeline.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Spins of a waiting thread before it yields the processor
+#define QUEUE_SPINS 64
+// Yields of a waiting thread before it blocks until the other thread wakes it
+#define QUEUE_YIELDS 16
+
+/**
+ * @class SpscQueue
+ * @brief Bounded single-producer single-consumer ring buffer
+ *
+ * The producer only writes tail_ and the consumer only writes head_, each with release
+ * semantics, so an element is visible to the consumer once its position is published. Each
+ * side keeps a copy of the index of the other one and only reads the shared index again when
+ * the copy says the queue is full (or empty), so the two threads rarely touch the same cache
+ * line. A full (or empty) queue makes the waiting side spin, then yield, then block on a
+ * condition variable; the other side only takes the mutex to wake it when a thread is blocked.
+ */
+template <typename T>
+class SpscQueue{
+    public:
+        // constructors
+        SpscQueue() = delete;
+        SpscQueue(size_t capacity) : buffer_(roundCapacity(capacity)), mask_(buffer_.size() - 1) {}
+        SpscQueue(SpscQueue const& q) = delete;
+
+        // destructor
+        ~SpscQueue() = default;
+
+        /**
+         * @brief Appends an element, waiting while the queue is full (producer only)
+         * @param value The element
+         */
+        void push(T value) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            for (size_t spins = 0; tail - cachedHead_ > mask_; spins++) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (tail - cachedHead_ > mask_) {
+                    wait(spins, [this, tail] { return tail - head_.load(std::memory_order_acquire) <= mask_; });
+                }
+            }
+            buffer_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            wake();
+        }
+
+        /**
+         * @brief Removes the oldest element if there is one (consumer only)
+         * @param value The element removed
+         * @return True if an element was removed, false if the queue was empty
+         */
+        bool tryPop(T& value) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_) return false;
+            }
+            value = buffer_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            wake();
+            return true;
+        }
+
+        /**
+         * @brief Waits until the queue holds an element (consumer only)
+         */
+        void waitForElement() {
+            size_t head = head_.load(std::memory_order_relaxed);
+            for (size_t spins = 0; head == cachedTail_; spins++) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_) {
+                    wait(spins, [this, head] { return head != tail_.load(std::memory_order_acquire); });
+                }
+            }
+        }
+
+        /**
+         * @brief Removes the oldest element, waiting while the queue is empty (consumer only)
+         * @return The element removed
+         */
+        T pop() {
+            T value;
+            while (!tryPop(value)) {
+                waitForElement();
+            }
+            return value;
+        }
+
+    private:
+        /**
+         * @brief Rounds a capacity up to a power of two, so positions wrap with a mask
+         * @param capacity The capacity requested
+         * @return The capacity of the buffer
+         */
+        static size_t roundCapacity(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) size <<= 1;
+            return size;
+        }
+
+        /**
+         * @brief Waits for the other thread: spins, then yields, then blocks until it is ready
+         * @param spins The number of times the thread has already waited
+         * @param ready Returns true once the other thread has moved its index
+         */
+        template <typename Ready>
+        void wait(size_t spins, Ready ready) {
+            if (spins < QUEUE_SPINS) return;
+            if (spins < QUEUE_SPINS + QUEUE_YIELDS) {
+                std::this_thread::yield();
+                return;
+            }
+            // the other thread either sees the sleeper after moving its index, or the index is seen here
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ready_.wait(lock, ready);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Wakes the other thread if it is blocked, after an index has moved
+         */
+        void wake() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+            // taking the mutex ensures the sleeper is waiting on the condition variable, not checking it
+            { std::lock_guard<std::mutex> lock(mutex_); }
+            ready_.notify_one();
+        }
+
+        std::vector<T> buffer_;
+        size_t mask_;
+
+        // the indexes only grow: the position of an element is its index masked
+        alignas(64) std::atomic<size_t> head_{0}; // next element to remove (written by the consumer)
+        size_t cachedTail_{0};                     // last value of tail_ read by the consumer
+        alignas(64) std::atomic<size_t> tail_{0}; // next free position (written by the producer)
+        size_t cachedHead_{0};                     // last value of head_ read by the producer
+
+        // blocking wait of a thread that spun for too long
+        alignas(64) std::atomic<int> sleepers_{0}; // threads blocked on ready_ (at most one)
+        std::mutex mutex_;
+        std::condition_variable ready_;
+};
+
+
+#endif
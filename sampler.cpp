@@ -0,0 +1,98 @@
+/**
+ * @file sampler.cpp
+ * @brief Implements the sampling profiler of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the Sampler class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <map>
+#include <vector>
+#include <sys/time.h>
+#include "sampler.h"
+#include "profiler.h"
+
+std::atomic<Statement*> Sampler::current_{nullptr};
+Statement** Sampler::samples_ = nullptr;
+std::atomic<size_t> Sampler::sampleCount_{0};
+long Sampler::intervalUs_ = SAMPLE_INTERVAL_US;
+
+/**
+ * @brief Records the statement being executed (SIGPROF handler)
+ * @param signal The signal number (unused)
+ */
+void Sampler::handler(int signal) {
+    (void)signal;
+    // Only lock-free atomics and a preallocated array: nothing here may allocate or lock
+    size_t index = sampleCount_.fetch_add(1, std::memory_order_relaxed);
+    if (index < SAMPLE_CAPACITY) {
+        samples_[index] = current_.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Installs the signal handler and starts the profiling timer
+ * @param intervalUs The interval between two samples (microseconds of CPU time)
+ * @return False if the timer or the handler could not be installed
+ */
+bool Sampler::start(long intervalUs) {
+    if (!samples_) {
+        samples_ = new Statement*[SAMPLE_CAPACITY];
+    }
+    intervalUs_ = std::max(1L, intervalUs);
+    struct sigaction action{};
+    action.sa_handler = &Sampler::handler;
+    sigemptyset(&action.sa_mask);
+    // SA_RESTART: the sampled program must not see interrupted system calls (e.g. writes to stdout)
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        return false;
+    }
+    itimerval timer{};
+    timer.it_interval.tv_sec = intervalUs_ / 1000000;
+    timer.it_interval.tv_usec = intervalUs_ % 1000000;
+    timer.it_value = timer.it_interval;
+    return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+/**
+ * @brief Stops the profiling timer (pending samples are still recorded safely)
+ */
+void Sampler::stop() {
+    itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    current_.store(nullptr, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes the histogram of the samples by source line, from the hottest line
+ * @param out The output stream
+ */
+void Sampler::writeHistogram(std::ostream& out) {
+    size_t taken = sampleCount_.load();
+    size_t kept = std::min<size_t>(taken, SAMPLE_CAPACITY);
+    std::map<int, size_t> lines; // line -> samples (line 0: outside the statements of the program)
+    for (size_t i = 0; i < kept; i++) {
+        lines[samples_[i] ? Profiler::getSourceLine(samples_[i]) : 0]++;
+    }
+    std::vector<std::pair<int, size_t>> sorted(lines.begin(), lines.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) {
+        return a.second > b.second;
+    });
+
+    out << "Samples: " << taken << " (requested every " << intervalUs_ << " us of CPU time, the kernel may round it to its tick)";
+    if (taken > kept) out << " (" << taken - kept << " dropped)";
+    out << std::endl;
+    out << std::setw(8) << "line" << std::setw(12) << "samples" << std::setw(9) << "%" << std::endl;
+    for (const auto& line : sorted) {
+        if (line.first == 0) out << std::setw(8) << "-";
+        else out << std::setw(8) << line.first;
+        out << std::setw(12) << line.second << std::setw(8) << std::fixed << std::setprecision(1)
+            << (kept ? 100.0 * line.second / kept : 0.0) << "%" << std::endl;
+    }
+}
@@ -0,0 +1,57 @@
+#if !defined(SAMPLER_H)
+#define SAMPLER_H
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include "syntax.h"
+
+/**
+ * @file sampler.h
+ * @brief Defines the sampling profiler of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Sampler class, which interrupts the process with
+ * SIGPROF at a fixed interval of CPU time and records the statement being executed, then writes
+ * a histogram of the samples by source line.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Default interval between two samples (microseconds of CPU time)
+#define SAMPLE_INTERVAL_US 1000
+
+// Largest number of samples kept (later samples are only counted as dropped)
+#define SAMPLE_CAPACITY (1 << 22)
+
+/**
+ * @class Sampler
+ * @brief Statistical profiler driven by setitimer(ITIMER_PROF)
+ *
+ * The Visitor publishes the statement it is executing in a lock-free atomic slot; the signal
+ * handler only reads the slot and stores it in a preallocated array, so it is async-signal-safe.
+ * There is one sampler per process, since the timer and the signal are per process.
+ */
+class Sampler{
+    public:
+        // constructors
+        Sampler() = delete;
+        Sampler(Sampler const& s) = delete;
+
+        // methods
+        static bool start(long intervalUs = SAMPLE_INTERVAL_US);
+        static void stop();
+        static std::atomic<Statement*>* getSlot() { return &current_; }
+        static void writeHistogram(std::ostream& out);
+
+    private:
+        static void handler(int signal);
+
+        static std::atomic<Statement*> current_;  // statement being executed (null outside the program)
+        static Statement** samples_;              // recorded statements
+        static std::atomic<size_t> sampleCount_;  // samples taken, including the dropped ones
+        static long intervalUs_;
+};
+
+
+#endif
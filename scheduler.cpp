@@ -0,0 +1,71 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implements the cooperative scheduler of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the Scheduler class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include "scheduler.h"
+#include "error.h"
+
+/**
+ * @brief Adds a program to the ready queue (nothing runs before run())
+ * @param program The handle of the compiled program
+ * @param options The run options (the output function receives the output of the task)
+ * @return The index of the task, to retrieve its result
+ */
+size_t Scheduler::spawn(const ProgramHandle& program, const RunOptions& options) {
+    Task task;
+    task.program = program;
+    if (!program || !program->getProgram()) {
+        task.result.diagnostics.push_back(Diagnostic::fromError(InternalError(0, 0, "Null program")));
+        task.done = true;
+    } else {
+        task.output.reset(new OutputSink(options.output ? options.output : [](const char*, size_t) {}, options.flushPolicy, TASK_OUTPUT_SIZE));
+        task.visitor.reset(new Visitor(program->getProgram(), *task.output));
+        task.visitor->setLimits(options.limits);
+        task.visitor->start();
+        ready_.push_back(tasks_.size());
+    }
+    tasks_.push_back(std::move(task));
+    return tasks_.size() - 1;
+}
+
+/**
+ * @brief Runs the slices of the ready tasks in turn until every task has ended
+ */
+void Scheduler::run() {
+    while (!ready_.empty()) {
+        size_t index = ready_.front();
+        ready_.pop_front();
+        if (!runSlice(tasks_[index])) {
+            ready_.push_back(index);
+        }
+    }
+}
+
+/**
+ * @brief Runs a task for one slice, releasing its Visitor, output sink and program when it ends
+ * @param task The task
+ * @return True if the task ended (successfully or with an error)
+ */
+bool Scheduler::runSlice(Task& task) {
+    try {
+        if (!task.visitor->resume(slice_)) {
+            return false;
+        }
+    } catch (const Error& e) {
+        task.result.diagnostics.push_back(Diagnostic::fromError(e));
+    } catch (const std::exception& e) {
+        task.result.diagnostics.push_back(Diagnostic::fromError(InternalError(0, 0, e.what())));
+    }
+    // the output written before an error is kept, as for run()
+    task.visitor.reset();
+    task.output.reset();
+    task.program.reset();
+    task.done = true;
+    return true;
+}
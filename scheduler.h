@@ -0,0 +1,78 @@
+#if !defined(SCHEDULER_H)
+#define SCHEDULER_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "interpreter.h"
+#include "visitor.h"
+#include "output.h"
+
+/**
+ * @file scheduler.h
+ * @brief Defines the cooperative scheduler of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Scheduler class, which interleaves the runs of
+ * many programs on a single thread, giving each one a time slice in turn.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Default number of statements and loop iterations run by a task before it yields
+#define SCHEDULER_SLICE 1000
+
+// Size of the output buffer of each task (smaller than the default, since tasks are many)
+#define TASK_OUTPUT_SIZE 1024
+
+/**
+ * @struct Task
+ * @brief One program run by the scheduler
+ *
+ * The Visitor, the output sink and the handle of the program only exist while the task is
+ * running, so a finished task only keeps its result (and its syntax tree is freed).
+ */
+struct Task {
+    ProgramHandle program;
+    std::unique_ptr<OutputSink> output;
+    std::unique_ptr<Visitor> visitor;
+    RunResult result;
+    bool done{false};
+};
+
+/**
+ * @class Scheduler
+ * @brief Round-robin scheduler of suspendable runs on the calling thread
+ *
+ * A task runs until it has executed its slice of statements and loop iterations, then it is
+ * suspended at the next back-edge of a loop or after the next print statement and moved to
+ * the back of the ready queue. The memory of a suspended task is its Symbol Table, its
+ * execution stacks (bounded by the nesting depth of the program) and its output buffer.
+ */
+class Scheduler{
+    public:
+        // constructors
+        Scheduler(uint64_t slice = SCHEDULER_SLICE) : slice_(slice) {}
+        Scheduler(Scheduler const& s) = delete;
+
+        // destructor
+        ~Scheduler() = default;
+
+        // methods
+        size_t spawn(const ProgramHandle& program, const RunOptions& options);
+        void run();
+        const RunResult& getResult(size_t task) const { return tasks_[task].result; }
+        size_t getTaskCount() const { return tasks_.size(); }
+
+    private:
+        // method to run one slice of a task, returns true if the task ended
+        bool runSlice(Task& task);
+
+        uint64_t slice_;
+        std::vector<Task> tasks_;
+        std::deque<size_t> ready_; // tasks waiting for their next slice, in order
+};
+
+
+#endif
@@ -51,11 +51,29 @@ void EvaluatedElement::setBoolValue(bool value) {
 }
 
 
+SymbolTable::~SymbolTable() {
+    // Delete the variables and the elements of the lists
+    for (auto& variable : intVariables_) {
+        delete variable.second;
+    }
+    for (auto& variable : boolVariables_) {
+        delete variable.second;
+    }
+    for (auto& list : lists_) {
+        for (auto element : list.second) {
+            delete element;
+        }
+    }
+}
+
 bool SymbolTable::isVariableDefined(const std::string& id) {
     // Compare the id with the keys of both maps and return true if found (if find() does not return end())
-    return 
-    (intVariables_.find(id) != intVariables_.end()) || 
-    (boolVariables_.find(id) != boolVariables_.end());
+    lookups_++;
+    if (intVariables_.find(id) != intVariables_.end()) {
+        return true;
+    }
+    lookups_++;
+    return boolVariables_.find(id) != boolVariables_.end();
 }
 
 void SymbolTable::addVariable(const std::string& id, int element) {
@@ -65,7 +83,9 @@ void SymbolTable::addVariable(const std::string& id, int element) {
     }
     // Create a new int and add it to the map
     int* newInt = new int(element);
+    lookups_++;
     intVariables_[id] = newInt;
+    memory_ += VARIABLE_MEMORY + id.size();
 }
 
 void SymbolTable::addVariable(const std::string& id, bool element) {
@@ -75,19 +95,28 @@ void SymbolTable::addVariable(const std::string& id, bool element) {
     }
     // Create a new bool and add it to the map
     bool* newBool = new bool(element);
+    lookups_++;
     boolVariables_[id] = newBool;
+    memory_ += VARIABLE_MEMORY + id.size();
 }
 
 void SymbolTable::updateVariable(const std::string& id, int element) {
-    // Check if the variable is already defined
-    if (intVariables_.find(id) != intVariables_.end()) {
+    // Check if the variable is already defined (a single lookup in each map)
+    lookups_++;
+    auto intVariable = intVariables_.find(id);
+    if (intVariable != intVariables_.end()) {
         // if it is an int, update its value
-        *(intVariables_[id]) = element;
-    } else if (boolVariables_.find(id) != boolVariables_.end()) {
+        *(intVariable->second) = element;
+        return;
+    }
+    lookups_++;
+    auto boolVariable = boolVariables_.find(id);
+    if (boolVariable != boolVariables_.end()) {
         // if it is a bool, delete it and define it as int
-        delete boolVariables_[id];
-        boolVariables_.erase(id);
+        delete boolVariable->second;
+        boolVariables_.erase(boolVariable);
         int* newInt = new int(element);
+        lookups_++;
         intVariables_[id] = newInt;
     } else {
         throw InternalError(0, 0, "Variable " + id + " is not defined");
@@ -95,15 +124,22 @@ void SymbolTable::updateVariable(const std::string& id, int element) {
 }
 
 void SymbolTable::updateVariable(const std::string& id, bool element) {
-    // Check if the variable is already defined
-    if (boolVariables_.find(id) != boolVariables_.end()) {
+    // Check if the variable is already defined (a single lookup in each map)
+    lookups_++;
+    auto boolVariable = boolVariables_.find(id);
+    if (boolVariable != boolVariables_.end()) {
         // if it is a bool, update its value
-        *(boolVariables_[id]) = element;
-    } else if (intVariables_.find(id) != intVariables_.end()) {
+        *(boolVariable->second) = element;
+        return;
+    }
+    lookups_++;
+    auto intVariable = intVariables_.find(id);
+    if (intVariable != intVariables_.end()) {
         // if it is an int, delete it and define it as bool
-        delete intVariables_[id];
-        intVariables_.erase(id);
+        delete intVariable->second;
+        intVariables_.erase(intVariable);
         bool* newBool = new bool(element);
+        lookups_++;
         boolVariables_[id] = newBool;
     } else {
         throw InternalError(0, 0, "Variable " + id + " is not defined");
@@ -111,10 +147,15 @@ void SymbolTable::updateVariable(const std::string& id, bool element) {
 }
 
 EvaluatedElement SymbolTable::getVariableValue(const std::string& id) const {
-    if (intVariables_.find(id) != intVariables_.end()) {
-        return EvaluatedElement(*(intVariables_.at(id)));
-    } else if (boolVariables_.find(id) != boolVariables_.end()) {
-        return EvaluatedElement(*(boolVariables_.at(id)));
+    lookups_++;
+    auto intVariable = intVariables_.find(id);
+    if (intVariable != intVariables_.end()) {
+        return EvaluatedElement(*(intVariable->second));
+    }
+    lookups_++;
+    auto boolVariable = boolVariables_.find(id);
+    if (boolVariable != boolVariables_.end()) {
+        return EvaluatedElement(*(boolVariable->second));
     } else {
         throw InternalError(0, 0, "Variable " + id + " is not defined");
         return EvaluatedElement(0); // to avoid compiler warning, will never be reached
@@ -123,6 +164,7 @@ EvaluatedElement SymbolTable::getVariableValue(const std::string& id) const {
 
 bool SymbolTable::isListDefined(const std::string& id) const {
     // Compare the id with the keys of the lists map and return true if found (if find() does not return end())
+    lookups_++;
     return lists_.find(id) != lists_.end();
 }
 
@@ -133,65 +175,89 @@ void SymbolTable::addList(const std::string& id) {
     }
     // Create a new vector of EvaluatedElement pointers and add it to the map
     std::vector<EvaluatedElement*> newList;
+    lookups_++;
     lists_[id] = newList;
+    memory_ += LIST_MEMORY + id.size();
 }
 
 void SymbolTable::appendToList(const std::string& id, EvaluatedElement element) {
     // Check if the list is defined
-    if(!isListDefined(id)) {
+    lookups_++;
+    auto list = lists_.find(id);
+    if(list == lists_.end()) {
         throw InternalError(0, 0, "List " + id + " is not defined");
     }
     // Create a new EvaluatedElement and append it to the list
     EvaluatedElement* newElement = new EvaluatedElement(element);
-    lists_[id].push_back(newElement);
+    list->second.push_back(newElement);
+    elementAccesses_++;
+    memory_ += LIST_ELEMENT_MEMORY;
 }
 
 void SymbolTable::updateListElement(const std::string& id, int index, EvaluatedElement element) {
     // Check if the list is defined
-    if(!isListDefined(id)) {
+    lookups_++;
+    auto list = lists_.find(id);
+    if(list == lists_.end()) {
         throw InternalError(0, 0, "List " + id + " is not defined");
     }
     // Check if the index is within bounds
-    if(index < 0 || index >= lists_[id].size()) {
+    if(index < 0 || index >= list->second.size()) {
         throw InternalError(0, 0, "List index out of range");
     }
     // Update the element at the specified index
-    *(lists_[id][index]) = element;
+    *(list->second[index]) = element;
+    elementAccesses_++;
 }
 
 EvaluatedElement SymbolTable::getListElement(const std::string& id, int index) const {
     // Check if the list is defined
-    if(!isListDefined(id)) {
+    lookups_++;
+    auto list = lists_.find(id);
+    if(list == lists_.end()) {
         throw InternalError(0, 0, "List " + id + " is not defined");
     }
     // Check if the index is within bounds
-    if(index < 0 || index >= lists_.at(id).size()) {
+    if(index < 0 || index >= list->second.size()) {
         throw InternalError(0, 0, "List index out of range");
     }
     // Return the element at the specified index
-    return *(lists_.at(id)[index]);
+    elementAccesses_++;
+    return *(list->second[index]);
+}
+
+size_t SymbolTable::getListElementCount() const {
+    // Sum the sizes of all the lists
+    size_t count = 0;
+    for (const auto& list : lists_) {
+        count += list.second.size();
+    }
+    return count;
 }
 
 int SymbolTable::getListSize(const std::string& id) {
     // Check if the list is defined
-    if(!isListDefined(id)) {
+    lookups_++;
+    auto list = lists_.find(id);
+    if(list == lists_.end()) {
         throw InternalError(0, 0, "List " + id + " is not defined");
     }
     // Return the size of the list
-    return lists_.at(id).size();
+    return list->second.size();
 }
 
 void SymbolTable::clear(const std::string& id) {
     // Check if the list is defined
-    if(!isListDefined(id)) {
+    lookups_++;
+    auto list = lists_.find(id);
+    if(list == lists_.end()) {
         throw InternalError(0, 0, "List " + id + " is not defined");
     }
     // Delete each element in the vector
-    for(auto element : lists_.at(id)) {
+    for(auto element : list->second) {
         delete element;
     }
-    // Clear the vector
-    lists_[id].clear();
+    memory_ -= LIST_MEMORY + id.size() + list->second.size() * LIST_ELEMENT_MEMORY;
     // Remove the list from the map
-    lists_.erase(id);
+    lists_.erase(list);
 }
\ No newline at end of file
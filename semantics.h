@@ -1,8 +1,10 @@
 #if !defined(SEMANTICS_H)
 #define SEMANTICS_H
 
-#include <map>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "syntax.h"
 #include "error.h"
 #include "types.h"
@@ -47,17 +49,27 @@ class EvaluatedElement{
         bool boolValue_; // Boolean value (if type is TYPE_BOOL)
 };
 
+// Estimated bytes taken by a variable, a list and a list element (besides the identifiers)
+#define VARIABLE_MEMORY 64
+#define LIST_MEMORY 96
+#define LIST_ELEMENT_MEMORY (sizeof(EvaluatedElement) + sizeof(EvaluatedElement*) + 16)
+
 /**
  * @class SymbolTable
  * @brief Represents a symbol table for semantic analysis
+ *
+ * The table keeps an estimate of the memory taken by its variables and lists, used to
+ * enforce the memory limit of a run. Identifiers are hashed, so the cost of a lookup does not
+ * grow with the number of symbols.
  */
 class SymbolTable {
     public:
         // Constructors
         SymbolTable() = default;
+        SymbolTable(SymbolTable const& st) = delete;
 
         // Destructor
-        ~SymbolTable() = default;
+        ~SymbolTable(); // defined in semantics.cpp (deletes the variables and the list elements)
 
         // Methods for variable management
         bool isVariableDefined(const std::string& id);
@@ -76,16 +88,36 @@ class SymbolTable {
         int getListSize(const std::string& id);
         void clear(const std::string& id);
 
+        // Method to get the estimated memory of the variables and lists (bytes)
+        size_t getMemoryUsage() const { return memory_; }
+
+        // Methods to get the size of the table
+        size_t getIntVariableCount() const { return intVariables_.size(); }
+        size_t getBoolVariableCount() const { return boolVariables_.size(); }
+        size_t getListCount() const { return lists_.size(); }
+        size_t getListElementCount() const;
+
+        // Methods to get the work done by the table (see OperationCounts)
+        uint64_t getLookupCount() const { return lookups_; }
+        uint64_t getElementAccessCount() const { return elementAccesses_; }
+
 
     private:
         // Int Variables => pointer to int
-        std::map<std::string, int*> intVariables_;
+        std::unordered_map<std::string, int*> intVariables_;
 
         // Bool Variables => pointer to bool
-        std::map<std::string, bool*> boolVariables_;
+        std::unordered_map<std::string, bool*> boolVariables_;
 
         // Lists => vector of pointers to EvaluatedElement
-        std::map<std::string, std::vector<EvaluatedElement*>> lists_;
+        std::unordered_map<std::string, std::vector<EvaluatedElement*>> lists_;
+
+        // Estimated memory of the variables and lists
+        size_t memory_{0};
+
+        // Searches of the maps and accesses to list elements, counted by the const methods as well
+        mutable uint64_t lookups_{0};
+        mutable uint64_t elementAccesses_{0};
 };
 
 
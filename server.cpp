@@ -0,0 +1,126 @@
+/**
+ * @file server.cpp
+ * @brief Implements the server mode of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the Server class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "server.h"
+#include "protocol.h"
+#include "cache.h"
+#include "error.h"
+
+/**
+ * @brief Listens on the socket and serves every connection on its own thread
+ */
+void Server::operator()() {
+    sockaddr_un address{};
+    if (path_.size() >= sizeof(address.sun_path)) {
+        throw FileOpenError(0, 0, "Socket path too long: " + path_);
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path_.c_str(), path_.size() + 1);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw FileOpenError(0, 0, "Could not create socket: " + std::string(strerror(errno)));
+    }
+    // a socket file left by a previous server would make bind() fail
+    unlink(path_.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        close(listener);
+        throw FileOpenError(0, 0, "Could not listen on " + path_ + ": " + strerror(errno));
+    }
+
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EMFILE || errno == ENFILE) continue;
+            close(listener);
+            throw FileOpenError(0, 0, "Could not accept connections: " + std::string(strerror(errno)));
+        }
+        std::thread(&Server::serve, this, fd).detach();
+    }
+}
+
+/**
+ * @brief Answers the requests of a connection until the client closes it
+ * @param fd The connected socket
+ */
+void Server::serve(int fd) {
+    std::string source;
+    while (readRequest(fd, source) && answer(fd, source)) {}
+    close(fd);
+}
+
+/**
+ * @brief Compiles (or finds in the cache) and runs a script, streaming its output to the client
+ * @param fd The connected socket
+ * @param source The source code of the script
+ * @return False if the connection is broken
+ */
+bool Server::answer(int fd, const std::string& source) {
+    std::vector<Diagnostic> diagnostics;
+    ProgramHandle program = getProgram(source, diagnostics);
+    bool connected = true;
+    if (program) {
+        RunOptions options;
+        options.limits = limits_;
+        // the output is sent in chunks of the size of the output buffer (once the client is gone it is dropped)
+        options.output = [fd, &connected](const char* data, size_t size) {
+            connected = connected && writeFrame(fd, OUTPUT_FRAME, data, size);
+        };
+        diagnostics = run(program, options).diagnostics;
+    }
+    if (!connected) return false;
+
+    char status[4];
+    if (!diagnostics.empty()) {
+        std::string payload(4, '\0');
+        putU32(&payload[0], static_cast<uint32_t>(diagnostics.front().errorCode));
+        payload += diagnostics.front().toString();
+        if (!writeFrame(fd, ERROR_FRAME, payload.data(), payload.size())) return false;
+    }
+    putU32(status, diagnostics.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+    return writeFrame(fd, EXIT_FRAME, status, 4);
+}
+
+/**
+ * @brief Returns the compiled program of a source code, compiling it on a cache miss
+ * @param source The source code
+ * @param diagnostics The diagnostic of the compilation error, if any
+ * @return The compiled program, null if the compilation failed
+ */
+ProgramHandle Server::getProgram(const std::string& source, std::vector<Diagnostic>& diagnostics) {
+    uint64_t key = ProgramCache::getKey(source);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end() && it->second.first == source) {
+            return it->second.second;
+        }
+    }
+
+    // compile outside the lock, so other requests are not blocked (errors are not cached, compile() frees the partial tree)
+    CompileResult compiled = compile(source, options_);
+    if (!compiled.ok()) {
+        diagnostics = std::move(compiled.diagnostics);
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cache_.size() >= SERVER_CACHE_SIZE && cache_.find(key) == cache_.end()) {
+        // evict an arbitrary program: runs in progress keep their own handle, and the tree is freed with the last one
+        cache_.erase(cache_.begin());
+    }
+    cache_[key] = std::make_pair(source, compiled.program);
+    return compiled.program;
+}
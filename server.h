@@ -0,0 +1,61 @@
+#if !defined(SERVER_H)
+#define SERVER_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "interpreter.h"
+
+/**
+ * @file server.h
+ * @brief Defines the server mode of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Server class, which listens on a Unix domain
+ * socket and runs the scripts sent by its clients with the protocol of protocol.h.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Largest number of compiled programs kept by the server
+#define SERVER_CACHE_SIZE 1024
+
+/**
+ * @class Server
+ * @brief Long-running interpreter serving the requests of local clients
+ *
+ * Every connection is served by its own thread, so requests of different clients run
+ * concurrently. Compiled programs are kept in memory, keyed by the hash of their source code,
+ * and shared by all the connections.
+ */
+class Server{
+    public:
+        // constructors
+        Server() = delete;
+        Server(std::string path, CompileOptions options, ExecutionLimits limits) : path_(std::move(path)), options_(options), limits_(limits) {}
+        Server(Server const& s) = delete;
+
+        // destructor
+        ~Server() = default;
+
+        // overload () operator to serve the clients (throws a FileOpenError if the socket cannot be used)
+        void operator()();
+
+    private:
+        // methods to serve a connection and its requests
+        void serve(int fd);
+        bool answer(int fd, const std::string& source);
+        ProgramHandle getProgram(const std::string& source, std::vector<Diagnostic>& diagnostics);
+
+        std::string path_;
+        CompileOptions options_;
+        ExecutionLimits limits_; // limits of every request
+
+        // compiled programs: hash of the source -> source and program (the source resolves collisions)
+        std::mutex cacheMutex_;
+        std::unordered_map<uint64_t, std::pair<std::string, ProgramHandle>> cache_;
+};
+
+
+#endif
@@ -0,0 +1,291 @@
+/**
+ * @file stats.cpp
+ * @brief Implements the statistics report of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the Stats class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sys/resource.h>
+#include "stats.h"
+
+// Classes of the nodes of the Syntax Tree, in the order of the report
+enum NodeClass {
+    ASSIGNMENT_NODE,
+    LIST_DECL_NODE,
+    LIST_APP_NODE,
+    BREAK_NODE,
+    CONTINUE_NODE,
+    PRINT_NODE,
+    COMPOUND_NODE,
+    SIMPLE_BLOCK_NODE,
+    ELIF_BLOCK_NODE,
+    ELSE_BLOCK_NODE,
+    BINARY_NODE,
+    NARY_NODE,
+    UNARY_NODE,
+    LITERAL_NODE,
+    ID_LOCATION_NODE,
+    LIST_ELEMENT_LOCATION_NODE,
+    NODE_CLASSES
+};
+
+static const char* const NodeClassName[NODE_CLASSES] = {
+    "AssignmentStatement",
+    "ListDeclarationStatement",
+    "ListAppendStatement",
+    "BreakStatement",
+    "ContinueStatement",
+    "PrintStatement",
+    "CompoundStatement",
+    "SimpleBlock",
+    "ElifBlock",
+    "ElseBlock",
+    "Binary",
+    "Nary",
+    "Unary",
+    "Literal",
+    "IdLocation",
+    "ListElementLocation"
+};
+
+/**
+ * @brief Begins a phase, ending the previous one
+ * @param phase The name of the phase
+ */
+void Stats::begin(const std::string& phase) {
+    end();
+    PhaseStats stats;
+    stats.name = phase;
+    // The counters are kept in the phase until it ends, then replaced by their differences
+    stats.wallNs = wallNow();
+    stats.cpuNs = cpuNow();
+    stats.allocations = threadAllocations_;
+    stats.allocatedBytes = threadAllocatedBytes_;
+    phases_.push_back(stats);
+    open_ = true;
+}
+
+/**
+ * @brief Ends the phase being measured, if any
+ */
+void Stats::end() {
+    if (!open_) {
+        return;
+    }
+    open_ = false;
+    PhaseStats& stats = phases_.back();
+    stats.wallNs = wallNow() - stats.wallNs;
+    stats.cpuNs = cpuNow() - stats.cpuNs;
+    stats.allocations = threadAllocations_ - stats.allocations;
+    stats.allocatedBytes = threadAllocatedBytes_ - stats.allocatedBytes;
+    stats.peakRssKb = peakRss();
+}
+
+/**
+ * @brief Counts the nodes of the Syntax Tree by class
+ *
+ * The bodies of lazy blocks that were never executed are not parsed, so they are counted
+ * apart and their nodes are not.
+ * @param program The Syntax Tree
+ */
+void Stats::countNodes(Program* program) {
+    size_t counts[NODE_CLASSES] = {};
+    lazyBlocks_ = 0;
+    // Explicit stack of statements, blocks and expressions (the tree can be very deep)
+    std::vector<Statement*> statements(program->getStatements().begin(), program->getStatements().end());
+    std::vector<Block*> blocks;
+    std::vector<Expression*> expressions;
+    while (!statements.empty() || !blocks.empty() || !expressions.empty()) {
+        if (!expressions.empty()) {
+            Expression* expr = expressions.back();
+            expressions.pop_back();
+            switch (expr->getExprType()) {
+                case ExpressionType::BINARY_EXPR:
+                    counts[BINARY_NODE]++;
+                    expressions.push_back(static_cast<Binary*>(expr)->getLeft());
+                    expressions.push_back(static_cast<Binary*>(expr)->getRight());
+                    break;
+                case ExpressionType::NARY_EXPR:
+                    counts[NARY_NODE]++;
+                    for (auto operand : static_cast<Nary*>(expr)->getOperands()) {
+                        expressions.push_back(operand);
+                    }
+                    break;
+                case ExpressionType::UNARY_EXPR:
+                    counts[UNARY_NODE]++;
+                    expressions.push_back(static_cast<Unary*>(expr)->getOperand());
+                    break;
+                case ExpressionType::LITERAL_EXPR:
+                    counts[LITERAL_NODE]++;
+                    break;
+                case ExpressionType::LOAD_EXPR:
+                    if (static_cast<Location*>(expr)->getLocationType() == LocationType::LIST_ELEM) {
+                        counts[LIST_ELEMENT_LOCATION_NODE]++;
+                        expressions.push_back(static_cast<ListElementLocation*>(expr)->getIndex());
+                    } else {
+                        counts[ID_LOCATION_NODE]++;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if (!blocks.empty()) {
+            Block* block = blocks.back();
+            blocks.pop_back();
+            if (block->getBlockType() == BlockType::SIMPLE_BLOCK) {
+                SimpleBlock* sb = static_cast<SimpleBlock*>(block);
+                counts[SIMPLE_BLOCK_NODE]++;
+                if (!sb->isParsed()) {
+                    lazyBlocks_++;
+                    continue;
+                }
+                statements.insert(statements.end(), sb->getStatements().begin(), sb->getStatements().end());
+            } else if (block->getBlockType() == BlockType::ELIF_BLOCK) {
+                counts[ELIF_BLOCK_NODE]++;
+                expressions.push_back(static_cast<ElifBlock*>(block)->getCondition());
+                blocks.push_back(static_cast<ElifBlock*>(block)->getBlock());
+            } else if (block->getBlockType() == BlockType::ELSE_BLOCK) {
+                counts[ELSE_BLOCK_NODE]++;
+                blocks.push_back(static_cast<ElseBlock*>(block)->getBlock());
+            }
+        }
+        else {
+            Statement* stmt = statements.back();
+            statements.pop_back();
+            switch (stmt->getStatementType()) {
+                case ASSIGNMENT_STMT:
+                    counts[ASSIGNMENT_NODE]++;
+                    expressions.push_back(static_cast<AssignmentStatement*>(stmt)->getLocation());
+                    expressions.push_back(static_cast<AssignmentStatement*>(stmt)->getExpression());
+                    break;
+                case LIST_DECL_STMT:
+                    counts[LIST_DECL_NODE]++;
+                    break;
+                case LIST_APP_STMT:
+                    counts[LIST_APP_NODE]++;
+                    expressions.push_back(static_cast<ListAppendStatement*>(stmt)->getExpression());
+                    break;
+                case BREAK_STMT:
+                    counts[BREAK_NODE]++;
+                    break;
+                case CONTINUE_STMT:
+                    counts[CONTINUE_NODE]++;
+                    break;
+                case PRINT_STMT:
+                    counts[PRINT_NODE]++;
+                    expressions.push_back(static_cast<PrintStatement*>(stmt)->getExpression());
+                    break;
+                case IF_STMT:
+                case WHILE_STMT:
+                    counts[COMPOUND_NODE]++;
+                    expressions.push_back(static_cast<CompoundStatement*>(stmt)->getExpression());
+                    for (auto block : static_cast<CompoundStatement*>(stmt)->getBlocks()) {
+                        blocks.push_back(block);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    nodes_.clear();
+    for (int i = 0; i < NODE_CLASSES; i++) {
+        nodes_.push_back(NodeCount{NodeClassName[i], counts[i]});
+    }
+}
+
+/**
+ * @brief Records the contents of the symbol table at the end of the run
+ * @param table The symbol table
+ */
+void Stats::setSymbolTable(const SymbolTable& table) {
+    intVariables_ = table.getIntVariableCount();
+    boolVariables_ = table.getBoolVariableCount();
+    lists_ = table.getListCount();
+    listElements_ = table.getListElementCount();
+    memory_ = table.getMemoryUsage();
+}
+
+/**
+ * @brief Writes the report as text
+ * @param out The output stream
+ */
+void Stats::writeText(std::ostream& out) const {
+    out << std::fixed << std::setprecision(3);
+    out << std::left << std::setw(10) << "phase" << std::right << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms"
+        << std::setw(14) << "allocations" << std::setw(16) << "alloc bytes" << std::setw(14) << "peak rss kB" << std::endl;
+    for (const PhaseStats& phase : phases_) {
+        out << std::left << std::setw(10) << phase.name << std::right
+            << std::setw(12) << phase.wallNs / 1e6 << std::setw(12) << phase.cpuNs / 1e6
+            << std::setw(14) << phase.allocations << std::setw(16) << phase.allocatedBytes
+            << std::setw(14) << phase.peakRssKb << std::endl;
+    }
+    out << "tokens: " << tokens_ << std::endl;
+    out << "nodes:" << std::endl;
+    for (const NodeCount& node : nodes_) {
+        out << "  " << std::left << std::setw(26) << node.name << std::right << std::setw(10) << node.count << std::endl;
+    }
+    out << "  " << std::left << std::setw(26) << "(unparsed lazy blocks)" << std::right << std::setw(10) << lazyBlocks_ << std::endl;
+    out << "symbols: " << intVariables_ << " int variables, " << boolVariables_ << " bool variables, "
+        << lists_ << " lists, " << listElements_ << " list elements (about " << memory_ << " bytes)" << std::endl;
+    out << "peak rss: " << peakRss() << " kB" << std::endl;
+}
+
+/**
+ * @brief Writes the report as a JSON object
+ * @param out The output stream
+ */
+void Stats::writeJson(std::ostream& out) const {
+    out << std::fixed << std::setprecision(3);
+    out << "{\"phases\":[";
+    for (size_t i = 0; i < phases_.size(); i++) {
+        const PhaseStats& phase = phases_[i];
+        out << (i ? "," : "") << "{\"name\":\"" << phase.name << "\""
+            << ",\"wall_ms\":" << phase.wallNs / 1e6 << ",\"cpu_ms\":" << phase.cpuNs / 1e6
+            << ",\"allocations\":" << phase.allocations << ",\"allocated_bytes\":" << phase.allocatedBytes
+            << ",\"peak_rss_kb\":" << phase.peakRssKb << "}";
+    }
+    out << "],\"tokens\":" << tokens_ << ",\"nodes\":{";
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        out << (i ? "," : "") << "\"" << nodes_[i].name << "\":" << nodes_[i].count;
+    }
+    out << "},\"unparsed_lazy_blocks\":" << lazyBlocks_
+        << ",\"symbols\":{\"int_variables\":" << intVariables_ << ",\"bool_variables\":" << boolVariables_
+        << ",\"lists\":" << lists_ << ",\"list_elements\":" << listElements_ << ",\"estimated_bytes\":" << memory_ << "}"
+        << ",\"peak_rss_kb\":" << peakRss() << "}" << std::endl;
+}
+
+/**
+ * @brief Returns the time of a monotonic clock
+ * @return The time in nanoseconds
+ */
+uint64_t Stats::wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Returns the CPU time used by the process
+ * @return The time in nanoseconds
+ */
+uint64_t Stats::cpuNow() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the peak resident set size of the process
+ * @return The size in kilobytes
+ */
+long Stats::peakRss() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,106 @@
+#if !defined(STATS_H)
+#define STATS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "syntax.h"
+#include "semantics.h"
+
+/**
+ * @file stats.h
+ * @brief Defines the statistics report of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Stats class, which measures the wall time, CPU
+ * time, allocations and peak resident memory of each phase of a run, counts the tokens and the
+ * nodes of the Syntax Tree and the contents of the symbol table, and writes them as text or JSON.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+/**
+ * @struct PhaseStats
+ * @brief Resources used by one phase of the run
+ */
+struct PhaseStats {
+    std::string name;
+    uint64_t wallNs{0};         // elapsed wall time
+    uint64_t cpuNs{0};          // CPU time of the process
+    uint64_t allocations{0};    // calls to operator new on the calling thread
+    uint64_t allocatedBytes{0}; // bytes requested from operator new on the calling thread
+    long peakRssKb{0};          // peak resident set size at the end of the phase
+};
+
+/**
+ * @struct NodeCount
+ * @brief Number of nodes of one class of the Syntax Tree
+ */
+struct NodeCount {
+    const char* name; // name of the class
+    size_t count;
+};
+
+/**
+ * @class Stats
+ * @brief Statistics of a run, collected by main() around each phase
+ *
+ * Allocations are counted on the thread that runs the phases, by the replacement of the global
+ * operator new of the interpreter executable (main.cpp), which calls recordAllocation(); programs
+ * embedding the library without such a replacement see no allocations.
+ */
+class Stats{
+    public:
+        // constructors
+        Stats() = default;
+        Stats(Stats const& s) = delete;
+
+        // destructor
+        ~Stats() = default;
+
+        // methods to measure the phases (a phase ends when the next one begins)
+        void begin(const std::string& phase);
+        void end();
+
+        // methods to record the sizes of the run
+        void setTokenCount(size_t count) { tokens_ = count; }
+        void countNodes(Program* program);
+        void setSymbolTable(const SymbolTable& table);
+
+        // method called by the replacement of operator new
+        static void recordAllocation(size_t bytes) {
+            threadAllocations_++;
+            threadAllocatedBytes_ += bytes;
+        }
+
+        // methods to read the allocations of the calling thread so far
+        static uint64_t getThreadAllocations() { return threadAllocations_; }
+        static uint64_t getThreadAllocatedBytes() { return threadAllocatedBytes_; }
+
+        // methods to write the report
+        void writeText(std::ostream& out) const;
+        void writeJson(std::ostream& out) const;
+
+    private:
+        static uint64_t wallNow();
+        static uint64_t cpuNow();
+        static long peakRss();
+
+        static inline thread_local uint64_t threadAllocations_ = 0;
+        static inline thread_local uint64_t threadAllocatedBytes_ = 0;
+
+        std::vector<PhaseStats> phases_;
+        bool open_{false}; // the last phase is being measured
+        size_t tokens_{0};
+        std::vector<NodeCount> nodes_;
+        size_t lazyBlocks_{0}; // lazy blocks never executed, whose body was not parsed
+        size_t intVariables_{0};
+        size_t boolVariables_{0};
+        size_t lists_{0};
+        size_t listElements_{0};
+        size_t memory_{0}; // estimated bytes of the variables and lists
+};
+
+
+#endif
@@ -9,40 +9,118 @@
  */
 
 #include "syntax.h"
+#include "parser.h"
 #include "semantics.h"
 #include "error.h"
 #include <iostream>
 
 /**
- * @brief Constructs a Statement object
- * @param position The position of the statement in the token vector
- * @param type The type of the statement (StatementType enum)
- * @param tokens The reference to the token vector (for error reporting)
+ * @struct PendingNodes
+ * @brief Nodes of a Syntax Tree being deleted, detached from their parent
+ *
+ * A destructor does not delete the children of its node: it hands them over to this list and
+ * the outermost destructor deletes the nodes of the list in a loop, so deleting a tree takes
+ * constant stack space whatever its depth.
  */
-Statement::Statement(int position, StatementType type, std::vector<Token*> const& tokens) : 
-    position_{position}, StatementType_{type}, tokens_{tokens} {
-    // check if StatementType is valid
-    if(type < ASSIGNMENT_STMT || type > WHILE_STMT) {
-        throw InternalError(tokens_[position_]->getLine(), tokens_[position_]->getColumn(), "Invalid StatementType");
+struct PendingNodes {
+    std::vector<Statement*> statements;
+    std::vector<Block*> blocks;
+    std::vector<Expression*> expressions;
+    bool deleting{false}; // an outer destructor is emptying the list
+};
+
+// Nodes waiting to be deleted by the outermost destructor of the thread
+static thread_local PendingNodes pendingNodes;
+
+/**
+ * @brief Hands a child over to the outermost destructor
+ * @param node The child (nothing is done for nullptr)
+ */
+static void releaseNode(Statement* node) {
+    if (node) pendingNodes.statements.push_back(node);
+}
+static void releaseNode(Block* node) {
+    if (node) pendingNodes.blocks.push_back(node);
+}
+static void releaseNode(Expression* node) {
+    if (node) pendingNodes.expressions.push_back(node);
+}
+
+/**
+ * @brief Deletes the pending nodes, unless an outer destructor is already doing it
+ *
+ * Deleting a node may release its own children, which are deleted by the same loop.
+ */
+static void deletePendingNodes() {
+    if (pendingNodes.deleting) {
+        return;
     }
+    pendingNodes.deleting = true;
+    while (true) {
+        if (!pendingNodes.expressions.empty()) {
+            Expression* node = pendingNodes.expressions.back();
+            pendingNodes.expressions.pop_back();
+            delete node;
+        } else if (!pendingNodes.statements.empty()) {
+            Statement* node = pendingNodes.statements.back();
+            pendingNodes.statements.pop_back();
+            delete node;
+        } else if (!pendingNodes.blocks.empty()) {
+            Block* node = pendingNodes.blocks.back();
+            pendingNodes.blocks.pop_back();
+            delete node;
+        } else {
+            break;
+        }
+    }
+    // A large tree leaves large lists behind: give their memory back
+    std::vector<Statement*>().swap(pendingNodes.statements);
+    std::vector<Block*>().swap(pendingNodes.blocks);
+    std::vector<Expression*>().swap(pendingNodes.expressions);
+    pendingNodes.deleting = false;
 }
 
 /**
- * @brief Returns the line number of the statement
- * @return The line number of the statement
+ * @brief Moves the names of another table into this one
+ *
+ * The nodes of the other table are spliced, not copied, so the trees pointing into it stay
+ * valid; the names this table already had are kept apart for the same reason.
+ * @param other The table emptied (the one of a chunk parser)
  */
-int Statement::getLine() const {
-    // Access the "position_"th token in the token vector and return its line
-    return tokens_[position_]->getLine();
+void NameTable::adopt(NameTable& other) {
+    names_.merge(other.names_);
+    if (!other.names_.empty()) {
+        duplicates_.push_back(std::move(other.names_));
+        other.names_.clear();
+    }
+    for (auto& names : other.duplicates_) {
+        duplicates_.push_back(std::move(names));
+    }
+    other.duplicates_.clear();
 }
 
 /**
- * @brief Returns the column number of the statement
- * @return The column number of the statement
+ * @brief Destroys the program and its Syntax Tree
+ */
+Program::~Program() {
+    for (Statement* stmt : stmts_) {
+        releaseNode(stmt);
+    }
+    deletePendingNodes();
+}
+
+/**
+ * @brief Constructs a Statement object
+ * @param position The position of the statement in the token vector
+ * @param type The type of the statement (StatementType enum)
+ * @param tokens The reference to the token vector (for error reporting)
  */
-int Statement::getColumn() const {
-    // Access the "position_"th token in the token vector and return its column
-    return tokens_[position_]->getColumn();
+Statement::Statement(int position, StatementType type, std::vector<Token*> const& tokens) : 
+    StatementType_{type}, position_{position}, line_{tokens[position]->getLine()}, column_{tokens[position]->getColumn()} {
+    // check if StatementType is valid
+    if(type < ASSIGNMENT_STMT || type > WHILE_STMT) {
+        throw InternalError(line_, column_, "Invalid StatementType");
+    }
 }
 
 /**
@@ -52,24 +130,43 @@ int Statement::getColumn() const {
 AssignmentStatement::AssignmentStatement(Location* loc, Expression* expr, int position, std::vector<Token*> const& tokens) : 
     Statement(position, ASSIGNMENT_STMT, tokens), loc_{loc}, expression_{expr} {}
 
+/**
+ * @brief Destroys the assignment statement and its location and expression
+ */
+AssignmentStatement::~AssignmentStatement() {
+    releaseNode(static_cast<Expression*>(loc_));
+    releaseNode(expression_);
+    deletePendingNodes();
+}
+
 /**
  * @brief Constructs a ListDeclarationStatement object
- * @param id The IdToken representing the list identifier
+ * @param id The interned name of the list
+ * @param idLine The line of the list identifier
  * @param position The position of the statement in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-ListDeclarationStatement::ListDeclarationStatement( IdToken* id, int position, std::vector<Token*> const& tokens) : 
-    Statement(position, LIST_DECL_STMT, tokens), id_{id} {}
+ListDeclarationStatement::ListDeclarationStatement(const std::string* id, int idLine, int position, std::vector<Token*> const& tokens) : 
+    Statement(position, LIST_DECL_STMT, tokens), id_{id}, idLine_{idLine} {}
 
 /**
  * @brief Constructs a ListAppendStatement object
- * @param id The IdToken representing the list identifier
+ * @param id The interned name of the list
+ * @param idLine The line of the list identifier
  * @param expr The Expression representing the value to be appended to the list
  * @param position The position of the statement in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-ListAppendStatement::ListAppendStatement(IdToken* id, Expression* expr, int position, std::vector<Token*> const& tokens) : 
-    Statement(position, LIST_APP_STMT, tokens), id_{id}, expr_{expr} {}
+ListAppendStatement::ListAppendStatement(const std::string* id, int idLine, Expression* expr, int position, std::vector<Token*> const& tokens) : 
+    Statement(position, LIST_APP_STMT, tokens), id_{id}, idLine_{idLine}, expr_{expr} {}
+
+/**
+ * @brief Destroys the list append statement and its expression
+ */
+ListAppendStatement::~ListAppendStatement() {
+    releaseNode(expr_);
+    deletePendingNodes();
+}
 
 /**
  * @brief Constructs a BreakStatement object
@@ -96,6 +193,14 @@ ContinueStatement::ContinueStatement(int position, std::vector<Token*> const& to
 PrintStatement::PrintStatement(Expression* expr, int position, std::vector<Token*> const& tokens) :
     Statement(position, PRINT_STMT, tokens), expr_{expr} {}
 
+/**
+ * @brief Destroys the print statement and its expression
+ */
+PrintStatement::~PrintStatement() {
+    releaseNode(expr_);
+    deletePendingNodes();
+}
+
 /**
  * @brief Constructs a CompoundStatement object
  * @param stype The type of the compound statement (StatementType enum)
@@ -107,6 +212,17 @@ PrintStatement::PrintStatement(Expression* expr, int position, std::vector<Token
 CompoundStatement::CompoundStatement(StatementType stype, Expression* expr, std::vector<Block*> blocks, int position, std::vector<Token*> const& tokens ) :
     Statement(position, stype, tokens), expr_{expr}, blocks_{blocks} {}
 
+/**
+ * @brief Destroys the compound statement, its condition and its blocks
+ */
+CompoundStatement::~CompoundStatement() {
+    releaseNode(expr_);
+    for (Block* block : blocks_) {
+        releaseNode(block);
+    }
+    deletePendingNodes();
+}
+
 /**
  * @brief Constructs a Block object
  * @param BlockType The type of the block (BlockType enum)
@@ -115,29 +231,13 @@ CompoundStatement::CompoundStatement(StatementType stype, Expression* expr, std:
  * @param tokens The reference to the token vector (for error reporting)
  */
 Block::Block(BlockType type, int position, std::vector<Token*> const& tokens) :
-    BlockType_{type}, position_{position}, tokens_{tokens} {
+    BlockType_{type}, position_{position}, line_{tokens[position]->getLine()}, column_{tokens[position]->getColumn()} {
     // check if BlockType is valid
     if(type < SIMPLE_BLOCK || type > ELSE_BLOCK) {
-        throw InternalError(tokens_[position_]->getLine(), tokens_[position_]->getColumn(), "Invalid BlockType");
+        throw InternalError(line_, column_, "Invalid BlockType");
     }
 }
 
-/**
- * @brief Returns the line number of the block
- * @return The line number of the block
- */
-int Block::getLine() const {
-    return tokens_[position_]->getLine();
-}
-
-/**
- * @brief Returns the column number of the block
- * @return The column number of the block
- */
-int Block::getColumn() const {
-    return tokens_[position_]->getColumn();
-}
-
 /**
  * @brief Constructs a SimpleBlock object
  * @param stmts The vector of Statements contained in the block
@@ -148,261 +248,174 @@ SimpleBlock::SimpleBlock(std::vector<Statement*> stmts, int position, std::vecto
     Block(SIMPLE_BLOCK, position, tokens), stmts_{stmts} {}
 
 /**
- * @brief Constructs a ElifBlock object
- * @param elif The ReservedKeywordToken representing the block elif
- * @param condition The Expression representing the condition of the elif block
- * @param block The Block contained in the compound block
- * @param position The position of the compound block in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-ElifBlock::ElifBlock(Expression* condition, Block* block, int position, std::vector<Token*> const& tokens) :
-    Block(ELIF_BLOCK, position, tokens), condition_{condition}, block_{block} {}
-
-/**
- * @brief Constructs a ElseBlock object
- * @param block The Block contained in the else block
- * @param position The position of the else block in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-ElseBlock::ElseBlock(Block* block, int position, std::vector<Token*> const& tokens) :
-    Block(ELSE_BLOCK, position, tokens), block_{block} {}
-
-
-/**
- * @brief Constructs an Expression object
- * @param ExprType The type of the expression (ExpressionType enum)
- * @param position The position of the expression in the token vector
+ * @brief Constructs a lazy SimpleBlock object
+ * @param parser The Parser that parses the body on first use (it must outlive the block)
+ * @param begin The position of the first token of the body in the token vector
+ * @param end The position of the dedentation closing the body in the token vector
+ * @param position The position of the block in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-Expression::Expression(ExpressionType exprType, int position, std::vector<Token*> const& tokens) :
-    exprType_{exprType}, position_{position}, tokens_{tokens} {}
+SimpleBlock::SimpleBlock(Parser* parser, int begin, int end, int position, std::vector<Token*> const& tokens) :
+    Block(SIMPLE_BLOCK, position, tokens), parser_{parser}, begin_{begin}, end_{end} {}
 
 /**
- * @brief Returns the line number of the expression
- * @return The line number of the expression
+ * @brief Destroys the block and its statements (those parsed so far, for a lazy block)
  */
-int Expression::getLine() const {
-    // Access the "position_"th token in the token vector and return its line
-    return tokens_[position_]->getLine();
+SimpleBlock::~SimpleBlock() {
+    for (Statement* stmt : stmts_) {
+        releaseNode(stmt);
+    }
+    deletePendingNodes();
 }
 
 /**
- * @brief Returns the column number of the expression
- * @return The column number of the expression
+ * @brief Returns the statements of the block, parsing the body of a lazy block on the first call
+ *
+ * Syntax errors in the body are thrown from here, the first time the block is executed.
+ * @return The vector of Statements contained in the block
  */
-int Expression::getColumn() const {
-    // Access the "position_"th token in the token vector and return its column
-    return tokens_[position_]->getColumn();
+std::vector<Statement*> const& SimpleBlock::getStatements() const {
+    if (parser_) {
+        std::call_once(parsed_, [this]() {
+            stmts_ = parser_->parseBlockBody(begin_, end_);
+            parsedBody_ = true;
+        });
+    }
+    return stmts_;
 }
 
 /**
- * @brief Constructs an OrExpr object
- * @param left The left Join of the OrExpr
- * @param right The right Expression of the OrExpr
- * @param position The position of the OrExpr in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-OrExpr::OrExpr(Join* left, Expression* right, int position, std::vector<Token*> const& tokens) :
-    Expression(OR_EXPR, position, tokens), left_{left}, right_{right} {}
-
-/**
- * @brief Constructs a Join object
- * @param ExprType The type of the join (JoinType enum)
- * @param position The position of the Join in the token vector
+ * @brief Constructs a ElifBlock object
+ * @param elif The ReservedKeywordToken representing the block elif
+ * @param condition The Expression representing the condition of the elif block
+ * @param block The Block contained in the compound block
+ * @param position The position of the compound block in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-Join::Join(int JoinType, int position, std::vector<Token*> const& tokens) :
-    Expression(JOIN, position, tokens), joinType_{JoinType} {}
+ElifBlock::ElifBlock(Expression* condition, Block* block, int position, std::vector<Token*> const& tokens) :
+    Block(ELIF_BLOCK, position, tokens), condition_{condition}, block_{block} {}
 
 /**
- * @brief Constructs an AndExpr object
- * @param left The left Equality of the AndExpr
- * @param right The right Join of the AndExpr
- * @param position The position of the AndExpr in the token vector
- * @param tokens The reference to the token vector (for error reporting)
+ * @brief Destroys the elif block, its condition and its block
  */
-AndExpr::AndExpr(Equality* left, Join* right, int position, std::vector<Token*> const& tokens) :
-    Join(AND_JOIN, position, tokens), left_{left}, right_{right} {}
+ElifBlock::~ElifBlock() {
+    releaseNode(condition_);
+    releaseNode(block_);
+    deletePendingNodes();
+}
 
 /**
- * @brief Constructs an Equality object
- * @param EqualityType The type of the equality (EqualityType enum)
- * @param position The position of the equality in the token vector
+ * @brief Constructs a ElseBlock object
+ * @param block The Block contained in the else block
+ * @param position The position of the else block in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-Equality::Equality(int EqualityType, int position, std::vector<Token*> const& tokens) :
-    Join(EQUALITY, position, tokens), equalityType_{EqualityType} {}
+ElseBlock::ElseBlock(Block* block, int position, std::vector<Token*> const& tokens) :
+    Block(ELSE_BLOCK, position, tokens), block_{block} {}
 
 /**
- * @brief Constructs an EqualExpr object
- * @param left The left Relation of the EqualExpr
- * @param op The RelationalToken representing the equality operator (== or !=)
- * @param right The right Equality of the EqualExpr
- * @param position The position of the EqualExpr in the token vector
- * @param tokens The reference to the token vector (for error reporting)
+ * @brief Destroys the else block and its block
  */
-EqualExpr::EqualExpr(Relation* left, RelationalToken* op, Equality* right, int position, std::vector<Token*> const& tokens) :
-    Equality(COMP_EQUALITY, position, tokens), left_{left}, right_{right} {
+ElseBlock::~ElseBlock() {
+    releaseNode(block_);
+    deletePendingNodes();
+}
 
-        if (op->getIntValue() == RelationalToken::EQ) {
-            EqualExprType_ = EQ_EXPR;
-        } else if (op->getIntValue() == RelationalToken::NEQ) {
-            EqualExprType_ = NEQ_EXPR;
-        } else {
-            throw InternalError( op->getLine(), op->getColumn(), "Invalid relational operator for EqualExpr" );
-        }
-    }
 
 /**
- * @brief Constructs a Relation object
- * @param RelType The type of the relation (int representing the relational operator)
- * @param position The position of the relation in the token vector
+ * @brief Constructs an Expression object
+ * @param ExprType The type of the expression (ExpressionType enum)
+ * @param position The position of the expression in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-Relation::Relation(RelationType RelType, int position, std::vector<Token*> const& tokens) :
-    Equality(REL, position, tokens), relType_{RelType} {}
+Expression::Expression(ExpressionType exprType, int position, std::vector<Token*> const& tokens) :
+    exprType_{exprType}, position_{position}, line_{tokens[position]->getLine()}, column_{tokens[position]->getColumn()} {}
 
 /**
- * @brief Constructs a ComparativeRelation object
- * @param left The left NumExpr of the ComparativeRelation
- * @param op The RelationalToken representing the relational operator (<, <=, >, >=
- * @param right The right NumExpr of the ComparativeRelation
- * @param position The position of the ComparativeRelation in the token vector
+ * @brief Constructs a Binary object
+ * @param left The left operand of the Binary expression
+ * @param op The BinaryOperator applied to the operands
+ * @param right The right operand of the Binary expression
+ * @param position The position of the Binary expression in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-ComparativeRelation::ComparativeRelation(NumExpr* left, RelationalToken* op, NumExpr* right, int position, std::vector<Token*> const& tokens) :
-    Relation(COMPARATIVE_RELATION, position, tokens), left_{left}, right_{right} {
-        if (op->getIntValue() == RelationalToken::LT) {
-            ComparativeRelationType_ = LT_REL;
-        } else if (op->getIntValue() == RelationalToken::LE) {
-            ComparativeRelationType_ = LE_REL;
-        } else if (op->getIntValue() == RelationalToken::GT) {
-            ComparativeRelationType_ = GT_REL;
-        } else if (op->getIntValue() == RelationalToken::GE) {
-            ComparativeRelationType_ = GE_REL;
-        } else {
-            throw InternalError(op->getLine(), op->getColumn(), "Invalid relational operator for ComparativeRelation");
-        }
-    }
+Binary::Binary(Expression* left, BinaryOperator op, Expression* right, int position, std::vector<Token*> const& tokens) :
+    Expression(BINARY_EXPR, position, tokens), left_{left}, op_{op}, right_{right} {}
 
 /**
- * @brief Constructs a NumExpr object
- * @param ExprType The type of the numerical expression (NumExprType enum)
- * @param position The position of the NumExpr in the token vector
- * @param tokens The reference to the token vector (for error reporting)
+ * @brief Destroys the Binary expression and its operands
  */
-NumExpr::NumExpr(NumExprType ExprType, int position, std::vector<Token*> const& tokens) :
-    Relation(NUM_EXPR, position, tokens), numExprType_{ExprType} {}
+Binary::~Binary() {
+    releaseNode(left_);
+    releaseNode(right_);
+    deletePendingNodes();
+}
 
 /**
- * @brief Constructs a AritExpr object
- * @param left The left Term of the AritExpr
- * @param op The ArithmeticToken representing the arithmetic operator (+ or -)
- * @param right The right NumExpr of the AritExpr
- * @param position The position of the AritExpr in the token vector
+ * @brief Constructs a Nary object
+ * @param operands The operands of the chain, in source order
+ * @param ops The operators between consecutive operands (one less than the operands)
+ * @param position The position of the Nary expression in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-AritExpr::AritExpr(Term* left, ArithmeticToken* op, NumExpr* right, int position, std::vector<Token*> const& tokens) :
-    NumExpr(ARIT_EXPR, position, tokens), left_{left}, right_{right} {
-        if (op->getIntValue() == ArithmeticToken::ADD) {
-            aritExprType_ = ADD_EXPR;
-        } else if (op->getIntValue() == ArithmeticToken::SUB) {
-            aritExprType_ = SUB_EXPR;
-        } else {
-            throw InternalError(op->getLine(), op->getColumn(), "Invalid arithmetic operator for AritExpr");
+Nary::Nary(std::vector<Expression*> operands, std::vector<BinaryOperator> ops, int position, std::vector<Token*> const& tokens) :
+    Expression(NARY_EXPR, position, tokens), operands_{std::move(operands)}, ops_{std::move(ops)} {
+    // check that there is exactly one operator between two operands
+    if (operands_.size() != ops_.size() + 1) {
+        // the destructor does not run: the operands are deleted here
+        for (Expression* operand : operands_) {
+            releaseNode(operand);
         }
+        deletePendingNodes();
+        throw InternalError(getLine(), getColumn(), "Invalid operand count in Nary expression");
     }
+}
 
 /**
- * @brief Constructs a Term object
- * @param TermType The type of the term (int representing the term type)
- * @param position The position of the Term in the token vector
- * @param tokens The reference to the token vector (for error reporting)
+ * @brief Destroys the Nary expression and its operands
  */
-Term::Term(int TermType, int position, std::vector<Token*> const& tokens) :
-    NumExpr(TERM, position, tokens), termType_{TermType} {}
-
-/**
- * @brief Constructs a MulDivTerm object
- * @param left The left Unary of the MulDivTerm
- * @param op The ArithmeticToken representing the arithmetic operator (* or //)
- * @param right The right Term of the MulDivTerm
- * @param position The position of the MulDivTerm in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-MulDivTerm::MulDivTerm( Unary* left, ArithmeticToken* op, Term* right, int position, std::vector<Token*> const& tokens) :
-    Term(MULDIV_TERM, position, tokens), left_{left}, right_{right} {
-        if (op->getIntValue() == ArithmeticToken::MUL) {
-            mulDivTermType_ = MUL_TERM;
-        } else if (op->getIntValue() == ArithmeticToken::DIV) {
-            mulDivTermType_ = DIV_TERM;
-        } else {
-            throw InternalError(op->getLine(), op->getColumn(), "Invalid arithmetic operator for MulDivTerm");
-        }
+Nary::~Nary() {
+    for (Expression* operand : operands_) {
+        releaseNode(operand);
     }
+    deletePendingNodes();
+}
 
 /**
  * @brief Constructs a Unary object
- * @param unaryType The type of the unary (UnaryType enum)
- * @param position The position of the Unary in the token vector
+ * @param op The UnaryOperator applied to the operand
+ * @param operand The Expression following the 'not' or '-' operator
+ * @param position The position of the Unary expression in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-Unary::Unary(int unaryType, int position, std::vector<Token*> const& tokens) :
-    Term(UNARY_TERM, position, tokens), unaryType_{unaryType} {}
+Unary::Unary(UnaryOperator op, Expression* operand, int position, std::vector<Token*> const& tokens) :
+    Expression(UNARY_EXPR, position, tokens), op_{op}, operand_{operand} {}
 
 /**
- * @brief Constructs a NotUnary object
- * @param unary The Unary expression following the 'not' operator
- * @param position The position of the NotUnary in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-NotUnary::NotUnary(Unary* unary, int position, std::vector<Token*> const& tokens) :
-    Unary(NOT_UNARY, position, tokens), unary_{unary} {}
-
-/**
- * @brief Constructs a MinusUnary object
- * @param unary The Unary expression following the '-' operator
- * @param position The position of the MinusUnary in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-MinusUnary::MinusUnary(Unary* unary, int position, std::vector<Token*> const& tokens) :
-    Unary(MINUS_UNARY, position, tokens), unary_{unary} {}
-
-/**
- * @brief Constructs a Factor object
- * @param factorType The type of the factor (FactorType enum)
- * @param position The position of the Factor in the token vector
- * @param tokens The reference to the token vector (for error reporting)
+ * @brief Destroys the Unary expression and its operand
  */
-Factor::Factor(FactorType factorType, int position, std::vector<Token*> const& tokens) :
-    Unary(FACTOR, position, tokens), factorType_{factorType} {}
-
-/**
- * @brief Constructs an ExpressionFactor object
- * @param expr The Expression contained in the parentheses
- * @param position The position of the ExpressionFactor in the token vector
- * @param tokens The reference to the token vector (for error reporting)
- */
-ExpressionFactor::ExpressionFactor(Expression* expr, int position, std::vector<Token*> const& tokens) :
-    Factor(EXPR_FACTOR, position, tokens), expr_{expr} {}
+Unary::~Unary() {
+    releaseNode(operand_);
+    deletePendingNodes();
+}
 
 /**
- * @brief Constructs a NumberFactor object
- * @param number The NumberToken representing the numeric value
- * @param position The position of the NumberFactor in the token vector
+ * @brief Constructs an integer Literal object
+ * @param value The integer value of the literal
+ * @param position The position of the Literal in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-NumberFactor::NumberFactor(NumberToken* number, int position, std::vector<Token*> const& tokens) :
-    Factor(NUMBER, position, tokens), number_{number} {}
+Literal::Literal(int value, int position, std::vector<Token*> const& tokens) :
+    Expression(LITERAL_EXPR, position, tokens), literalType_{TYPE_INT}, intValue_{value} {}
 
 /**
- * @brief Constructs a BoolFactor object
- * @param boolean The BoolToken representing the boolean value
- * @param position The position of the BoolFactor in the token vector
+ * @brief Constructs a boolean Literal object
+ * @param value The boolean value of the literal
+ * @param position The position of the Literal in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-BoolFactor::BoolFactor(BoolToken* boolean, int position, std::vector<Token*> const& tokens) :
-    Factor(BOOL, position, tokens), boolean_{boolean} {}
+Literal::Literal(bool value, int position, std::vector<Token*> const& tokens) :
+    Expression(LITERAL_EXPR, position, tokens), literalType_{TYPE_BOOL}, boolValue_{value} {}
 
 /**
  * @brief Constructs a Location object
@@ -411,23 +424,31 @@ BoolFactor::BoolFactor(BoolToken* boolean, int position, std::vector<Token*> con
  * @param tokens The reference to the token vector (for error reporting)
  */
 Location::Location(int locType, int position, std::vector<Token*> const& tokens) :
-    Factor(LOCATION, position, tokens), locType_{locType} {}
+    Expression(LOAD_EXPR, position, tokens), locType_{locType} {}
 
 /**
  * @brief Constructs an IdLocation object
- * @param id The IdToken representing the identifier
+ * @param id The interned name of the identifier
  * @param position The position of the IdLocation in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-IdLocation::IdLocation(IdToken* id, int position, std::vector<Token*> const& tokens) :
+IdLocation::IdLocation(const std::string* id, int position, std::vector<Token*> const& tokens) :
     Location(ID, position, tokens), id_{id} {}
 
 /**
  * @brief Constructs a ListElementLocation object
- * @param id The IdToken representing the list identifier
+ * @param id The interned name of the list
  * @param expr The Expression representing the index of the list element
  * @param position The position of the ListElementLocation in the token vector
  * @param tokens The reference to the token vector (for error reporting)
  */
-ListElementLocation::ListElementLocation(IdToken* id, Expression* expr, int position, std::vector<Token*> const& tokens) :
-    Location(LIST_ELEM, position, tokens), id_{id}, expr_{expr} {}
\ No newline at end of file
+ListElementLocation::ListElementLocation(const std::string* id, Expression* expr, int position, std::vector<Token*> const& tokens) :
+    Location(LIST_ELEM, position, tokens), id_{id}, expr_{expr} {}
+
+/**
+ * @brief Destroys the list element location and its index
+ */
+ListElementLocation::~ListElementLocation() {
+    releaseNode(expr_);
+    deletePendingNodes();
+}
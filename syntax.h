@@ -1,7 +1,12 @@
 #if !defined(SYNTAX_H)
 #define SYNTAX_H
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_set>
 #include <vector>
+#include <mutex>
 #include "token.h"
 #include "semantics.h"
 #include "error.h"
@@ -11,16 +16,8 @@
 class Statement;
 class Expression;
 class Location;
-class Join;
-class Equality;
-class Term;
-class Unary;
-class NumExpr;
-class Relation;
 class Block;
-class CompoundBlock;
-class RelationalToken;
-class ArithmeticToken;
+class Parser;
 
 /**
  * @file syntax.h
@@ -33,25 +30,60 @@ class ArithmeticToken;
  */
 
 
+/**
+ * @class NameTable
+ * @brief Interned identifiers of a Syntax Tree
+ *
+ * The nodes naming a variable point to the single copy of its name kept here, so the tree does
+ * not depend on the tokens and they can be freed once the program is parsed. The strings never
+ * move: a set node keeps its address until the table is destroyed, also across adopt().
+ */
+class NameTable{
+    public:
+        // constructors
+        NameTable() = default;
+        NameTable(NameTable const& nt) = delete;
+
+        // destructor
+        ~NameTable() = default;
+
+        // methods
+        const std::string* intern(const std::string& name) { return &*names_.insert(name).first; }
+        void adopt(NameTable& other);
+        size_t size() const { return names_.size() + duplicates_.size(); }
+
+    private:
+        std::unordered_set<std::string> names_;
+        std::vector<std::unordered_set<std::string>> duplicates_; // names of adopted tables already present here
+};
+
 /**
  * @class Program
  * @brief Represents a program in the Python-Sublanguage interpreter
+ *
+ * Every node of the Syntax Tree owns its children, so deleting the Program deletes the whole
+ * tree. The children are not deleted recursively (see syntax.cpp), so the depth of the tree is
+ * not limited by the size of the call stack.
  */
 class Program{
     public:
         // constructors
         Program() = default;
         Program( std::vector<Statement*> stmts) : stmts_{stmts} {}
+        Program( std::vector<Statement*> stmts, std::shared_ptr<NameTable> names) : stmts_{stmts}, names_{names} {}
         Program(Program const& p) = delete;
 
         // destructor
-        ~Program() = default;
+        ~Program(); // defined in syntax.cpp (deletes the statements)
 
         // methods
-        std::vector<Statement*> getStatements() const { return stmts_; }
+        std::vector<Statement*> const& getStatements() const { return stmts_; }
+        void addStatement(Statement* stmt) { stmts_.push_back(stmt); } // the program grows while it runs (see Pipeline)
+        std::shared_ptr<NameTable> const& getNames() const { return names_; }
 
     private:
         std::vector<Statement*> stmts_;
+        std::shared_ptr<NameTable> names_; // identifiers the statements point to (shared with a lazy parser)
 };
 
 /**
@@ -90,13 +122,15 @@ class Statement{
         int getStatementType() const { return StatementType_; }
 
         // methods to get line and column
-        int getLine() const;
-        int getColumn() const;
+        int getLine() const { return line_; }
+        int getColumn() const { return column_; }
+        int getPosition() const { return position_; }
 
     private:
         int StatementType_;
-        int position_; // position in the token vector (for error reporting)
-        std::vector<Token*> tokens_; // reference to the token vector (for error reporting)
+        int position_; // position in the token vector (for the cache)
+        int line_;     // line and column of the token at position_ (for error reporting)
+        int column_;
 };
 
 /**
@@ -111,7 +145,7 @@ class AssignmentStatement : public Statement{
         AssignmentStatement(AssignmentStatement const& as) = delete;
 
         // destructor
-        ~AssignmentStatement() = default;
+        ~AssignmentStatement(); // defined in syntax.cpp (deletes the location and the expression)
 
         // methods
         Location* getLocation() const { return loc_; }
@@ -130,17 +164,19 @@ class ListDeclarationStatement : public Statement{
     public:
         // constructors
         ListDeclarationStatement() = delete;
-        ListDeclarationStatement( IdToken* id, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        ListDeclarationStatement(const std::string* id, int idLine, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
         ListDeclarationStatement(ListDeclarationStatement const& lds) = delete;
 
         // destructor
         ~ListDeclarationStatement() = default;
 
         // methods
-        std::string getId() const { return id_->getStringValue(); }
+        std::string const& getId() const { return *id_; }
+        int getIdLine() const { return idLine_; }
 
     private:
-        IdToken* id_;
+        const std::string* id_; // interned in the NameTable of the program
+        int idLine_;            // line of the identifier (the position is the closing newline)
 };
 
 /**
@@ -151,18 +187,20 @@ class ListAppendStatement : public Statement{
     public:
         // constructors
         ListAppendStatement() = delete;
-        ListAppendStatement(IdToken* id, Expression* expr, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        ListAppendStatement(const std::string* id, int idLine, Expression* expr, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
         ListAppendStatement(ListAppendStatement const& las) = delete;
 
         // destructor
-        ~ListAppendStatement() = default;
+        ~ListAppendStatement(); // defined in syntax.cpp (deletes the expression)
 
         // methods
-        std::string getId() const { return id_->getStringValue(); }
+        std::string const& getId() const { return *id_; }
+        int getIdLine() const { return idLine_; }
         Expression* getExpression() const { return expr_; }
 
     private:
-        IdToken* id_;
+        const std::string* id_; // interned in the NameTable of the program
+        int idLine_;            // line of the identifier (the position is the closing newline)
         Expression* expr_;
 };
 
@@ -208,7 +246,7 @@ class PrintStatement : public Statement{
         PrintStatement(PrintStatement const& ps) = delete;
 
         // destructor
-        ~PrintStatement() = default;
+        ~PrintStatement(); // defined in syntax.cpp (deletes the expression)
 
         // methods
         Expression* getExpression() const { return expr_; }
@@ -229,11 +267,11 @@ class CompoundStatement : public Statement{
         CompoundStatement(CompoundStatement const& cs) = delete;
 
         // destructor
-        ~CompoundStatement() = default;
+        ~CompoundStatement(); // defined in syntax.cpp (deletes the condition and the blocks)
 
         // methods
         Expression* getExpression() const { return expr_; }
-        std::vector<Block*> getBlocks() const { return blocks_; }
+        std::vector<Block*> const& getBlocks() const { return blocks_; }
 
     private:
         Expression* expr_;
@@ -260,41 +298,53 @@ class Block{
         // constructors
         Block() = delete;
         Block(BlockType type, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        Block(Block const& b) = default;
+        Block(Block const& b) = delete;
 
         // destructor
         virtual ~Block() = default;
 
         // methods
-        int getLine() const ;
-        int getColumn() const;
+        int getLine() const { return line_; }
+        int getColumn() const { return column_; }
+        int getPosition() const { return position_; }
         BlockType getBlockType() const { return BlockType_; }
 
     private:
         BlockType BlockType_;
-        int position_; // position in the token vector (for error reporting)
-        std::vector<Token*> tokens_; // reference to the token vector (for error reporting)
+        int position_; // position in the token vector (for the cache)
+        int line_;     // line and column of the token at position_ (for error reporting)
+        int column_;
 };
 
 /**
  * @class SimpleBlock
  * @brief Represents a simple block of statements in the Python-Sublanguage interpreter
+ *
+ * A lazy block only knows the token range of its body, which is parsed by the Parser
+ * the first time the statements are requested.
  */
 class SimpleBlock : public Block{
     public:
         // constructors
         SimpleBlock() = delete;
         SimpleBlock(std::vector<Statement*> stmts, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        SimpleBlock(SimpleBlock const& sb) = default;
+        SimpleBlock(Parser* parser, int begin, int end, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        SimpleBlock(SimpleBlock const& sb) = delete;
 
         // destructor
-        ~SimpleBlock() = default;
+        ~SimpleBlock(); // defined in syntax.cpp (deletes the statements)
 
         // methods
-        std::vector<Statement*> getStatements() const { return stmts_; }
+        std::vector<Statement*> const& getStatements() const; // defined in syntax.cpp
+        bool isParsed() const { return !parser_ || parsedBody_.load(); }
 
     private:
-        std::vector<Statement*> stmts_;
+        mutable std::vector<Statement*> stmts_;
+        Parser* parser_{nullptr}; // parser of the body (lazy blocks only)
+        int begin_{0}; // position of the first token of the body (lazy blocks only)
+        int end_{0}; // position of the dedentation closing the body (lazy blocks only)
+        mutable std::once_flag parsed_;
+        mutable std::atomic<bool> parsedBody_{false}; // the body of a lazy block has been parsed
 };
 
 /**
@@ -306,10 +356,10 @@ class ElifBlock : public Block{
         // constructors
         ElifBlock() = delete;
         ElifBlock(Expression* condition, Block* block, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        ElifBlock(ElifBlock const& eb) = default;
+        ElifBlock(ElifBlock const& eb) = delete;
 
         // destructor
-        ~ElifBlock() = default;
+        ~ElifBlock(); // defined in syntax.cpp (deletes the condition and the block)
 
         // methods
         Expression* getCondition() const { return condition_; }
@@ -329,10 +379,10 @@ class ElseBlock : public Block {
         // constructors
         ElseBlock() = delete;
         ElseBlock(Block* block, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        ElseBlock(ElseBlock const& eb) = default;
+        ElseBlock(ElseBlock const& eb) = delete;
 
         // destructor
-        ~ElseBlock() = default;
+        ~ElseBlock(); // defined in syntax.cpp (deletes the block)
 
         // methods
         Block* getBlock() const { return block_; }
@@ -346,8 +396,11 @@ class ElseBlock : public Block {
  * @brief Represents the different types of expressions in the Python-Sublanguage interpreter
  */
 enum ExpressionType {
-    OR_EXPR,
-    JOIN
+    BINARY_EXPR,
+    NARY_EXPR,
+    UNARY_EXPR,
+    LITERAL_EXPR,
+    LOAD_EXPR
 };
 
 /**
@@ -366,517 +419,147 @@ class Expression{
 
         // methods
         ExpressionType getExprType() const { return exprType_; }
-        int getLine() const;
-        int getColumn() const;
+        int getLine() const { return line_; }
+        int getColumn() const { return column_; }
+        int getPosition() const { return position_; }
         void setDataType(Types type) { dataType_ = type; }
 
     private:
         Types dataType_{Types::TYPE_UNDEFINED}; // Type of the expression (int, bool, undefined)
         ExpressionType exprType_;  // Type of the expression (ExpressionType enum)
-        int position_; // position in the token vector (for error reporting)
-        std::vector<Token*> const& tokens_; // reference to the token vector (for error reporting)
-};
-
-/**
- * @class OrExpr
- * @brief Represents a boolean OR expression in the Python-Sublanguage interpreter
- */
-class OrExpr : public Expression{
-    public:
-        // constructors
-        OrExpr() = delete;
-        OrExpr(Join* left, Expression* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        OrExpr(OrExpr const& oe) = delete;
-
-        // destructor
-        ~OrExpr() = default;
-
-        // methods
-        Join* getLeft() const { return left_; }
-        Expression* getRight() const { return right_; }
-
-    private:
-        Join* left_;
-        Expression* right_;
-};
-
-/**
- * @enum JoinType
- * @brief Represents the different types of joins in the Python-Sublanguage interpreter
- */
-enum JoinType {
-    AND_JOIN,
-    EQUALITY
-};
-
-/**
- * @class Join
- * @brief Represents a boolean expression in the Python-Sublanguage interpreter
- */
-class Join : public Expression{
-    public:
-        // constructors
-        Join() = delete;
-        Join(int JoinType, int position, std::vector<Token*> const& tokens);
-        Join(Join const& j) = delete;
-
-        // destructor
-        virtual ~Join() = default;
-
-        // methods
-        int getJoinType() const { return joinType_; }
-
-    private:
-        int joinType_;
-};
-
-/**
- * @class AndExpr
- * @brief Represents a boolean AND expression in the Python-Sublanguage interpreter
- */
-class AndExpr : public Join{
-    public:
-        // constructors
-        AndExpr() = delete;
-        AndExpr(Equality* left, Join* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        AndExpr(AndExpr const& ae) = delete;
-
-        // destructor
-        ~AndExpr() = default;
-
-        // methods
-        Equality* getLeft() const { return left_; }
-        Join* getRight() const { return right_; }
-
-    private:
-        Equality* left_;
-        Join* right_;
-};
-
-/**
- * @enum EqualityType
- * @brief Represents the different types of equalities in the Python-Sublanguage interpreter
- */
-enum EqualityType {
-    COMP_EQUALITY,
-    REL
-};
-
-/**
- * @class Equality
- * @brief Represents an equality expression in the Python-Sublanguage interpreter
- */
-class Equality : public Join{
-    public:
-        // constructors
-        Equality() = delete;
-        Equality(int EqualityType, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        Equality(Equality const& e) = delete;
-
-        // destructor
-        virtual ~Equality() = default;
-
-        // methods
-        int getEqualityType() const { return equalityType_; }
-
-    private:
-        int equalityType_;
-};
-
-/**
- * @enum EqualExprType
- * @brief Represents the different types of equality expressions in the Python-Sublanguage interpreter
- */
-enum EqualExprType {
-    EQ_EXPR,
-    NEQ_EXPR
-};
-
-/**
- * @class EqualExpr
- * @brief Represents an equality expression in the Python-Sublanguage interpreter
- */
-class EqualExpr : public Equality{
-    public:
-        // constructors
-        EqualExpr() = delete;
-        EqualExpr(Relation* left, RelationalToken* op, Equality* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        EqualExpr(EqualExpr const& ee) = delete;
-
-        // destructor
-        ~EqualExpr() = default;
-
-        // methods
-        Relation* getLeft() const { return left_; }
-        Equality* getRight() const { return right_; }
-        EqualExprType getType() const { return EqualExprType_; }
-
-    private:
-        Relation* left_;
-        EqualExprType EqualExprType_; 
-        Equality* right_;
-};
-
-/**
- * @enum RelationType
- * @brief Represents the different types of relations in the Python-Sublanguage interpreter
- */
-enum RelationType {
-    COMPARATIVE_RELATION,
-    NUM_EXPR
-};
-
-/**
- * @class Relation
- * @brief Represents a relational expression in the Python-Sublanguage interpreter
- */
-class Relation : public Equality{
-    public:
-        // constructors
-        Relation() = delete;
-        Relation(RelationType RelType, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        Relation(Relation const& r) = delete;
-
-        // destructor
-        ~Relation() = default;
-
-        // methods
-        RelationType getRelType() const { return relType_; }
-
-    private:
-        RelationType relType_;
+        int position_; // position in the token vector (for the cache)
+        int line_;     // line and column of the token at position_ (for error reporting)
+        int column_;
 };
 
 /**
- * @enum ComparativeRelationType
- * @brief Represents the different types of comparative relations in the Python-Sublanguage interpreter
+ * @enum BinaryOperator
+ * @brief Represents the operators of binary expressions in the Python-Sublanguage interpreter
  */
-enum ComparativeRelationType {
-    LT_REL,
-    LE_REL,
-    GT_REL,
-    GE_REL
+enum BinaryOperator {
+    OR_OP,
+    AND_OP,
+    EQ_OP,
+    NEQ_OP,
+    LT_OP,
+    LE_OP,
+    GT_OP,
+    GE_OP,
+    ADD_OP,
+    SUB_OP,
+    MUL_OP,
+    DIV_OP
 };
 
 /**
- * @class ComparativeRelation
- * @brief Represents a comparative relational expression in the Python-Sublanguage interpreter
+ * @class Binary
+ * @brief Represents a binary expression (boolean, relational or arithmetic) in the Python-Sublanguage interpreter
  */
-class ComparativeRelation : public Relation{
+class Binary : public Expression{
     public:
         // constructors
-        ComparativeRelation() = delete;
-        ComparativeRelation(NumExpr* left, RelationalToken* op, NumExpr* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        ComparativeRelation(ComparativeRelation const& cr) = delete;
+        Binary() = delete;
+        Binary(Expression* left, BinaryOperator op, Expression* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        Binary(Binary const& b) = delete;
 
         // destructor
-        ~ComparativeRelation() = default;
+        ~Binary(); // defined in syntax.cpp (deletes the operands)
 
         // methods
-        NumExpr* getLeft() const { return left_; }
-        NumExpr* getRight() const { return right_; }
-        ComparativeRelationType getType() const { return ComparativeRelationType_; }
-
-    private:
-        NumExpr* left_;
-        ComparativeRelationType ComparativeRelationType_;
-        NumExpr* right_;
-};
-
-/**
- * @enum NumExprType
- * @brief Represents the different types of numerical expressions in the Python-Sublanguage interpreter
- */
-enum NumExprType {
-    ARIT_EXPR,
-    TERM
-};
-
-/**
- * @class NumExpr
- * @brief Represents a numerical expression in the Python-Sublanguage interpreter
- */
-class NumExpr : public Relation{
-    public:
-        // constructors
-        NumExpr() = delete;
-        NumExpr(NumExprType ExprType, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        NumExpr(NumExpr const& ne) = delete;
-
-        // destructor
-        ~NumExpr() = default;
-
-        // methods
-        NumExprType getNumExprType() const { return numExprType_; }
-
-    private:
-        NumExprType numExprType_;
-};
-
-/**
- * @enum AritExprType
- * @brief Represents the different types of arithmetic expressions in the Python-Sublanguage interpreter
- */
-enum AritExprType {
-    ADD_EXPR,
-    SUB_EXPR
-};
-
-/**
- * @class AritExpr
- * @brief Represents arithmetic expressions (addition and subtraction) between two numerical expressions in the Python-Sublanguage interpreter
- */
-class AritExpr : public NumExpr{
-    public:
-        // constructors
-        AritExpr() = delete;
-        AritExpr(Term* left, ArithmeticToken* op, NumExpr* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        AritExpr(AritExpr const& ae) = delete;
-
-        // destructor
-        ~AritExpr() = default;
-
-        // methods
-        Term* getLeft() const { return left_; }
-        NumExpr* getRight() const { return right_; }
-        AritExprType getAritExprType() const { return aritExprType_; }
-
-    private:
-        Term* left_;
-        AritExprType aritExprType_;
-        NumExpr* right_;
-};
-
-/**
- * @enum TermType
- * @brief Represents the different types of terms in the Python-Sublanguage interpreter
- */
-enum TermType {
-    MULDIV_TERM,
-    UNARY_TERM
-};
-
-/**
- * @class Term
- * @brief Represents an arithmetic expression in the Python-Sublanguage interpreter
- */
-class Term : public NumExpr{
-    public:
-        // constructors
-        Term() = delete;
-        Term(int TermType, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        Term(Term const& t) = delete;
-
-        // destructor
-        ~Term() = default;
-
-        // methods
-        int getTermType() const { return termType_; }
+        Expression* getLeft() const { return left_; }
+        Expression* getRight() const { return right_; }
+        BinaryOperator getOperator() const { return op_; }
 
     private:
-        int termType_;
-};
-
-/**
- * @enum MulDivTermType
- * @brief Represents the different types of multiplication/division terms in the Python-Sublanguage interpreter
- */
-enum MulDivTermType {
-    MUL_TERM,
-    DIV_TERM
+        Expression* left_;
+        BinaryOperator op_;
+        Expression* right_;
 };
 
 /**
- * @class MulTerm
- * @brief Represents multiplication between two terms in the Python-Sublanguage interpreter
+ * @class Nary
+ * @brief Represents a chain of operators of the same precedence in the Python-Sublanguage interpreter
+ *
+ * 'a + b - c + d' or 'a and b and c' are stored flat (operands[0] op[0] operands[1] op[1] ...)
+ * and evaluated left to right in a loop instead of one nested Binary per operator.
  */
-class MulDivTerm : public Term{
+class Nary : public Expression{
     public:
         // constructors
-        MulDivTerm() = delete;
-        MulDivTerm( Unary* left, ArithmeticToken* op, Term* right, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        MulDivTerm(MulDivTerm const& mdt) = delete;
+        Nary() = delete;
+        Nary(std::vector<Expression*> operands, std::vector<BinaryOperator> ops, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        Nary(Nary const& n) = delete;
 
         // destructor
-        ~MulDivTerm() = default;
+        ~Nary(); // defined in syntax.cpp (deletes the operands)
 
         // methods
-        Unary* getLeft() const { return left_; }
-        Term* getRight() const { return right_; }
-        MulDivTermType getMulDivTermType() const { return mulDivTermType_; }
+        std::vector<Expression*> const& getOperands() const { return operands_; }
+        std::vector<BinaryOperator> const& getOperators() const { return ops_; }
 
     private:
-        Unary* left_;
-        MulDivTermType mulDivTermType_;
-        Term* right_;
+        std::vector<Expression*> operands_;
+        std::vector<BinaryOperator> ops_; // ops_[i] is applied between operands_[i] and operands_[i + 1]
 };
 
 /**
- * @enum UnaryType
- * @brief Represents the different types of unary expressions in the Python-Sublanguage interpreter
+ * @enum UnaryOperator
+ * @brief Represents the operators of unary expressions in the Python-Sublanguage interpreter
  */
-enum UnaryType {
-    NOT_UNARY,
-    MINUS_UNARY,
-    FACTOR
+enum UnaryOperator {
+    NOT_OP,
+    MINUS_OP
 };
 
 /**
  * @class Unary
- * @brief Represents a unary expression in the Python-Sublanguage interpreter
+ * @brief Represents a unary expression ('not' or '-') in the Python-Sublanguage interpreter
  */
-class Unary : public Term{
+class Unary : public Expression{
     public:
         // constructors
         Unary() = delete;
-        Unary(int unaryType, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        Unary(UnaryOperator op, Expression* operand, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
         Unary(Unary const& u) = delete;
 
         // destructor
-        ~Unary() = default;
-
-        // methods
-        int getUnaryType() const { return unaryType_; }
-
-    private:
-        int unaryType_;
-};
-
-/**
- * @class NotUnary
- * @brief Represents a logical not unary expression in the Python-Sublanguage interpreter
- */
-class NotUnary : public Unary{
-    public:
-        // constructors
-        NotUnary() = delete;
-        NotUnary(Unary* unary, int position, std::vector<Token*> const& tokens);
-        NotUnary(NotUnary const& nu) = delete;
-
-        // destructor
-        ~NotUnary() = default;
-
-        // methods
-        Unary* getUnary() const { return unary_; }
-
-    private:
-        Unary* unary_;
-};
-
-/**
- * @class MinusUnary
- * @brief Represents a minus unary expression in the Python-Sublanguage interpreter
- */
-class MinusUnary : public Unary{
-    public:
-        // constructors
-        MinusUnary() = delete;
-        MinusUnary(Unary* unary, int position, std::vector<Token*> const& tokens);
-        MinusUnary(MinusUnary const& mu) = delete;
-
-        // destructor
-        ~MinusUnary() = default;
-
-        // methods
-        Unary* getUnary() const { return unary_; }
-
-    private:
-        Unary* unary_;
-};
-
-/**
- * @enum FactorType
- * @brief Represents the different types of factors in the Python-Sublanguage interpreter
- */
-enum FactorType {
-    EXPR_FACTOR,
-    LOCATION,
-    NUMBER,
-    BOOL
-};
-
-/**
- * @class Factor
- * @brief Represents a factor in the Python-Sublanguage interpreter
- */
-class Factor : public Unary{
-    public:
-        // constructors
-        Factor() = delete;
-        Factor(FactorType factorType, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        Factor(Factor const& f) = delete;
-
-        // destructor
-        ~Factor() = default;
-
-        // methods
-        FactorType getFactorType() const { return factorType_; }
-
-    private:
-        FactorType factorType_;
-};
-
-/**
- * @class ExpressionFactor
- * @brief Represents an expression factor in the Python-Sublanguage interpreter
- */
-class ExpressionFactor : public Factor{
-    public:
-        // constructors
-        ExpressionFactor() = delete;
-        ExpressionFactor(Expression* expr, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        ExpressionFactor(ExpressionFactor const& ef) = delete;
-
-        // destructor
-        virtual ~ExpressionFactor() = default;
-
-        // methods
-        Expression* getExpression() const { return expr_; }
-
-    private:
-        Expression* expr_;
-};
-
-/**
- * @class NumberFactor
- * @brief Represents a number factor in the Python-Sublanguage interpreter
- */
-class NumberFactor : public Factor{
-    public:
-        // constructors
-        NumberFactor() = delete;
-        NumberFactor(NumberToken* number, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        NumberFactor(NumberFactor const& nf) = delete;
-
-        // destructor
-        ~NumberFactor() = default;
+        ~Unary(); // defined in syntax.cpp (deletes the operand)
 
         // methods
-        NumberToken* getNumber() const { return number_; }
+        Expression* getOperand() const { return operand_; }
+        UnaryOperator getOperator() const { return op_; }
 
     private:
-        NumberToken* number_;
+        UnaryOperator op_;
+        Expression* operand_;
 };
 
 /**
- * @class BoolFactor
- * @brief Represents a boolean factor in the Python-Sublanguage interpreter
+ * @class Literal
+ * @brief Represents an integer or boolean constant in the Python-Sublanguage interpreter
+ *
+ * The value is copied out of the token, so evaluating a literal does not touch the token vector
  */
-class BoolFactor : public Factor{
+class Literal : public Expression{
     public:
         // constructors
-        BoolFactor() = delete;
-        BoolFactor(BoolToken* boolean, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
-        BoolFactor(BoolFactor const& bf) = delete;
+        Literal() = delete;
+        Literal(int value, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        Literal(bool value, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        Literal(Literal const& l) = delete;
 
         // destructor
-        ~BoolFactor() = default;
+        ~Literal() = default;
 
         // methods
-        BoolToken* getBool() const { return boolean_; }
+        Types getLiteralType() const { return literalType_; }
+        int getIntValue() const { return intValue_; }
+        bool getBoolValue() const { return boolValue_; }
 
     private:
-        BoolToken* boolean_;
+        Types literalType_;
+        int intValue_{0};
+        bool boolValue_{false};
 };
 
 /**
@@ -891,8 +574,10 @@ enum LocationType {
 /**
  * @class Location
  * @brief Represents a location in the Python-Sublanguage interpreter
+ *
+ * Locations are both assignment targets and load expressions (variable or list element reads)
  */
-class Location : public Factor{
+class Location : public Expression{
     public:
         // constructors
         Location() = delete;
@@ -917,17 +602,17 @@ class IdLocation : public Location{
     public:
         // constructors
         IdLocation() = delete;
-        IdLocation(IdToken* id, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        IdLocation(const std::string* id, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
         IdLocation(IdLocation const& l) = delete;
 
         // destructor
         ~IdLocation() = default;
 
         // methods
-        std::string getId() const { return id_->getStringValue(); }
+        std::string const& getId() const { return *id_; }
     
     private:
-        IdToken* id_;
+        const std::string* id_; // interned in the NameTable of the program
 };
 
 /**
@@ -938,18 +623,18 @@ class ListElementLocation : public Location{
     public:
         // constructors
         ListElementLocation() = delete;
-        ListElementLocation(IdToken* id, Expression* expr, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
+        ListElementLocation(const std::string* id, Expression* expr, int position, std::vector<Token*> const& tokens); // defined in syntax.cpp
         ListElementLocation(ListElementLocation const& l) = delete;
 
         // destructor
-        ~ListElementLocation() = default;
+        ~ListElementLocation(); // defined in syntax.cpp (deletes the index)
 
         // methods
-        std::string getId() const { return id_->getStringValue(); }
+        std::string const& getId() const { return *id_; }
         Expression* getIndex() const { return expr_; }
 
     private:
-        IdToken* id_;
+        const std::string* id_; // interned in the NameTable of the program
         Expression* expr_;
 };
 
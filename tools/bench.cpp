@@ -0,0 +1,522 @@
+/**
+ * @file bench.cpp
+ * @brief Benchmark suite of the Python-Sublanguage interpreter
+ *
+ * Generates parameterized workloads, times the lexing, parsing and execution of each one with
+ * warmup runs and repetitions, and writes the median and the median absolute deviation (MAD)
+ * of every phase as JSON to the standard output (or the operation counts of one run), e.g.:
+ *   psl_bench --reps=15 > bench.json
+ *   psl_bench --baseline=bench.json
+ *   psl_bench --counts --baseline=counts.json
+ * Options:
+ *   --reps=N          measured repetitions of each workload (default 10)
+ *   --warmup=N        unmeasured repetitions before them (default 2)
+ *   --scale=F         multiplies the size of every workload (default 1)
+ *   --only=NAME       runs a single workload
+ *   --baseline=FILE   compares the medians with a previous output, exits with 1 on a regression
+ *   --threshold=PCT   slowdown reported as a regression (default 10), if also above 3 MADs
+ *   --min-ms=T        phases below T milliseconds, now and in the baseline, are too noisy to be
+ *                     checked (default 5)
+ *   --counts          runs each workload once and writes its operation counts instead of its times;
+ *                     with --baseline, any count above the previous one is a regression
+ * Workloads:
+ *   arith          a counting loop of integer arithmetic
+ *   arith-limits   arith with limits on statements, time and memory that are never hit
+ *   list           fills a list, then scans it by index
+ *   list-limits    list with the same limits
+ *   elif           a long if/elif chain selected in a loop
+ *   deep           a deeply nested expression evaluated in a loop
+ *   flat           a large program of straight-line assignments
+ * The output of a limited workload also has the overhead of the limits on its execution, relative
+ * to the same workload without limits: with --baseline, an overhead more than the threshold above
+ * the previous one is a regression.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lexer.h"
+#include "interpreter.h"
+#include "stats.h"
+
+// Phases timed for every repetition
+enum BenchPhase {
+    LEX_PHASE,
+    PARSE_PHASE,
+    EXECUTE_PHASE,
+    TOTAL_PHASE,
+    BENCH_PHASES
+};
+
+static const char* const PhaseName[BENCH_PHASES] = {"lex", "parse", "execute", "total"};
+
+// Names of the operation counts, in the order of countValues()
+#define COUNT_KINDS 8
+static const char* const CountName[COUNT_KINDS] = {"statements", "iterations", "expressions", "type_checks",
+                                                   "symbol_lookups", "list_accesses", "allocations", "allocated_bytes"};
+
+// Limits of the limited workloads, far above what they use
+#define BENCH_MAX_STEPS 1000000000000ULL
+#define BENCH_MAX_MILLISECONDS 3600000
+#define BENCH_MAX_MEMORY (1ULL << 40)
+
+/**
+ * @struct Workload
+ * @brief A generated program to benchmark
+ */
+struct Workload {
+    std::string name;
+    long size;          // main parameter of the generator (iterations, elements, branches...)
+    std::string source;
+    std::string twin;   // workload run without limits, if this one runs with the limits
+};
+
+/**
+ * @struct PhaseSummary
+ * @brief Statistics of the times of one phase over the repetitions
+ */
+struct PhaseSummary {
+    double median; // milliseconds
+    double mad;    // median absolute deviation (milliseconds)
+    double min;    // milliseconds
+};
+
+/**
+ * @brief Generates a counting loop of integer arithmetic
+ * @param iterations The number of iterations
+ * @return The source of the program
+ */
+static std::string generateArith(long iterations) {
+    std::ostringstream out;
+    out << "i = 0\ns = 0\n";
+    out << "while i < " << iterations << ":\n";
+    out << "    s = s + i * 3 - i // 2\n";
+    out << "    if s > 1000000:\n";
+    out << "        s = s - 1000000\n";
+    out << "    i = i + 1\n";
+    out << "print(s)\n";
+    return out.str();
+}
+
+/**
+ * @brief Generates a program filling a list and summing it by index
+ * @param elements The number of elements
+ * @return The source of the program
+ */
+static std::string generateList(long elements) {
+    std::ostringstream out;
+    out << "a = list()\ni = 0\n";
+    out << "while i < " << elements << ":\n";
+    out << "    a.append(i - i // 7 * 7)\n";
+    out << "    i = i + 1\n";
+    out << "s = 0\ni = 0\n";
+    out << "while i < " << elements << ":\n";
+    out << "    s = s + a[i]\n";
+    out << "    i = i + 1\n";
+    out << "print(s)\n";
+    return out.str();
+}
+
+/**
+ * @brief Generates an if/elif chain selected by a counter in a loop
+ * @param branches The number of branches of the chain
+ * @return The source of the program
+ */
+static std::string generateElif(long branches) {
+    std::ostringstream out;
+    out << "i = 0\ns = 0\n";
+    out << "while i < 20000:\n";
+    out << "    r = i - i // " << branches << " * " << branches << "\n";
+    out << "    if r == 0:\n";
+    out << "        s = s + 1\n";
+    for (long b = 1; b < branches; b++) {
+        out << "    elif r == " << b << ":\n";
+        out << "        s = s + " << b + 1 << "\n";
+    }
+    out << "    i = i + 1\n";
+    out << "print(s)\n";
+    return out.str();
+}
+
+/**
+ * @brief Generates a deeply nested expression evaluated in a loop
+ * @param depth The nesting depth of the expression
+ * @return The source of the program
+ */
+static std::string generateDeep(long depth) {
+    std::ostringstream out;
+    out << "i = 0\ns = 0\n";
+    out << "while i < 200:\n";
+    out << "    s = ";
+    for (long d = 0; d < depth; d++) out << "(i + ";
+    out << "1";
+    for (long d = 0; d < depth; d++) out << ")";
+    out << "\n";
+    out << "    i = i + 1\n";
+    out << "print(s)\n";
+    return out.str();
+}
+
+/**
+ * @brief Generates a large program of straight-line assignments
+ * @param statements The number of assignments
+ * @return The source of the program
+ */
+static std::string generateFlat(long statements) {
+    std::ostringstream out;
+    out << "x0 = 1\n";
+    for (long s = 1; s < statements; s++) {
+        // a bounded set of variables, each one depending on the previous one
+        out << "x" << s % 100 << " = x" << (s - 1) % 100 << " + " << s % 10 << "\n";
+    }
+    out << "print(x" << (statements - 1) % 100 << ")\n";
+    return out.str();
+}
+
+/**
+ * @brief Returns the median of values
+ * @param values The values (reordered)
+ * @return The median
+ */
+static double median(std::vector<double>& values) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+/**
+ * @brief Computes the median, the MAD and the minimum of times
+ * @param times The times (milliseconds)
+ * @return The statistics
+ */
+static PhaseSummary summarize(std::vector<double> times) {
+    PhaseSummary summary;
+    summary.median = median(times);
+    summary.min = times.front();
+    std::vector<double> deviations;
+    for (double t : times) deviations.push_back(std::fabs(t - summary.median));
+    summary.mad = median(deviations);
+    return summary;
+}
+
+/**
+ * @brief Sets the limits of a workload on the visitor running it
+ * @param workload The workload
+ * @param visitor The visitor
+ */
+static void applyLimits(const Workload& workload, Visitor& visitor) {
+    if (workload.twin.empty()) return;
+    ExecutionLimits limits;
+    limits.maxSteps = BENCH_MAX_STEPS;
+    limits.maxMilliseconds = BENCH_MAX_MILLISECONDS;
+    limits.maxMemory = BENCH_MAX_MEMORY;
+    visitor.setLimits(limits);
+}
+
+/**
+ * @brief Lexes, parses and runs a workload once
+ * @param workload The workload
+ * @param times The times of the phases (milliseconds)
+ * @return False if the program failed
+ */
+static bool runOnce(const Workload& workload, double times[BENCH_PHASES]) {
+    typedef std::chrono::steady_clock Clock;
+    auto ms = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    try {
+        auto start = Clock::now();
+        std::istringstream input(workload.source);
+        Lexer lexer(input);
+        std::vector<Token*> tokens = lexer();
+        auto lexed = Clock::now();
+        CompiledProgram program(std::move(tokens), false);
+        program.parse();
+        auto parsed = Clock::now();
+        // the output is discarded, only the cost of formatting it is measured
+        OutputSink output([](const char*, size_t) {}, FLUSH_ON_SIZE);
+        Visitor visitor(program.getProgram(), output);
+        applyLimits(workload, visitor);
+        visitor();
+        output.flush();
+        auto executed = Clock::now();
+        times[LEX_PHASE] = ms(start, lexed);
+        times[PARSE_PHASE] = ms(lexed, parsed);
+        times[EXECUTE_PHASE] = ms(parsed, executed);
+        times[TOTAL_PHASE] = ms(start, executed);
+    } catch (const Error& e) {
+        std::cerr << workload.name << ": " << Diagnostic::fromError(e).toString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Lexes, parses and runs a workload once, counting its operations
+ * @param workload The workload
+ * @param values The counts, in the order of CountName
+ * @return False if the program failed
+ */
+static bool countOnce(const Workload& workload, uint64_t values[COUNT_KINDS]) {
+    uint64_t allocations = Stats::getThreadAllocations();
+    uint64_t allocatedBytes = Stats::getThreadAllocatedBytes();
+    OperationCounts counts;
+    try {
+        std::istringstream input(workload.source);
+        Lexer lexer(input);
+        std::vector<Token*> tokens = lexer();
+        CompiledProgram program(std::move(tokens), false);
+        program.parse();
+        OutputSink output([](const char*, size_t) {}, FLUSH_ON_SIZE);
+        Visitor visitor(program.getProgram(), output);
+        applyLimits(workload, visitor);
+        visitor();
+        output.flush();
+        counts = visitor.getOperationCounts();
+    } catch (const Error& e) {
+        std::cerr << workload.name << ": " << Diagnostic::fromError(e).toString() << std::endl;
+        return false;
+    }
+    // The allocations include the destruction of the program, like the ones of the interpreter
+    counts.allocations = Stats::getThreadAllocations() - allocations;
+    counts.allocatedBytes = Stats::getThreadAllocatedBytes() - allocatedBytes;
+    uint64_t all[COUNT_KINDS] = {counts.statements, counts.iterations, counts.expressions, counts.typeChecks,
+                                 counts.symbolLookups, counts.listAccesses, counts.allocations, counts.allocatedBytes};
+    std::copy(all, all + COUNT_KINDS, values);
+    return true;
+}
+
+/**
+ * @brief Reads a count of a workload from a previous output of --counts
+ * @param baseline The previous output
+ * @param name The name of the workload
+ * @param count The name of the count
+ * @param value The count
+ * @return False if the workload or the count is missing
+ */
+static bool findCount(const std::string& baseline, const std::string& name, const char* count, uint64_t& value) {
+    size_t begin = baseline.find("\"name\":\"" + name + "\"");
+    if (begin == std::string::npos) return false;
+    size_t end = baseline.find("\"name\":", begin + 1);
+    size_t at = baseline.find("\"" + std::string(count) + "\":", begin);
+    if (at == std::string::npos || at > end) return false;
+    value = std::strtoull(baseline.c_str() + at + std::string(count).size() + 3, nullptr, 10);
+    return true;
+}
+
+/**
+ * @brief Reads the median of a phase of a workload from a previous output
+ * @param baseline The previous output
+ * @param name The name of the workload
+ * @param phase The name of the phase
+ * @param value The median (milliseconds)
+ * @return False if the workload or the phase is missing
+ */
+static bool findBaseline(const std::string& baseline, const std::string& name, const char* phase, double& value) {
+    // The output has one object per workload: search the phase between its name and the next one
+    size_t begin = baseline.find("\"name\":\"" + name + "\"");
+    if (begin == std::string::npos) return false;
+    size_t end = baseline.find("\"name\":", begin + 1);
+    size_t at = baseline.find("\"" + std::string(phase) + "\":{\"median_ms\":", begin);
+    if (at == std::string::npos || at > end) return false;
+    value = std::atof(baseline.c_str() + baseline.find(':', baseline.find("median_ms", at)) + 1);
+    return true;
+}
+
+/**
+ * @brief Reads the overhead of the limits on a workload from a previous output
+ * @param baseline The previous output
+ * @param name The name of the workload
+ * @param value The overhead (percent)
+ * @return False if the workload or its overhead is missing
+ */
+static bool findOverhead(const std::string& baseline, const std::string& name, double& value) {
+    size_t begin = baseline.find("\"name\":\"" + name + "\"");
+    if (begin == std::string::npos) return false;
+    size_t end = baseline.find("\"name\":", begin + 1);
+    size_t at = baseline.find("\"limits_overhead_pct\":", begin);
+    if (at == std::string::npos || at > end) return false;
+    value = std::atof(baseline.c_str() + baseline.find(':', at) + 1);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    long reps = 10;
+    long warmup = 2;
+    double scale = 1;
+    double threshold = 10;
+    double minMs = 5;
+    std::string only;
+    std::string baselinePath;
+    bool countsMode = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--reps=", 0) == 0) reps = std::max(1L, std::atol(arg.c_str() + 7));
+        else if (arg.rfind("--warmup=", 0) == 0) warmup = std::max(0L, std::atol(arg.c_str() + 9));
+        else if (arg.rfind("--scale=", 0) == 0) scale = std::atof(arg.c_str() + 8);
+        else if (arg.rfind("--only=", 0) == 0) only = arg.substr(7);
+        else if (arg.rfind("--baseline=", 0) == 0) baselinePath = arg.substr(11);
+        else if (arg.rfind("--threshold=", 0) == 0) threshold = std::atof(arg.c_str() + 12);
+        else if (arg.rfind("--min-ms=", 0) == 0) minMs = std::atof(arg.c_str() + 9);
+        else if (arg == "--counts") countsMode = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--reps=N] [--warmup=N] [--scale=F] [--only=NAME] [--baseline=FILE] [--threshold=PCT] [--min-ms=T] [--counts]" << std::endl;
+            return 2;
+        }
+    }
+    auto scaled = [scale](long size) { return std::max(1L, static_cast<long>(size * scale)); };
+
+    std::vector<Workload> workloads;
+    workloads.push_back(Workload{"arith", scaled(300000), "", ""});
+    workloads.push_back(Workload{"arith-limits", scaled(300000), "", "arith"});
+    workloads.push_back(Workload{"list", scaled(200000), "", ""});
+    workloads.push_back(Workload{"list-limits", scaled(200000), "", "list"});
+    workloads.push_back(Workload{"elif", scaled(40), "", ""});
+    workloads.push_back(Workload{"deep", scaled(2000), "", ""});
+    workloads.push_back(Workload{"flat", scaled(50000), "", ""});
+    for (Workload& w : workloads) {
+        // a limited workload runs the program of its twin
+        const std::string& kind = w.twin.empty() ? w.name : w.twin;
+        if (kind == "arith") w.source = generateArith(w.size);
+        else if (kind == "list") w.source = generateList(w.size);
+        else if (kind == "elif") w.source = generateElif(w.size);
+        else if (kind == "deep") w.source = generateDeep(w.size);
+        else w.source = generateFlat(w.size);
+    }
+
+    std::string baseline;
+    if (!baselinePath.empty()) {
+        std::ifstream in(baselinePath);
+        if (!in) {
+            std::cerr << "Cannot open baseline " << baselinePath << std::endl;
+            return 2;
+        }
+        baseline.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    bool failed = false;
+    size_t regressions = 0;
+
+    // Operation counts: a single run, compared exactly with the baseline
+    if (countsMode) {
+        std::cout << "{\"counts\":[";
+        bool first = true;
+        for (const Workload& w : workloads) {
+            if (!only.empty() && w.name != only) continue;
+            uint64_t values[COUNT_KINDS];
+            if (!countOnce(w, values)) {
+                failed = true;
+                continue;
+            }
+            std::cout << (first ? "\n" : ",\n") << "{\"name\":\"" << w.name << "\",\"size\":" << w.size;
+            first = false;
+            std::cerr << std::left << std::setw(13) << w.name << std::right;
+            for (int c = 0; c < COUNT_KINDS; c++) {
+                std::cout << ",\"" << CountName[c] << "\":" << values[c];
+                std::cerr << "  " << CountName[c] << " " << values[c];
+                uint64_t previous;
+                if (!baseline.empty() && findCount(baseline, w.name, CountName[c], previous) && values[c] != previous) {
+                    std::cerr << std::showpos << " (" << int64_t(values[c] - previous) << ")" << std::noshowpos;
+                    if (values[c] > previous) {
+                        std::cerr << " REGRESSION";
+                        regressions++;
+                    }
+                }
+            }
+            std::cout << "}";
+            std::cerr << std::endl;
+        }
+        std::cout << "\n]}" << std::endl;
+        if (regressions) {
+            std::cerr << regressions << " count(s) above the baseline" << std::endl;
+        }
+        return failed || regressions ? 1 : 0;
+    }
+
+    // execution medians of the workloads run so far, for the overhead of the limits
+    std::vector<std::pair<std::string, double>> executed;
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "{\"reps\":" << reps << ",\"warmup\":" << warmup << ",\"benchmarks\":[";
+    bool first = true;
+    for (const Workload& w : workloads) {
+        if (!only.empty() && w.name != only) continue;
+        std::vector<double> times[BENCH_PHASES];
+        double run[BENCH_PHASES];
+        for (long r = 0; r < warmup + reps; r++) {
+            if (!runOnce(w, run)) {
+                failed = true;
+                break;
+            }
+            if (r < warmup) continue;
+            for (int p = 0; p < BENCH_PHASES; p++) times[p].push_back(run[p]);
+        }
+        if (times[TOTAL_PHASE].empty()) continue;
+
+        std::cout << (first ? "\n" : ",\n") << "{\"name\":\"" << w.name << "\",\"size\":" << w.size
+                  << ",\"source_bytes\":" << w.source.size() << ",\"phases\":{";
+        first = false;
+        std::cerr << std::left << std::setw(13) << w.name << std::right;
+        for (int p = 0; p < BENCH_PHASES; p++) {
+            PhaseSummary s = summarize(times[p]);
+            std::cout << (p ? "," : "") << "\"" << PhaseName[p] << "\":{\"median_ms\":" << s.median
+                      << ",\"mad_ms\":" << s.mad << ",\"min_ms\":" << s.min << "}";
+            std::cerr << std::fixed << std::setprecision(3) << "  " << PhaseName[p] << " " << s.median << " ms (MAD " << s.mad << ")";
+
+            // A regression must be larger than the threshold and than the noise of this run, on a
+            // phase long enough to be timed reliably
+            double previous;
+            if (!baseline.empty() && findBaseline(baseline, w.name, PhaseName[p], previous) && previous > 0) {
+                double change = 100 * (s.median - previous) / previous;
+                std::cerr << std::showpos << " " << std::setprecision(1) << change << "%" << std::noshowpos;
+                if (std::max(s.median, previous) < minMs) {
+                    std::cerr << " (below " << minMs << " ms)";
+                } else if (change > threshold && s.median - previous > 3 * s.mad) {
+                    std::cerr << " REGRESSION";
+                    regressions++;
+                }
+            }
+        }
+        std::cout << "}";
+
+        // Overhead of the limits over the same execution without them
+        PhaseSummary execution = summarize(times[EXECUTE_PHASE]);
+        auto twin = std::find_if(executed.begin(), executed.end(),
+                                 [&w](const std::pair<std::string, double>& e) { return e.first == w.twin; });
+        if (twin != executed.end() && twin->second > 0) {
+            double overhead = 100 * (execution.median - twin->second) / twin->second;
+            std::cout << ",\"limits_overhead_pct\":" << overhead;
+            std::cerr << std::showpos << std::setprecision(1) << "  limits " << overhead << "%" << std::noshowpos;
+            double previous;
+            if (!baseline.empty() && findOverhead(baseline, w.name, previous)) {
+                std::cerr << " (was " << previous << "%)";
+                if (twin->second < minMs) {
+                    std::cerr << " (below " << minMs << " ms)";
+                } else if (overhead - previous > threshold && execution.median - twin->second > 3 * execution.mad) {
+                    std::cerr << " REGRESSION";
+                    regressions++;
+                }
+            }
+        }
+        executed.push_back(std::make_pair(w.name, execution.median));
+        std::cout << "}";
+        std::cerr << std::endl;
+    }
+    std::cout << "\n]}" << std::endl;
+    if (regressions) {
+        std::cerr << regressions << " regression(s) above " << threshold << "%" << std::endl;
+    }
+    return failed || regressions ? 1 : 0;
+}
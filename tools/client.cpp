@@ -0,0 +1,57 @@
+/**
+ * @file client.cpp
+ * @brief Client of the server mode of the Python-Sublanguage interpreter
+ *
+ * Sends a script to a server started with --serve=SOCKET and behaves like a local run:
+ * the output goes to stdout, the error message to stderr and the exit status is the one
+ * of the script, e.g.:
+ *   psl_client /tmp/psl.sock program.py
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include "protocol.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <socket> <file>" << std::endl;
+        return 2;
+    }
+    std::ifstream file(argv[2]);
+    if (!file.is_open()) {
+        std::cerr << "Could not open input file: " << argv[2] << std::endl;
+        return 2;
+    }
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    int fd = connectSocket(argv[1]);
+    if (fd < 0 || !writeRequest(fd, source)) {
+        std::cerr << "Could not send the script to " << argv[1] << std::endl;
+        return 2;
+    }
+
+    // Copy the frames of the answer until the exit status
+    char type;
+    std::string payload;
+    while (readFrame(fd, type, payload)) {
+        if (type == OUTPUT_FRAME) {
+            std::cout.write(payload.data(), payload.size());
+        } else if (type == ERROR_FRAME && payload.size() >= 4) {
+            std::cout.flush();
+            std::cerr << payload.substr(4) << std::endl;
+        } else if (type == EXIT_FRAME && payload.size() == 4) {
+            close(fd);
+            std::cout.flush();
+            return static_cast<int>(getU32(payload.data()));
+        }
+    }
+    close(fd);
+    std::cerr << "Connection closed by the server" << std::endl;
+    return 2;
+}
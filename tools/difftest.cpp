@@ -0,0 +1,418 @@
+/**
+ * @file difftest.cpp
+ * @brief Differential tester of the Python-Sublanguage interpreter against CPython
+ *
+ * Runs scripts through the interpreter and through python3, checks that both print the same
+ * output and succeed or fail together, and reports the speed ratio of each script, e.g.:
+ *   psl_difftest --interpreter=build/interpreter --corpus=tests --random=500 --seed=7
+ * Options:
+ *   --interpreter=PATH   interpreter under test (default build/interpreter)
+ *   --python=PATH        reference interpreter (default python3)
+ *   --corpus=DIR         runs every .py file of a directory
+ *   --random=N           runs N random programs generated within the grammar (default 100)
+ *   --seed=S             seed of the generator (default 1)
+ *   --keep=DIR           saves the generated programs whose results differ
+ *   --divergent          also generates the constructs known to differ from Python (see below)
+ *   --verbose            prints one line per script, not only the mismatches
+ *
+ * The generated programs only use the subset where this language and Python agree:
+ * - values stay far from the 32-bit range of the interpreter;
+ * - the operand of 'not' is always parenthesized ('not' binds tighter than comparisons here);
+ * - lists are only declared outside loops (declaring a list twice is an error here).
+ * Unless --divergent is given, they also avoid the known differences of the execution:
+ * - '//' only takes non-negative operands (the interpreter truncates towards zero, Python floors);
+ * - break statements are only placed directly in loop bodies (nested in an if statement, they
+ *   end the loop only after the rest of the body);
+ * - continue statements are not generated (they do not skip the rest of the body).
+ * The exit status is 1 if any script differs.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @struct ScriptResult
+ * @brief Outcome of one run of a script
+ */
+struct ScriptResult {
+    std::string output; // standard output
+    bool ok;            // exit status 0
+    double ms;          // wall time
+};
+
+/**
+ * @struct GeneratedList
+ * @brief A list of a generated program
+ */
+struct GeneratedList {
+    std::string name;
+    size_t length; // elements certainly appended so far
+};
+
+/**
+ * @class ProgramGenerator
+ * @brief Generator of random terminating programs within the grammar of the parser
+ *
+ * Only variables and list elements certainly defined at a point are read there: names
+ * defined inside a block are forgotten when the block ends. Every while loop is a bounded
+ * counting loop whose counter is incremented first, so continue cannot skip it.
+ */
+class ProgramGenerator{
+    public:
+        // constructors
+        ProgramGenerator() = delete;
+        ProgramGenerator(unsigned seed, bool divergent) : random_(seed), divergent_(divergent) {}
+        ProgramGenerator(ProgramGenerator const& pg) = delete;
+
+        // destructor
+        ~ProgramGenerator() = default;
+
+        // overload () operator to generate a program
+        std::string operator()();
+
+    private:
+        long pick(long low, long high) { return std::uniform_int_distribution<long>(low, high)(random_); }
+        std::string intExpr(int depth);
+        std::string nonNegativeExpr(int depth);
+        std::string boolExpr(int depth);
+        std::string reduced(const std::string& expr);
+        void block(int level, int statements, bool certain);
+        void statement(int level, bool certain);
+        void line(int level, const std::string& text);
+
+        std::mt19937 random_;
+        bool divergent_; // generate the constructs known to differ from Python
+        std::ostringstream out_;
+        std::vector<std::string> ints_;     // readable int variables (values in [0, 1000))
+        std::vector<std::string> bools_;    // readable bool variables
+        std::vector<GeneratedList> lists_;  // readable lists
+        int names_{0};                      // names created so far
+        int loops_{0};                      // enclosing while loops
+        int bodyLevel_{-1};                 // indentation level of the innermost loop body
+};
+
+/**
+ * @brief Generates a program
+ * @return The source of the program
+ */
+std::string ProgramGenerator::operator()() {
+    out_.str("");
+    ints_.clear();
+    bools_.clear();
+    lists_.clear();
+    names_ = 0;
+    loops_ = 0;
+    bodyLevel_ = -1;
+    block(0, pick(5, 40), true);
+    // Print the final state, so differences in stores are seen as well
+    for (const std::string& id : ints_) line(0, "print(" + id + ")");
+    for (const std::string& id : bools_) line(0, "print(" + id + ")");
+    return out_.str();
+}
+
+/**
+ * @brief Generates an int expression whose magnitude stays below 1000 * 5^depth
+ * @param depth The largest nesting depth
+ * @return The expression
+ */
+std::string ProgramGenerator::intExpr(int depth) {
+    switch (depth > 0 ? pick(0, 6) : pick(0, 2)) {
+        case 0: return std::to_string(pick(0, 20));
+        case 1:
+        case 2: return nonNegativeExpr(0);
+        case 3: return "(" + intExpr(depth - 1) + " + " + intExpr(depth - 1) + ")";
+        case 4: return "(" + intExpr(depth - 1) + " - " + intExpr(depth - 1) + ")";
+        case 5: return "-" + intExpr(depth - 1);
+        default:
+            if (divergent_) return "(" + intExpr(depth - 1) + " // " + std::to_string(pick(1, 9)) + ")";
+            return "(" + intExpr(depth - 1) + " * " + std::to_string(pick(0, 5)) + ")";
+    }
+}
+
+/**
+ * @brief Generates a non-negative int expression (the only operands of '//')
+ * @param depth The largest nesting depth
+ * @return The expression
+ */
+std::string ProgramGenerator::nonNegativeExpr(int depth) {
+    long choice = depth > 0 ? pick(0, 5) : pick(0, 2);
+    if (choice == 1 && !ints_.empty()) return ints_[pick(0, ints_.size() - 1)];
+    if (choice == 2 && !lists_.empty()) {
+        const GeneratedList& list = lists_[pick(0, lists_.size() - 1)];
+        if (list.length) return list.name + "[" + std::to_string(pick(0, list.length - 1)) + "]";
+    }
+    switch (choice) {
+        case 3: return "(" + nonNegativeExpr(depth - 1) + " + " + nonNegativeExpr(depth - 1) + ")";
+        case 4: return "(" + nonNegativeExpr(depth - 1) + " * " + std::to_string(pick(0, 5)) + ")";
+        case 5: return "(" + nonNegativeExpr(depth - 1) + " // " + std::to_string(pick(1, 9)) + ")";
+        default: return std::to_string(pick(0, 20));
+    }
+}
+
+/**
+ * @brief Generates a bool expression
+ * @param depth The largest nesting depth
+ * @return The expression
+ */
+std::string ProgramGenerator::boolExpr(int depth) {
+    static const char* const comparisons[] = {"<", "<=", ">", ">=", "==", "!="};
+    long choice = depth > 0 ? pick(0, 7) : pick(0, 2);
+    if (choice == 1 && !bools_.empty()) return bools_[pick(0, bools_.size() - 1)];
+    switch (choice) {
+        case 2:
+        case 3: return "(" + intExpr(depth) + " " + comparisons[pick(0, 5)] + " " + intExpr(depth) + ")";
+        case 4: return "(" + boolExpr(depth - 1) + " and " + boolExpr(depth - 1) + ")";
+        case 5: return "(" + boolExpr(depth - 1) + " or " + boolExpr(depth - 1) + ")";
+        case 6: return "(not (" + boolExpr(depth - 1) + "))";
+        case 7: return "(" + boolExpr(depth - 1) + " == " + boolExpr(depth - 1) + ")";
+        default: return pick(0, 1) ? "True" : "False";
+    }
+}
+
+/**
+ * @brief Reduces an int expression to [0, 1000), so that stored values stay small
+ * @param expr The expression (its magnitude is below 1000000)
+ * @return The reduced expression
+ */
+std::string ProgramGenerator::reduced(const std::string& expr) {
+    std::string shifted = "(" + expr + " + 1000000)";
+    return shifted + " - " + shifted + " // 1000 * 1000";
+}
+
+/**
+ * @brief Generates the statements of a block, then forgets the names it defined
+ * @param level The indentation level
+ * @param statements The number of statements
+ * @param certain The block is certainly executed once (appends extend the known lengths)
+ */
+void ProgramGenerator::block(int level, int statements, bool certain) {
+    size_t ints = ints_.size();
+    size_t bools = bools_.size();
+    size_t lists = lists_.size();
+    std::vector<size_t> lengths;
+    for (const GeneratedList& list : lists_) lengths.push_back(list.length);
+    for (int i = 0; i < statements; i++) {
+        statement(level, certain);
+    }
+    if (level > 0) {
+        ints_.resize(ints);
+        bools_.resize(bools);
+        lists_.resize(lists);
+        if (!certain) {
+            for (size_t i = 0; i < lists; i++) lists_[i].length = lengths[i];
+        }
+    }
+}
+
+/**
+ * @brief Generates one statement (compound statements are rarer in deeper blocks)
+ * @param level The indentation level
+ * @param certain The statement is certainly executed once
+ */
+void ProgramGenerator::statement(int level, bool certain) {
+    long choice = pick(0, level < 3 ? 11 : 8);
+    if (choice == 0 || (choice <= 2 && ints_.empty())) {
+        std::string id = "v" + std::to_string(names_++);
+        line(level, id + " = " + reduced(intExpr(2)));
+        ints_.push_back(id);
+    } else if (choice <= 2) {
+        line(level, ints_[pick(0, ints_.size() - 1)] + " = " + reduced(intExpr(3)));
+    } else if (choice == 3) {
+        std::string id = bools_.empty() || pick(0, 1) ? "b" + std::to_string(names_++) : bools_[pick(0, bools_.size() - 1)];
+        line(level, id + " = " + boolExpr(2));
+        if (std::find(bools_.begin(), bools_.end(), id) == bools_.end()) bools_.push_back(id);
+    } else if (choice == 4 && loops_ == 0) {
+        // Declared outside loops: declaring a list twice is an error of this language
+        std::string id = "l" + std::to_string(names_++);
+        line(level, id + " = list()");
+        lists_.push_back(GeneratedList{id, 0});
+    } else if (choice == 5 && !lists_.empty()) {
+        GeneratedList& list = lists_[pick(0, lists_.size() - 1)];
+        line(level, list.name + ".append(" + reduced(intExpr(2)) + ")");
+        if (certain) list.length++;
+    } else if (choice == 6 && !lists_.empty() && lists_.back().length) {
+        GeneratedList& list = lists_.back();
+        line(level, list.name + "[" + std::to_string(pick(0, list.length - 1)) + "] = " + reduced(intExpr(2)));
+    } else if (choice <= 7) {
+        line(level, "print(" + (pick(0, 2) ? intExpr(2) : boolExpr(2)) + ")");
+    } else if (choice == 8 && level == bodyLevel_) {
+        line(level, "break");
+    } else if (choice == 8 && divergent_ && loops_ > 0) {
+        // Leave or restart the loop under a condition
+        line(level, "if " + boolExpr(1) + ":");
+        line(level + 1, pick(0, 1) ? "break" : "continue");
+    } else if (choice <= 9) {
+        line(level, "if " + boolExpr(2) + ":");
+        block(level + 1, pick(1, 4), false);
+        long elifs = pick(0, 2);
+        for (long i = 0; i < elifs; i++) {
+            line(level, "elif " + boolExpr(2) + ":");
+            block(level + 1, pick(1, 3), false);
+        }
+        if (pick(0, 1)) {
+            line(level, "else:");
+            block(level + 1, pick(1, 3), false);
+        }
+    } else {
+        std::string counter = "c" + std::to_string(names_++);
+        line(level, counter + " = 0");
+        line(level, "while " + counter + " < " + std::to_string(pick(0, 6)) + ":");
+        line(level + 1, counter + " = " + counter + " + 1");
+        int bodyLevel = bodyLevel_;
+        loops_++;
+        bodyLevel_ = level + 1;
+        block(level + 1, pick(1, 5), false);
+        bodyLevel_ = bodyLevel;
+        loops_--;
+        ints_.push_back(counter);
+    }
+}
+
+/**
+ * @brief Writes one indented line of the program
+ * @param level The indentation level
+ * @param text The line
+ */
+void ProgramGenerator::line(int level, const std::string& text) {
+    out_ << std::string(4 * level, ' ') << text << "\n";
+}
+
+/**
+ * @brief Runs a script with an interpreter, capturing its standard output
+ * @param interpreter The interpreter
+ * @param path The script
+ * @return The outcome of the run
+ */
+static ScriptResult runScript(const std::string& interpreter, const std::string& path) {
+    ScriptResult result{"", false, 0};
+    auto start = std::chrono::steady_clock::now();
+    std::string command = interpreter + " '" + path + "' 2>/dev/null";
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe) return result;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        result.output.append(buffer, n);
+    }
+    int status = pclose(pipe);
+    result.ok = status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    std::string interpreter = "build/interpreter";
+    std::string python = "python3";
+    std::string corpus;
+    std::string keep;
+    long randomCount = 100;
+    unsigned seed = 1;
+    bool divergent = false;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--interpreter=", 0) == 0) interpreter = arg.substr(14);
+        else if (arg.rfind("--python=", 0) == 0) python = arg.substr(9);
+        else if (arg.rfind("--corpus=", 0) == 0) corpus = arg.substr(9);
+        else if (arg.rfind("--random=", 0) == 0) randomCount = std::max(0L, std::atol(arg.c_str() + 9));
+        else if (arg.rfind("--seed=", 0) == 0) seed = std::strtoul(arg.c_str() + 7, nullptr, 10);
+        else if (arg.rfind("--keep=", 0) == 0) keep = arg.substr(7);
+        else if (arg == "--divergent") divergent = true;
+        else if (arg == "--verbose") verbose = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--interpreter=PATH] [--python=PATH] [--corpus=DIR] [--random=N] [--seed=S] [--keep=DIR] [--divergent] [--verbose]" << std::endl;
+            return 2;
+        }
+    }
+
+    // Scripts of the corpus, then the generated ones (written to a temporary file)
+    std::vector<std::string> paths;
+    if (!corpus.empty()) {
+        DIR* dir = opendir(corpus.c_str());
+        if (!dir) {
+            std::cerr << "Cannot open corpus " << corpus << std::endl;
+            return 2;
+        }
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, ".py") == 0) paths.push_back(corpus + "/" + name);
+        }
+        closedir(dir);
+        std::sort(paths.begin(), paths.end());
+    }
+    char generatedPath[] = "/tmp/psl_difftest_XXXXXX.py";
+    int fd = mkstemps(generatedPath, 3);
+    if (fd < 0) {
+        std::cerr << "Cannot create a temporary file" << std::endl;
+        return 2;
+    }
+    close(fd);
+
+    ProgramGenerator generator(seed, divergent);
+    size_t compared = 0;
+    size_t bothFailed = 0;
+    size_t mismatches = 0;
+    double logRatios = 0;
+    for (size_t i = 0; i < paths.size() + randomCount; i++) {
+        std::string path;
+        std::string name;
+        std::string source;
+        if (i < paths.size()) {
+            path = name = paths[i];
+        } else {
+            source = generator();
+            std::ofstream(generatedPath) << source;
+            path = generatedPath;
+            name = "random #" + std::to_string(i - paths.size()) + " (seed " + std::to_string(seed) + ")";
+        }
+        ScriptResult psl = runScript(interpreter, path);
+        ScriptResult reference = runScript(python, path);
+
+        // Scripts rejected by both are not compared: the error messages differ by design
+        if (!psl.ok && !reference.ok) {
+            bothFailed++;
+            if (verbose) std::cout << name << ": both failed" << std::endl;
+            continue;
+        }
+        compared++;
+        double ratio = reference.ms / std::max(psl.ms, 1e-3);
+        logRatios += std::log(ratio);
+        if (psl.ok != reference.ok || psl.output != reference.output) {
+            mismatches++;
+            std::cout << name << ": MISMATCH (" << (psl.ok ? "ok" : "failed") << " vs python " << (reference.ok ? "ok" : "failed") << ")";
+            if (!keep.empty() && !source.empty()) {
+                std::string kept = keep + "/mismatch_" + std::to_string(seed) + "_" + std::to_string(i - paths.size()) + ".py";
+                std::ofstream(kept) << source;
+                std::cout << ", saved to " << kept;
+            }
+            std::cout << std::endl;
+        } else if (verbose) {
+            std::cout << name << ": ok, " << std::fixed << std::setprecision(2) << psl.ms << " ms vs python "
+                      << reference.ms << " ms (" << ratio << "x)" << std::endl;
+        }
+    }
+    unlink(generatedPath);
+
+    std::cout << compared << " compared, " << bothFailed << " failed in both, " << mismatches << " mismatches";
+    if (compared) {
+        std::cout << ", geometric mean speedup over python " << std::fixed << std::setprecision(2) << std::exp(logRatios / compared) << "x";
+    }
+    std::cout << std::endl;
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file loadtest.cpp
+ * @brief Load tester of the server mode of the Python-Sublanguage interpreter
+ *
+ * Opens several connections to a server started with --serve=SOCKET, sends the same script
+ * repeatedly on each one and reports the throughput and the latency percentiles, e.g.:
+ *   psl_loadtest /tmp/psl.sock program.py 8 1000
+ * runs 1000 requests on each of 8 connections.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "protocol.h"
+
+/**
+ * @brief Sends the script repeatedly on one connection, recording the latency of each request
+ * @param socketPath The path of the socket of the server
+ * @param source The script
+ * @param requests The number of requests
+ * @param latencies The latencies of the requests (microseconds)
+ * @return False if the connection failed
+ */
+static bool runClient(const std::string& socketPath, const std::string& source, long requests, std::vector<double>& latencies) {
+    int fd = connectSocket(socketPath);
+    if (fd < 0) return false;
+    char type;
+    std::string payload;
+    for (long i = 0; i < requests; i++) {
+        auto start = std::chrono::steady_clock::now();
+        if (!writeRequest(fd, source)) {
+            close(fd);
+            return false;
+        }
+        // the answer is complete at the exit frame
+        do {
+            if (!readFrame(fd, type, payload)) {
+                close(fd);
+                return false;
+            }
+        } while (type != EXIT_FRAME);
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    close(fd);
+    return true;
+}
+
+/**
+ * @brief Returns a percentile of sorted latencies (nearest rank)
+ * @param sorted The sorted latencies
+ * @param p The percentile, between 0 and 100
+ * @return The latency at the percentile
+ */
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <socket> <file> [connections] [requests per connection]" << std::endl;
+        return 2;
+    }
+    std::ifstream file(argv[2]);
+    if (!file.is_open()) {
+        std::cerr << "Could not open input file: " << argv[2] << std::endl;
+        return 2;
+    }
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    long connections = argc > 3 ? std::max(1L, std::atol(argv[3])) : 4;
+    long requests = argc > 4 ? std::max(1L, std::atol(argv[4])) : 1000;
+
+    std::vector<std::vector<double>> latencies(connections);
+    std::vector<char> failed(connections, 0);
+    std::vector<std::thread> clients;
+    auto start = std::chrono::steady_clock::now();
+    for (long c = 0; c < connections; c++) {
+        clients.emplace_back([&, c] { failed[c] = !runClient(argv[1], source, requests, latencies[c]); });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (long c = 0; c < connections; c++) {
+        if (failed[c]) {
+            std::cerr << "Connection " << c << " failed" << std::endl;
+            return 1;
+        }
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+    }
+    std::sort(all.begin(), all.end());
+    std::cout << "requests: " << all.size() << " on " << connections << " connections in " << seconds << " s ("
+              << all.size() / seconds << " requests/s)" << std::endl;
+    std::cout << "latency (us): p50 " << percentile(all, 50) << ", p99 " << percentile(all, 99)
+              << ", max " << all.back() << std::endl;
+    return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file scale.cpp
+ * @brief Scalability sweep of the Python-Sublanguage interpreter
+ *
+ * Generates programs of growing size along independent axes, measures the lexing, parsing and
+ * execution time and the peak memory of each one in a child process, and fails when the growth
+ * since the first significant size is superlinear beyond a bound, e.g.:
+ *   psl_scale --axis=identifiers --bound=1.3
+ * Axes (all the programs run each statement once, so the work is linear in their size):
+ *   statements   straight-line assignments, 1k to 1M statements
+ *   parens       one expression nested in parentheses, depth 1k to 1M
+ *   blocks       nested if blocks (one space of indentation per level), depth 250 to 8k
+ *   identifiers  assignments and reads of distinct variables, 10 to 1M identifiers
+ * Options:
+ *   --axis=NAME   sweeps a single axis (default all)
+ *   --max=N       skips the sizes above N
+ *   --bound=E     largest growth exponent allowed (default 1.3): a phase whose time or a run whose
+ *                 peak memory grows faster than (source bytes)^E fails
+ *   --min-ms=T    times below T milliseconds are too noisy to be checked (default 20)
+ *   --reps=N      runs of each program, the fastest one is kept (default 3)
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "lexer.h"
+#include "interpreter.h"
+
+/**
+ * @struct SweepPoint
+ * @brief Measures of one program of a sweep
+ */
+struct SweepPoint {
+    long size;          // value of the swept parameter
+    size_t bytes;       // size of the source
+    double lexMs;
+    double parseMs;
+    double executeMs;
+    long peakRssKb;     // peak resident memory of the child process
+    bool ok;            // the child ran the program successfully
+};
+
+/**
+ * @brief Generates a program along an axis
+ * @param axis The name of the axis
+ * @param size The value of the swept parameter
+ * @return The source of the program
+ */
+static std::string generate(const std::string& axis, long size) {
+    std::ostringstream out;
+    if (axis == "statements") {
+        out << "x0 = 1\n";
+        for (long s = 1; s < size; s++) {
+            out << "x" << s % 100 << " = x" << (s - 1) % 100 << " + 1\n";
+        }
+    } else if (axis == "parens") {
+        out << "x = ";
+        for (long d = 0; d < size; d++) out << "(1 + ";
+        out << "1";
+        for (long d = 0; d < size; d++) out << ")";
+        out << "\n";
+    } else if (axis == "blocks") {
+        for (long d = 0; d < size; d++) out << std::string(d, ' ') << "if True:\n";
+        out << std::string(size, ' ') << "x = 1\n";
+    } else {
+        for (long i = 0; i < size; i++) out << "v" << i << " = " << i % 1000 << "\n";
+        out << "s = 0\n";
+        for (long i = 0; i < size; i++) out << "s = v" << i << " - s\n";
+    }
+    return out.str();
+}
+
+/**
+ * @brief Lexes, parses and runs a program in a child process
+ * @param source The program
+ * @param point The measures (times and peak memory)
+ */
+static void measure(const std::string& source, SweepPoint& point) {
+    point.ok = false;
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+    if (pid == 0) {
+        // Child: the peak memory is only the one of this program
+        close(fds[0]);
+        typedef std::chrono::steady_clock Clock;
+        double ms[3] = {0, 0, 0};
+        int ok = 1;
+        try {
+            auto start = Clock::now();
+            std::istringstream input(source);
+            Lexer lexer(input);
+            std::vector<Token*> tokens = lexer();
+            auto lexed = Clock::now();
+            CompiledProgram program(std::move(tokens), false);
+            program.parse();
+            auto parsed = Clock::now();
+            OutputSink output([](const char*, size_t) {}, FLUSH_ON_SIZE);
+            Visitor visitor(program.getProgram(), output);
+            visitor();
+            output.flush();
+            auto executed = Clock::now();
+            ms[0] = std::chrono::duration<double, std::milli>(lexed - start).count();
+            ms[1] = std::chrono::duration<double, std::milli>(parsed - lexed).count();
+            ms[2] = std::chrono::duration<double, std::milli>(executed - parsed).count();
+        } catch (const Error& e) {
+            std::cerr << Diagnostic::fromError(e).toString() << std::endl;
+            ok = 0;
+        }
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        long rss = usage.ru_maxrss;
+        if (write(fds[1], ms, sizeof(ms)) != sizeof(ms) || write(fds[1], &rss, sizeof(rss)) != sizeof(rss) ||
+            write(fds[1], &ok, sizeof(ok)) != sizeof(ok)) {
+            _exit(1);
+        }
+        // the tree is not destroyed: the process ends here
+        _exit(0);
+    }
+    close(fds[1]);
+    double ms[3];
+    long rss;
+    int ok;
+    bool received = read(fds[0], ms, sizeof(ms)) == sizeof(ms) && read(fds[0], &rss, sizeof(rss)) == sizeof(rss) &&
+                    read(fds[0], &ok, sizeof(ok)) == sizeof(ok);
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (!received) return;
+    point.lexMs = ms[0];
+    point.parseMs = ms[1];
+    point.executeMs = ms[2];
+    point.peakRssKb = rss;
+    point.ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Returns the growth exponent of a measure between two points
+ * @param previous The measure at the previous point
+ * @param current The measure at the current point
+ * @param ratio The ratio of the source sizes
+ * @return The exponent e such that current = previous * ratio^e
+ */
+static double exponent(double previous, double current, double ratio) {
+    return std::log(std::max(current, 1e-9) / std::max(previous, 1e-9)) / std::log(ratio);
+}
+
+int main(int argc, char* argv[]) {
+    std::string only;
+    long max = 0;
+    double bound = 1.3;
+    double minMs = 20;
+    long reps = 3;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--axis=", 0) == 0) only = arg.substr(7);
+        else if (arg.rfind("--max=", 0) == 0) max = std::atol(arg.c_str() + 6);
+        else if (arg.rfind("--bound=", 0) == 0) bound = std::atof(arg.c_str() + 8);
+        else if (arg.rfind("--min-ms=", 0) == 0) minMs = std::atof(arg.c_str() + 9);
+        else if (arg.rfind("--reps=", 0) == 0) reps = std::max(1L, std::atol(arg.c_str() + 7));
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--axis=statements|parens|blocks|identifiers] [--max=N] [--bound=E] [--min-ms=T] [--reps=N]" << std::endl;
+            return 2;
+        }
+    }
+
+    struct Axis {
+        const char* name;
+        std::vector<long> sizes;
+    };
+    std::vector<Axis> axes = {
+        {"statements", {1000, 4000, 16000, 64000, 256000, 1024000}},
+        {"parens", {1000, 4000, 16000, 64000, 256000, 1024000}},
+        {"blocks", {250, 500, 1000, 2000, 4000, 8000}},
+        {"identifiers", {10, 100, 1000, 10000, 100000, 1000000}},
+    };
+
+    size_t failures = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const Axis& axis : axes) {
+        if (!only.empty() && only != axis.name) continue;
+        std::cout << axis.name << std::endl;
+        std::cout << std::setw(10) << "size" << std::setw(12) << "bytes" << std::setw(12) << "lex ms" << std::setw(12) << "parse ms"
+                  << std::setw(12) << "exec ms" << std::setw(12) << "rss kB" << "  growth exponents (lex parse exec rss)" << std::endl;
+        std::vector<SweepPoint> points;
+        long reference[4] = {-1, -1, -1, -1}; // first significant point of each measure
+        for (long size : axis.sizes) {
+            if (max && size > max) break;
+            std::string source = generate(axis.name, size);
+            SweepPoint point{size, source.size(), 0, 0, 0, 0, false};
+            measure(source, point);
+            for (long r = 1; r < reps && point.ok; r++) {
+                SweepPoint again = point;
+                measure(source, again);
+                point.ok = again.ok;
+                point.lexMs = std::min(point.lexMs, again.lexMs);
+                point.parseMs = std::min(point.parseMs, again.parseMs);
+                point.executeMs = std::min(point.executeMs, again.executeMs);
+            }
+            std::cout << std::setw(10) << size << std::setw(12) << point.bytes;
+            if (!point.ok) {
+                std::cout << "  FAILED" << std::endl;
+                failures++;
+                break;
+            }
+            std::cout << std::setw(12) << point.lexMs << std::setw(12) << point.parseMs << std::setw(12) << point.executeMs
+                      << std::setw(12) << point.peakRssKb;
+            // Growth since the first point where each measure is significant: small times are
+            // noise and small programs hide behind the baseline memory of the process. A single
+            // step (e.g. a working set leaving a cache) is amortized over the following sizes.
+            double measures[4] = {point.lexMs, point.parseMs, point.executeMs, double(point.peakRssKb)};
+            bool significant[4] = {point.lexMs >= minMs, point.parseMs >= minMs, point.executeMs >= minMs,
+                                   !points.empty() && point.peakRssKb > 2 * points.front().peakRssKb};
+            bool superlinear = false;
+            std::cout << " ";
+            for (int m = 0; m < 4; m++) {
+                if (reference[m] < 0 && significant[m]) {
+                    reference[m] = points.size();
+                }
+                if (reference[m] < 0 || size_t(reference[m]) == points.size()) {
+                    std::cout << std::setw(6) << "-";
+                    continue;
+                }
+                const SweepPoint& first = points[reference[m]];
+                double firstMeasures[4] = {first.lexMs, first.parseMs, first.executeMs, double(first.peakRssKb)};
+                double e = exponent(firstMeasures[m], measures[m], double(point.bytes) / first.bytes);
+                std::cout << std::setw(6) << e;
+                if (e > bound) superlinear = true;
+            }
+            if (superlinear) {
+                std::cout << "  SUPERLINEAR";
+                failures++;
+            }
+            std::cout << std::endl;
+            points.push_back(point);
+        }
+    }
+    if (failures) {
+        std::cout << failures << " point(s) above the complexity bound " << bound << " or failed" << std::endl;
+    }
+    return failures ? 1 : 0;
+}
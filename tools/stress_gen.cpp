@@ -0,0 +1,119 @@
+/**
+ * @file stress_gen.cpp
+ * @brief Generator of deeply nested programs for stress testing the interpreter
+ *
+ * Writes to the standard output a program of the Python-Sublanguage whose nesting depth
+ * grows with the given parameter, e.g.:
+ *   stress_gen parens 1000000 > parens.py
+ * Kinds of nesting:
+ *   parens  right-nested parenthesized additions: (1 + (1 + (... + (1))))
+ *   unary   chains of unary operators: - - - 1 and not not not True
+ *   index   nested list indexes: a[a[a[... a[0] ...]]]
+ *   elif    a single if statement with a long elif chain
+ *   blocks  nested if blocks (the size of the indentation grows quadratically)
+ *   while   nested while loops, each one running once
+ *   loop    a single counting loop running depth iterations (overhead of the execution limits:
+ *           compare a run without limits and one with --max-steps, --max-time and --max-memory
+ *           set high enough not to be hit)
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Prints the usage message of the generator
+ * @param name The name of the executable
+ */
+static void usage(const char* name) {
+    std::cerr << "Usage: " << name << " <parens|unary|index|elif|blocks|while|loop> <depth>" << std::endl;
+}
+
+/**
+ * @brief Writes the indentation of a nested line (one space per level)
+ * @param out The output stream
+ * @param level The nesting level of the line
+ */
+static void indent(std::ostream& out, long level) {
+    for (long i = 0; i < level; i++) out << ' ';
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    std::string kind = argv[1];
+    long depth = std::stol(argv[2]);
+    if (depth < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    std::ostream& out = std::cout;
+
+    if (kind == "parens") {
+        // Evaluates to depth + 1
+        out << "x = ";
+        for (long i = 0; i < depth; i++) out << "(1 + ";
+        out << "(1)";
+        for (long i = 0; i < depth; i++) out << ")";
+        out << "\nprint(x)\n";
+    }
+    else if (kind == "unary") {
+        // Evaluates to 1 or -1 and to True or False depending on the parity of the depth
+        out << "print(";
+        for (long i = 0; i < depth; i++) out << "- ";
+        out << "1)\nprint(";
+        for (long i = 0; i < depth; i++) out << "not ";
+        out << "True)\n";
+    }
+    else if (kind == "index") {
+        // Every element of the list is 0, so every index is in range
+        out << "a = list()\na.append(0)\nprint(";
+        for (long i = 0; i < depth; i++) out << "a[";
+        out << "0";
+        for (long i = 0; i < depth; i++) out << "]";
+        out << ")\n";
+    }
+    else if (kind == "elif") {
+        // Only the last condition is true
+        out << "x = " << depth << "\nif x == 0:\n    print(0)\n";
+        for (long i = 1; i <= depth; i++) {
+            out << "elif x == " << i << ":\n    print(" << i << ")\n";
+        }
+        out << "else:\n    print(-1)\n";
+    }
+    else if (kind == "blocks") {
+        for (long i = 0; i < depth; i++) {
+            indent(out, i);
+            out << "if True:\n";
+        }
+        indent(out, depth);
+        out << "print(" << depth << ")\n";
+    }
+    else if (kind == "while") {
+        // Each loop runs its body once and leaves with a break
+        for (long i = 0; i < depth; i++) {
+            indent(out, i);
+            out << "while True:\n";
+        }
+        indent(out, depth);
+        out << "print(" << depth << ")\n";
+        for (long i = depth; i > 0; i--) {
+            indent(out, i);
+            out << "break\n";
+        }
+    }
+    else if (kind == "loop") {
+        // Sums the first depth integers, appending them to a list
+        out << "i = 0\ns = 0\na = list()\nwhile i < " << depth << ":\n";
+        out << "    s = s + i\n    a.append(i)\n    i = i + 1\nprint(s)\n";
+    }
+    else {
+        usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file tracer.cpp
+ * @brief Implements the trace recorder of the Python-Sublanguage interpreter
+ *
+ * This file contains the implementation of the Tracer class.
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include "tracer.h"
+#include "profiler.h"
+
+/**
+ * @brief Constructs a tracer and preallocates its buffer
+ * @param capacity The number of spans kept
+ * @param loopSampling Record one execution of a while statement every loopSampling (0 for none)
+ */
+Tracer::Tracer(size_t capacity, uint64_t loopSampling) : capacity_(std::max<size_t>(1, capacity)), loopSampling_(loopSampling) {
+    // Only reserved: the pages of the buffer are touched as the spans are recorded
+    buffer_.reserve(capacity_);
+    originNs_ = now();
+}
+
+/**
+ * @brief Begins a phase of the run
+ * @param name The name of the phase (a string literal)
+ */
+void Tracer::beginPhase(const char* name) {
+    push(PHASE_SPAN, name, nullptr, true);
+}
+
+/**
+ * @brief Ends the innermost phase
+ */
+void Tracer::endPhase() {
+    pop();
+}
+
+/**
+ * @brief Ends the spans still open (after an error)
+ */
+void Tracer::finish() {
+    while (!open_.empty()) {
+        pop();
+    }
+    statementOpen_ = false;
+}
+
+/**
+ * @brief Begins a top-level statement, ending the previous one
+ * @param stmt The statement
+ */
+void Tracer::enterStatement(Statement* stmt) {
+    exitStatement();
+    push(STATEMENT_SPAN, nullptr, stmt, true);
+    statementOpen_ = true;
+}
+
+/**
+ * @brief Ends the top-level statement being executed, if any
+ */
+void Tracer::exitStatement() {
+    if (statementOpen_) {
+        pop();
+        statementOpen_ = false;
+    }
+}
+
+/**
+ * @brief Begins the execution of a while statement
+ * @param ws The while statement
+ */
+void Tracer::enterLoop(CompoundStatement* ws) {
+    // Unsampled loops are still pushed, so that iterate() and exitLoop() find their span
+    bool recorded = loopSampling_ && loops_++ % loopSampling_ == 0;
+    push(LOOP_SPAN, nullptr, ws, recorded);
+}
+
+/**
+ * @brief Ends the execution of the innermost while statement
+ */
+void Tracer::exitLoop() {
+    pop();
+}
+
+/**
+ * @brief Writes the recorded spans as a Chrome trace-event JSON object
+ * @param out The output stream
+ */
+void Tracer::write(std::ostream& out) const {
+    size_t count = buffer_.size();
+    // The oldest span kept is the next one to be overwritten once the buffer is full
+    size_t first = recorded_ > count ? next_ : 0;
+    out << "{\"traceEvents\":[";
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < count; i++) {
+        const TraceSpan& span = buffer_[(first + i) % count];
+        out << (i ? ",\n" : "\n") << "{\"name\":\"";
+        if (span.kind == PHASE_SPAN) out << span.name;
+        else out << Profiler::getFrameName(span.stmt);
+        out << "\",\"cat\":\"" << (span.kind == PHASE_SPAN ? "phase" : span.kind == STATEMENT_SPAN ? "statement" : "loop")
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << span.startNs / 1e3 << ",\"dur\":" << span.durationNs / 1e3;
+        if (span.kind != PHASE_SPAN) {
+            out << ",\"args\":{\"line\":" << Profiler::getSourceLine(span.stmt);
+            if (span.kind == LOOP_SPAN) out << ",\"iterations\":" << span.iterations;
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"spans\":" << recorded_
+        << ",\"overwritten\":" << recorded_ - count << "}}" << std::endl;
+}
+
+/**
+ * @brief Returns the time of a monotonic clock
+ * @return The time in nanoseconds
+ */
+uint64_t Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Opens a span
+ * @param kind The kind of the span
+ * @param name The name of the span (phases only)
+ * @param stmt The statement of the span (statements and loops only)
+ * @param recorded The span goes to the buffer when it ends
+ */
+void Tracer::push(SpanKind kind, const char* name, Statement* stmt, bool recorded) {
+    open_.push_back(TraceSpan{kind, name, stmt, recorded ? now() - originNs_ : 0, 0, 0, recorded});
+}
+
+/**
+ * @brief Closes the innermost span and stores it in the ring buffer
+ */
+void Tracer::pop() {
+    if (open_.empty()) {
+        return;
+    }
+    TraceSpan span = open_.back();
+    open_.pop_back();
+    if (!span.recorded) {
+        return;
+    }
+    span.durationNs = now() - originNs_ - span.startNs;
+    if (buffer_.size() < capacity_) {
+        buffer_.push_back(span);
+    } else {
+        buffer_[next_] = span;
+    }
+    next_ = (next_ + 1) % capacity_;
+    recorded_++;
+}
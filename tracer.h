@@ -0,0 +1,98 @@
+#if !defined(TRACER_H)
+#define TRACER_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "syntax.h"
+
+/**
+ * @file tracer.h
+ * @brief Defines the trace recorder of the Python-Sublanguage interpreter
+ *
+ * This file contains the declaration of the Tracer class, which records the phases of a run,
+ * its top-level statements and its while loops as spans in a ring buffer, and writes them in
+ * the Chrome trace-event format (readable by chrome://tracing and Perfetto).
+ *
+ * @author Pietro Malerba (S5839759)
+ * @date 08-2025
+ */
+
+// Default number of spans kept by the ring buffer (older spans are overwritten)
+#define TRACE_CAPACITY (1 << 20)
+
+/**
+ * @enum SpanKind
+ * @brief Kinds of the spans of a trace
+ */
+enum SpanKind {
+    PHASE_SPAN,     // lexing, parsing, execution
+    STATEMENT_SPAN, // top-level statement
+    LOOP_SPAN       // execution of a while statement (all of its iterations)
+};
+
+/**
+ * @struct TraceSpan
+ * @brief One complete span of the trace
+ */
+struct TraceSpan {
+    SpanKind kind;
+    const char* name;    // name of the phase (phases only)
+    Statement* stmt;     // statement of the span (statements and loops only)
+    uint64_t startNs;    // start time, relative to the creation of the tracer
+    uint64_t durationNs;
+    uint64_t iterations; // iterations of the loop (loops only)
+    bool recorded;       // the span goes to the buffer (loops are sampled)
+};
+
+/**
+ * @class Tracer
+ * @brief Recorder of spans driven by main() and by the Visitor
+ *
+ * Spans are kept in a preallocated ring buffer and only formatted when the trace is written,
+ * so recording a span costs two readings of the clock. One loop execution every loopSampling
+ * is recorded (0 records no loop), to bound the cost of programs running many short loops.
+ */
+class Tracer{
+    public:
+        // constructors
+        Tracer() = delete;
+        Tracer(size_t capacity, uint64_t loopSampling);
+        Tracer(Tracer const& t) = delete;
+
+        // destructor
+        ~Tracer() = default;
+
+        // methods called by main()
+        void beginPhase(const char* name);
+        void endPhase();
+        void finish();
+
+        // methods called by the Visitor
+        void enterStatement(Statement* stmt);
+        void exitStatement();
+        void enterLoop(CompoundStatement* ws);
+        void iterate() { open_.back().iterations++; }
+        void exitLoop();
+
+        // method to write the trace
+        void write(std::ostream& out) const;
+
+    private:
+        static uint64_t now();
+        void push(SpanKind kind, const char* name, Statement* stmt, bool recorded);
+        void pop();
+
+        size_t capacity_;               // largest number of spans kept
+        std::vector<TraceSpan> buffer_; // ring buffer of the complete spans
+        size_t next_{0};                // position of the next span in the buffer
+        uint64_t recorded_{0};          // spans recorded so far, including the overwritten ones
+        std::vector<TraceSpan> open_;   // spans not complete yet, from the outermost one
+        bool statementOpen_{false};     // a top-level statement span is open
+        uint64_t loopSampling_;
+        uint64_t loops_{0};             // executions of while statements so far
+        uint64_t originNs_;             // time of the creation of the tracer
+};
+
+
+#endif
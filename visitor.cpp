@@ -13,6 +13,7 @@
 #include "syntax.h"
 #include "error.h"
 #include <iostream>
+#include <algorithm>
 
 /**
  * @brief Adds a variable to the symbol table
@@ -139,14 +140,207 @@ bool Visitor::isAlreadyDefined(std::string id) {
  * @brief Visits the entire program and performs semantic analysis
  */
 void Visitor::visitProgram() {
-    // Visit each statement in the program
-    for(auto stmt : program_->getStatements()) {
-        visitStatement(stmt);
+    start();
+    execute(UINT64_MAX);
+}
+
+/**
+ * @brief Prepares the execution of the program without running any statement
+ */
+void Visitor::start() {
+    // The bottom frame runs the statements of the program
+    frames_.push_back(ExecutionFrame{&program_->getStatements(), 0, false, nullptr, false});
+    // Without limits the checkpoint is never reached, so the loops only pay for the budget check
+    if (limits_.maxMilliseconds) {
+        deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits_.maxMilliseconds);
+    }
+    limitCheckpoint_ = (limits_.maxSteps || limits_.maxMilliseconds) ? 0 : UINT64_MAX;
+}
+
+/**
+ * @brief Runs the program until it ends or its budget is spent
+ * @param budget The number of statements and loop iterations after which the run may be suspended
+ * @return True if the program ended, false if it was suspended
+ */
+bool Visitor::resume(uint64_t budget) {
+    return execute(budget);
+}
+
+/**
+ * @brief Runs the program until it ends or its budget is spent, including the statements added
+ * to the program since the run last ended
+ *
+ * The bottom frame is removed when the run ends, so it is pushed again on the statements not
+ * run yet (after start(), the bottom frame is still there).
+ * @param budget The number of statements and loop iterations after which the run may be suspended
+ * @return True if the statements of the program so far ended, false if the run was suspended
+ */
+bool Visitor::extend(uint64_t budget) {
+    if (frames_.empty()) {
+        frames_.push_back(ExecutionFrame{&program_->getStatements(), ranStatements_, false, nullptr, false});
+    }
+    bool ended = execute(budget);
+    if (ended) {
+        ranStatements_ = program_->getStatements().size();
+    }
+    return ended;
+}
+
+/**
+ * @brief Runs the frames on the execution stack until it is empty or the budget is spent
+ *
+ * Compound statements do not recurse: an if statement pushes the block it selects and a while
+ * statement pushes a loop frame, which pushes its body once per iteration.
+ * The budget is only checked at the back-edges of loops and after print statements, where the
+ * state of the execution is entirely on the stacks.
+ * @param budget The number of statements and loop iterations after which the run may be suspended
+ * @return True if the stack is empty, false if the run was suspended
+ */
+bool Visitor::execute(uint64_t budget) {
+    uint64_t suspendAt = steps_ + std::min(budget, UINT64_MAX - steps_);
+    uint64_t checkpoint = std::min(suspendAt, limitCheckpoint_);
+    while (!frames_.empty()) {
+        ExecutionFrame& frame = frames_.back();
+
+        // Loop frames: check the condition and run the body once more, or leave the loop
+        if (frame.loop) {
+            // Back-edge: suspend or check the limits before the next check of the condition
+            if (steps_ >= checkpoint) {
+                if (steps_ >= suspendAt) {
+                    return false;
+                }
+                checkLimits(frame.loop);
+                checkpoint = std::min(suspendAt, limitCheckpoint_);
+            }
+            steps_++;
+            counts_.iterations++;
+            CompoundStatement* ws = frame.loop;
+            if (sampleSlot_) sampleSlot_->store(ws, std::memory_order_relaxed);
+            if (visitWhileStatement(ws)) {
+                frames_.push_back(ExecutionFrame{&static_cast<SimpleBlock*>(ws->getBlocks()[0])->getStatements(), 0, true, nullptr, false});
+                if (tracer_) tracer_->iterate();
+            } else {
+                // Remove the level of the loop from the loopStack_
+                loopStack_.pop_back();
+                frames_.pop_back();
+                if (profiler_) profiler_->exit();
+                if (tracer_) tracer_->exitLoop();
+            }
+            continue;
+        }
+
+        // Block frames: the block ends after its last statement
+        if (frame.next >= frame.statements->size()) {
+            if (frame.endsStatement) profiler_->exit();
+            frames_.pop_back();
+            continue;
+        }
+        Statement* stmt = (*frame.statements)[frame.next++];
+        steps_++;
+        counts_.statements++;
+        if (profiler_) profiler_->enter(stmt);
+        if (sampleSlot_) sampleSlot_->store(stmt, std::memory_order_relaxed);
+        // The bottom frame holds the top-level statements of the program
+        if (tracer_ && frames_.size() == 1) tracer_->enterStatement(stmt);
+        if (perf_ && frames_.size() == 1) perf_->enterStatement(stmt, counts_.statements);
+
+        // Break and continue statements directly in the body of a loop
+        if (frame.loopBody) {
+            // If a break statement was encountered, exit the body and mark the loop as broken
+            if (stmt->getStatementType() == StatementType::BREAK_STMT) {
+                if (profiler_) profiler_->exit();
+                loopStack_.back() = false;
+                frames_.pop_back();
+                continue;
+            }
+            // If a continue statement was encountered, skip to the next statement
+            else if (stmt->getStatementType() == StatementType::CONTINUE_STMT) {
+                if (profiler_) profiler_->exit();
+                continue;
+            }
+        }
+
+        if (stmt->getStatementType() == StatementType::IF_STMT) {
+            // Run the block selected by the conditions, if any (the if statement ends with it)
+            Block* block = visitIfStatement(static_cast<CompoundStatement*>(stmt));
+            if (block) {
+                frames_.push_back(ExecutionFrame{&static_cast<SimpleBlock*>(block)->getStatements(), 0, false, nullptr, profiler_ != nullptr});
+            } else if (profiler_) {
+                profiler_->exit();
+            }
+        }
+        else if (stmt->getStatementType() == StatementType::WHILE_STMT) {
+            CompoundStatement* ws = static_cast<CompoundStatement*>(stmt);
+            if (!ws->getExpression()) {
+                throw InternalError(ws->getLine(), ws->getColumn(), "Null condition in while statement");
+            }
+            // Adds a new level to the loopStack_ (the while statement ends with its loop frame)
+            loopStack_.push_back(true);
+            frames_.push_back(ExecutionFrame{nullptr, 0, false, ws, false});
+            if (tracer_) tracer_->enterLoop(ws);
+        }
+        else {
+            visitStatement(stmt);
+            if (profiler_) profiler_->exit();
+            // After a print statement the run can be suspended as well
+            if (steps_ >= suspendAt && stmt->getStatementType() == StatementType::PRINT_STMT) {
+                return false;
+            }
+        }
+    }
+    if (tracer_) tracer_->exitStatement();
+    if (perf_) perf_->exitStatement(counts_.statements);
+    return true;
+}
+
+/**
+ * @brief Returns the work done so far by the run
+ * @return The counts of the Visitor and of the symbol table (allocations are left at 0)
+ */
+OperationCounts Visitor::getOperationCounts() const {
+    OperationCounts counts = counts_;
+    counts.symbolLookups = symbolTable_.getLookupCount();
+    counts.listAccesses = symbolTable_.getElementAccessCount();
+    return counts;
+}
+
+/**
+ * @brief Checks the statement and time limits, then schedules the next check
+ *
+ * The clock is read once every LIMIT_CHECK_INTERVAL steps at most.
+ * @param loop The while statement at whose back-edge the limits are checked (errors point to its condition)
+ */
+void Visitor::checkLimits(CompoundStatement* loop) {
+    Expression* condition = loop->getExpression();
+    if (limits_.maxSteps && steps_ >= limits_.maxSteps) {
+        throw LimitError(condition->getLine(), condition->getColumn(), "Statement limit exceeded (" + std::to_string(limits_.maxSteps) + ")");
+    }
+    if (limits_.maxMilliseconds && std::chrono::steady_clock::now() >= deadline_) {
+        throw LimitError(condition->getLine(), condition->getColumn(), "Time limit exceeded (" + std::to_string(limits_.maxMilliseconds) + " ms)");
+    }
+    limitCheckpoint_ = UINT64_MAX;
+    if (limits_.maxSteps) {
+        limitCheckpoint_ = limits_.maxSteps;
+    }
+    if (limits_.maxMilliseconds) {
+        limitCheckpoint_ = std::min(limitCheckpoint_, steps_ + LIMIT_CHECK_INTERVAL);
     }
 }
 
 /**
- * @brief Visits a statement and dispatches to the appropriate visit method based on the statement type
+ * @brief Checks the memory limit after a list has grown
+ * @param stmt The statement that made the list grow
+ */
+void Visitor::checkMemory(Statement* stmt) {
+    if (limits_.maxMemory && symbolTable_.getMemoryUsage() > limits_.maxMemory) {
+        throw LimitError(stmt->getLine(), stmt->getColumn(), "Memory limit exceeded (" + std::to_string(limits_.maxMemory) + " bytes)");
+    }
+}
+
+/**
+ * @brief Visits a simple statement and dispatches to the appropriate visit method based on the statement type
+ *
+ * Compound statements are run by execute(), which owns the execution stack.
  * @param stmt The statement to visit
  */
 void Visitor::visitStatement(Statement* stmt) {
@@ -163,12 +357,6 @@ void Visitor::visitStatement(Statement* stmt) {
         case PRINT_STMT:
             visitPrintStatement(static_cast<PrintStatement*>(stmt));
             break;
-        case IF_STMT:
-            visitIfStatement(static_cast<CompoundStatement*>(stmt));
-            break;
-        case WHILE_STMT:
-            visitWhileStatement(static_cast<CompoundStatement*>(stmt));
-            break;
         case BREAK_STMT:
             visitBreakStatement(static_cast<BreakStatement*>(stmt));
             break;
@@ -206,24 +394,21 @@ void Visitor::visitAssignmentStatement(AssignmentStatement* as) {
         throw InternalError(as->getLine(), as->getColumn(), "Null expression in assignment statement");
     }
 
-    EvaluatedElement* value = eval(expr);
-    if (!value) {
-        throw InternalError(expr->getLine(), expr->getColumn(), "Failed to evaluate expression in assignment statement");
-    }
+    EvaluatedElement value = eval(expr);
 
     // Perform the assignment based on the location type
     if (loc->getLocationType() == LocationType::ID) {
         IdLocation* idLoc = static_cast<IdLocation*>(loc);
         std::string id = idLoc->getId();
         if (isVariableDefined(id)) {
-            updateVariable(id, *value, idLoc->getLine(), idLoc->getColumn());
+            updateVariable(id, value, idLoc->getLine(), idLoc->getColumn());
         } else if (isListDefined(id) && !isVariableDefined(id)) {
             // Dynamically delete the existing list and create a new variable
             symbolTable_.clear(id);
-            addVariable(id, *value, idLoc->getLine(), idLoc->getColumn());
+            addVariable(id, value, idLoc->getLine(), idLoc->getColumn());
         } else if (!isAlreadyDefined(id)) {
             // If the variable is not defined, create it
-            addVariable(id, *value, idLoc->getLine(), idLoc->getColumn());
+            addVariable(id, value, idLoc->getLine(), idLoc->getColumn());
         } else {
             throw SemanticError(idLoc->getLine(), idLoc->getColumn(), "Identifier '" + id + "' is not defined");
         }
@@ -238,16 +423,13 @@ void Visitor::visitAssignmentStatement(AssignmentStatement* as) {
         if (!indexExpr) {
             throw InternalError(listElemLoc->getLine(), listElemLoc->getColumn(), "Null index expression in list element location");
         }
-        EvaluatedElement* indexValue = eval(indexExpr);
-        if (!indexValue) {
-            throw InternalError(indexExpr->getLine(), indexExpr->getColumn(), "Failed to evaluate index expression in list element location");
-        }
-        if (indexValue->getType() != Types::TYPE_INT) {
+        EvaluatedElement indexValue = eval(indexExpr);
+        if (indexValue.getType() != Types::TYPE_INT) {
             throw SemanticError(indexExpr->getLine(), indexExpr->getColumn(), "List index must be an integer");
         }
-        int index = indexValue->getIntValue();
+        int index = indexValue.getIntValue();
         // Update the list element at the specified index
-        updateListElement(listId, index, *value);
+        updateListElement(listId, index, value);
     } else {
         throw InternalError(loc->getLine(), loc->getColumn(), "Unknown LocationType in assignment statement");
     }
@@ -278,11 +460,9 @@ void Visitor::visitListAppendStatement(ListAppendStatement* las) {
     if (!expr) {
         throw InternalError(las->getLine(), las->getColumn(), "Null expression in list append statement");
     }
-    EvaluatedElement* value = eval(expr);
-    if (!value) {
-        throw InternalError(expr->getLine(), expr->getColumn(), "Failed to evaluate expression in list append statement");
-    }
-    appendToList(id, *value);
+    EvaluatedElement value = eval(expr);
+    appendToList(id, value);
+    checkMemory(las);
 }
 
 /**
@@ -294,654 +474,616 @@ void Visitor::visitPrintStatement(PrintStatement* ps) {
     if (!expr) {
         throw InternalError(ps->getLine(), ps->getColumn(), "Null expression in print statement");
     }
-    EvaluatedElement* value = eval(expr);
-    if (!value) {
-        throw InternalError(expr->getLine(), expr->getColumn(), "Failed to evaluate expression in print statement");
-    }
+    EvaluatedElement value = eval(expr);
     // Print the value based on its type
-    if (value->getType() == Types::TYPE_INT) {
-        std::cout << value->getIntValue() << std::endl;
-    } else if (value->getType() == Types::TYPE_BOOL) {
-        std::cout << (value->getBoolValue() ? "True" : "False") << std::endl;
+    if (value.getType() == Types::TYPE_INT) {
+        output_.writeInt(value.getIntValue());
+        output_.writeNewline();
+    } else if (value.getType() == Types::TYPE_BOOL) {
+        output_.writeBool(value.getBoolValue());
+        output_.writeNewline();
     } else {
         throw InternalError(expr->getLine(), expr->getColumn(), "Unknown EvaluatedElement type in print statement");
     }
 }
 
 /**
- * @brief Visits an if statement and performs semantic analysis
+ * @brief Visits an if statement and selects the block to be executed
  * @param ifs The if statement to visit
+ * @return The block of the first branch whose condition is true (or the else block), nullptr if there is none
  */
-void Visitor::visitIfStatement(CompoundStatement* ifs) {
+Block* Visitor::visitIfStatement(CompoundStatement* ifs) {
     // Get the condition expression
     Expression* condition = ifs->getExpression();
     if (!condition) {
         throw InternalError(ifs->getLine(), ifs->getColumn(), "Null condition in if statement");
     }
     // Evaluate the condition expression
-    EvaluatedElement* condValue = eval(condition);
-    if (!condValue) {
-        throw InternalError(condition->getLine(), condition->getColumn(), "Failed to evaluate condition in if statement");
-    }
-    // Adds a new level to the conditionMetStack_
-    conditionMetStack_.push_back(false);
+    EvaluatedElement condValue = eval(condition);
 
     // Check that the condition is boolean
-    if (condValue->getType() != Types::TYPE_BOOL) {
+    if (condValue.getType() != Types::TYPE_BOOL) {
         throw SemanticError(condition->getLine(), condition->getColumn(), "If condition must be boolean");
     }
 
-    // If the condition is true, visit the blocks (check the blocktype and executes the corresponding block)
-    if (condValue->getBoolValue()) {
-        conditionMetStack_.back() = true;
-        for (auto block : ifs->getBlocks()) {
-            if (block->getBlockType() == BlockType::SIMPLE_BLOCK) {
-                visitSimpleBlock(static_cast<SimpleBlock*>(block));
-            } else if (block->getBlockType() == BlockType::ELIF_BLOCK) {
-                visitElifBlock(static_cast<ElifBlock*>(block));
-            } else if (block->getBlockType() == BlockType::ELSE_BLOCK) {
-                visitElseBlock(static_cast<ElseBlock*>(block));
-            }
-        }
+    // If the condition is true, the first block is executed
+    if (condValue.getBoolValue()) {
+        return ifs->getBlocks()[0];
     }
 
-    // Check for elif and else blocks
+    // Otherwise check the elif and else blocks in order
     for (auto block : ifs->getBlocks()) {
         if (block->getBlockType() == BlockType::ELIF_BLOCK) {
-            visitElifBlock(static_cast<ElifBlock*>(block));
+            ElifBlock* elifBlock = static_cast<ElifBlock*>(block);
+            Expression* elifCondition = elifBlock->getCondition();
+            if (!elifCondition) {
+                throw InternalError(elifBlock->getLine(), elifBlock->getColumn(), "Null condition in elif block");
+            }
+            // If the condition is true, the block is executed and no further blocks are checked
+            if (eval(elifCondition).getBoolValue()) {
+                return elifBlock->getBlock();
+            }
         } else if (block->getBlockType() == BlockType::ELSE_BLOCK) {
-            visitElseBlock(static_cast<ElseBlock*>(block));
+            return static_cast<ElseBlock*>(block)->getBlock();
         }
     }
-
-    // Remove the last level from the conditionMetStack_
-    conditionMetStack_.pop_back();
+    return nullptr;
 }
 
 /**
- * @brief Visits a simple block and performs semantic analysis
- * @param sb The simple block to visit
+ * @brief Visits a while statement before each iteration
+ * @param ws The while statement to visit
+ * @return true if the body must be executed again, false if the loop is over
  */
-void Visitor::visitSimpleBlock(SimpleBlock* sb) {
-    for (auto stmt : sb->getStatements()) {
-        visitStatement(stmt);
-    }
-}
+bool Visitor::visitWhileStatement(CompoundStatement* ws) {
+    // Evaluate the condition expression
+    Expression* condition = ws->getExpression();
+    EvaluatedElement condValue = eval(condition);
 
-/**
- * @brief Visits an elif block and performs semantic analysis
- * @param elifBlock The elif block to visit
- */
-void Visitor::visitElifBlock(ElifBlock* elifBlock) {
-    // Check if a previous condition was met
-    if (!conditionMetStack_.empty() && conditionMetStack_.back()) {
-        return;
-    }
-    else if (conditionMetStack_.empty()) {
-        throw InternalError(elifBlock->getLine(), elifBlock->getColumn(), "Elif block outside of if statement");
+    // Check that the condition is boolean
+    if (condValue.getType() != Types::TYPE_BOOL) {
+        throw SemanticError(condition->getLine(), condition->getColumn(), "While condition must be boolean");
     }
 
-    // Evaluate the condition expression
-    Expression* condition = elifBlock->getCondition();
-    if (!condition) {
-        throw InternalError(elifBlock->getLine(), elifBlock->getColumn(), "Null condition in elif block");
+    // If the condition is false, exit the loop
+    if (!condValue.getBoolValue()) {
+        return false;
     }
-    EvaluatedElement* condValue = eval(condition);
-    if (!condValue) {
-        throw InternalError(condition->getLine(), condition->getColumn(), "Failed to evaluate condition in elif block");
+
+    // If a break statement was encountered in the previous iteration, exit the loop
+    if (!loopStack_.back()) {
+        return false;
     }
 
-    // If the condition is true, visit the block
-    if (condValue->getBoolValue()) {
-        conditionMetStack_.back() = true;
-        visitSimpleBlock(static_cast<SimpleBlock*>(elifBlock->getBlock()));
-        // Set the conditionMetStack_ to true to prevent further blocks from being executed
-        conditionMetStack_.back() = true;
+    // Check if there is more than one block (which is an error)
+    if (ws->getBlocks().size() != 1) {
+        throw SemanticError(ws->getLine(), ws->getColumn(), "While statement must have exactly one block");
     }
+    return true;
 }
 
 /**
- * @brief Visits an else block and performs semantic analysis
- * @param elseBlock The else block to visit
+ * @brief Visits a break statement
+ * @param bs The break statement to visit
  */
-void Visitor::visitElseBlock(ElseBlock* elseBlock) {
-    // Check if a previous condition was met
-    if (!conditionMetStack_.empty() && conditionMetStack_.back()) {
-        return;
-    }
-    else if (conditionMetStack_.empty()) {
-        throw InternalError(elseBlock->getLine(), elseBlock->getColumn(), "Else block outside of if statement");
+void Visitor::visitBreakStatement(BreakStatement* bs) {
+    // Check if we are inside a loop
+    if (loopStack_.empty()) {
+        throw SemanticError(bs->getLine(), bs->getColumn(), "Break statement not allowed outside of loop");
     }
 
-    // Visit the block
-    visitSimpleBlock(static_cast<SimpleBlock*>(elseBlock->getBlock()));
-    // Set the conditionMetStack_ to true to prevent further blocks from being executed
-    conditionMetStack_.back() = true;
+    // Mark the loop as broken
+    loopStack_.back() = false;
 }
 
 /**
- * @brief Visits a while statement and performs semantic analysis
- * @param ws The while statement to visit
+ * @brief Visits a continue statement
+ * @param cs The continue statement to visit
  */
-void Visitor::visitWhileStatement(CompoundStatement* ws) {
-    // Get the condition expression
-    Expression* condition = ws->getExpression();
-    if (!condition) {
-        throw InternalError(ws->getLine(), ws->getColumn(), "Null condition in while statement");
+void Visitor::visitContinueStatement(ContinueStatement* cs) {
+    // Check if we are inside a loop
+    if (loopStack_.empty()) {
+        throw SemanticError(cs->getLine(), cs->getColumn(), "Continue statement not allowed outside of loop");
     }
+}
 
-    // Adds a new level to the loopStack_
-    loopStack_.push_back(true);
-
-    // Evaluate the condition expression and visit the block while the condition is true
-    while (true) {
-        EvaluatedElement* condValue = eval(condition);
-
-        if (!condValue) {
-            throw InternalError(condition->getLine(), condition->getColumn(), "Failed to evaluate condition in while statement");
-        }
-
-        // Check that the condition is boolean
-        if (condValue->getType() != Types::TYPE_BOOL) {
-            throw SemanticError(condition->getLine(), condition->getColumn(), "While condition must be boolean");
-        }
-
-        // If the condition is false, exit the loop
-        if (!condValue->getBoolValue()) {
-            break;
+/**
+ * @brief Evaluates an expression
+ *
+ * The values are type checked as they are computed, innermost first. When the evaluation
+ * fails, the expression (which has no side effects) is evaluated again with the operands of
+ * its outermost operator type checked before they are evaluated, so that the error reported
+ * is the one of the outermost operator with operands of the wrong type.
+ * @param expr The expression to evaluate
+ * @return The EvaluatedElement holding the value of the expression
+ */
+EvaluatedElement Visitor::eval(Expression* expr) {
+    try {
+        return evalSteps(expr);
+    } catch (const Error&) {
+        checkTypes_ = true;
+        try {
+            evalSteps(expr);
+        } catch (...) {
+            checkTypes_ = false;
+            throw;
         }
+        checkTypes_ = false;
+        throw;
+    }
+}
 
-        // If a break statement was encountered in the previous iteration, exit the loop
-        if (!loopStack_.back()) {
-            break;
-        }
+/**
+ * @brief Evaluates an expression step by step
+ *
+ * The expression is evaluated with an explicit stack of EvaluationFrame objects: each
+ * evaluation method is resumed once per operand and returns the next operand to evaluate,
+ * or nullptr once the result has been pushed on the value stack. The method is re-entrant
+ * (type checking may evaluate list indexes), each call only works above its own base.
+ * @param expr The expression to evaluate
+ * @return The EvaluatedElement holding the value of the expression
+ */
+EvaluatedElement Visitor::evalSteps(Expression* expr) {
+    size_t base = evalStack_.size();
+    size_t valueBase = values_.size();
+    evalStack_.push_back(EvaluationFrame{expr, 0});
+    counts_.expressions++;
 
-        // Check if there is more than one block (which is an error)
-        if (ws->getBlocks().size() != 1) {
-            throw SemanticError(ws->getLine(), ws->getColumn(), "While statement must have exactly one block");
-        }
+    try {
+        while (evalStack_.size() > base) {
+            EvaluationFrame& frame = evalStack_.back();
+            Expression* current = frame.expr;
+            size_t step = frame.step++;
 
-        // Visit the block
-        SimpleBlock* block = static_cast<SimpleBlock*>(ws->getBlocks()[0]);
+            // Once the operands of the outermost operator have the right types, so do all the
+            // operands below it
+            if (checkTypes_ && step == 0 && current->getExprType() != ExpressionType::LITERAL_EXPR && current->getExprType() != ExpressionType::LOAD_EXPR) {
+                checkTypes_ = false;
+                checkOperandTypes(current);
+            }
 
-        // Visit the block manually becase of break and continue statements
-        for (auto stmt : block->getStatements()) {
-            // If a break statement was encountered, exit the loop
-            if (stmt->getStatementType() == StatementType::BREAK_STMT) {
-                loopStack_.back() = false;
-                break;
+            Expression* next = nullptr;
+            switch (current->getExprType()) {
+                case ExpressionType::BINARY_EXPR:
+                    next = evalBinary(static_cast<Binary*>(current), step);
+                    break;
+                case ExpressionType::NARY_EXPR:
+                    next = evalNary(static_cast<Nary*>(current), step);
+                    break;
+                case ExpressionType::UNARY_EXPR:
+                    next = evalUnary(static_cast<Unary*>(current), step);
+                    break;
+                case ExpressionType::LITERAL_EXPR: {
+                    Literal* literal = static_cast<Literal*>(current);
+                    if (literal->getLiteralType() == Types::TYPE_INT) {
+                        values_.push_back(EvaluatedElement(literal->getIntValue()));
+                    } else {
+                        values_.push_back(EvaluatedElement(literal->getBoolValue()));
+                    }
+                    break;
+                }
+                case ExpressionType::LOAD_EXPR:
+                    next = evalLocation(static_cast<Location*>(current), step);
+                    break;
+                default:
+                    throw InternalError(current->getLine(), current->getColumn(), "Unknown ExpressionType");
             }
-            // If a continue statement was encountered, skip to the next iteration
-            else if (stmt->getStatementType() == StatementType::CONTINUE_STMT) {
-                continue;
+
+            // Either descend into the next operand or the expression is complete
+            if (next) {
+                evalStack_.push_back(EvaluationFrame{next, 0});
+                counts_.expressions++;
+            } else {
+                evalStack_.pop_back();
             }
-            visitStatement(stmt);
         }
+    } catch (...) {
+        // Leave the stacks as they were before this call
+        evalStack_.resize(base);
+        values_.erase(values_.begin() + valueBase, values_.end());
+        throw;
     }
 
-    // Remove the last level from the loopStack_
-    loopStack_.pop_back();
+    EvaluatedElement result = values_.back();
+    values_.pop_back();
+    return result;
 }
 
 /**
- * @brief Visits a break statement
- * @param bs The break statement to visit
+ * @brief Type checks the operands of an operator before they are evaluated
+ *
+ * The boolean operators always check their operands first (their evaluation is short-circuited).
+ * @param expr The binary, n-ary or unary expression whose operands are checked
  */
-void Visitor::visitBreakStatement(BreakStatement* bs) {
-    // Check if we are inside a loop
-    if (loopStack_.empty()) {
-        throw SemanticError(bs->getLine(), bs->getColumn(), "Break statement not allowed outside of loop");
+void Visitor::checkOperandTypes(Expression* expr) {
+    if (expr->getExprType() == ExpressionType::BINARY_EXPR) {
+        Binary* binary = static_cast<Binary*>(expr);
+        BinaryOperator op = binary->getOperator();
+        if (op == BinaryOperator::OR_OP || op == BinaryOperator::AND_OP) return;
+        Types leftType = getDataType(binary->getLeft());
+        Types rightType = getDataType(binary->getRight());
+        if (op == BinaryOperator::EQ_OP || op == BinaryOperator::NEQ_OP) {
+            if (leftType == Types::TYPE_UNDEFINED || rightType == Types::TYPE_UNDEFINED || leftType != rightType) {
+                throw TypeError(binary->getLine(), binary->getColumn(), "Operands of '==' and '!=' must be of the same type (int or bool)");
+            }
+        } else if (op == BinaryOperator::LT_OP || op == BinaryOperator::LE_OP || op == BinaryOperator::GT_OP || op == BinaryOperator::GE_OP) {
+            if (leftType != Types::TYPE_INT || rightType != Types::TYPE_INT) {
+                throw TypeError(binary->getLine(), binary->getColumn(), "Operands of '<', '<=', '>', '>=' must be integers");
+            }
+        } else if (leftType != Types::TYPE_INT || rightType != Types::TYPE_INT) {
+            throw TypeError(binary->getLine(), binary->getColumn(), "Operands of arithmetic expressions must be integers");
+        }
+    } else if (expr->getExprType() == ExpressionType::NARY_EXPR) {
+        Nary* nary = static_cast<Nary*>(expr);
+        BinaryOperator first = nary->getOperators()[0];
+        if (first == BinaryOperator::OR_OP || first == BinaryOperator::AND_OP) return;
+        // Every operand is checked before the error is raised
+        bool integers = true;
+        for (auto operand : nary->getOperands()) {
+            integers = getDataType(operand) == Types::TYPE_INT && integers;
+        }
+        if (!integers) {
+            throw TypeError(nary->getLine(), nary->getColumn(), "Operands of arithmetic expressions must be integers");
+        }
+    } else if (expr->getExprType() == ExpressionType::UNARY_EXPR) {
+        Unary* unary = static_cast<Unary*>(expr);
+        Types operandType = getDataType(unary->getOperand());
+        if (unary->getOperator() == UnaryOperator::NOT_OP && operandType != Types::TYPE_BOOL) {
+            throw TypeError(unary->getLine(), unary->getColumn(), "Operand of 'not' must be boolean");
+        }
+        if (unary->getOperator() == UnaryOperator::MINUS_OP && operandType != Types::TYPE_INT) {
+            throw TypeError(unary->getLine(), unary->getColumn(), "Operand of unary '-' must be integer");
+        }
     }
-
-    // Mark the loop as broken
-    loopStack_.back() = false;
 }
 
 /**
- * @brief Visits a continue statement
- * @param cs The continue statement to visit
+ * @brief Evaluates a binary expression one step at a time
+ * @param binary The binary expression to evaluate
+ * @param step The number of times the expression has been resumed
+ * @return The operand to evaluate next, nullptr when the result is on the value stack
  */
-void Visitor::visitContinueStatement(ContinueStatement* cs) {
-    // Check if we are inside a loop
-    if (loopStack_.empty()) {
-        throw SemanticError(cs->getLine(), cs->getColumn(), "Continue statement not allowed outside of loop");
+Expression* Visitor::evalBinary(Binary* binary, size_t step) {
+    BinaryOperator op = binary->getOperator();
+
+    // Boolean operators: both operands are type checked before evaluation, then short-circuited
+    if (op == BinaryOperator::OR_OP || op == BinaryOperator::AND_OP) {
+        if (step == 0) {
+            if (
+                getDataType(binary->getLeft()) != Types::TYPE_BOOL ||
+                getDataType(binary->getRight()) != Types::TYPE_BOOL
+            ) {
+                throw TypeError(binary->getLine(), binary->getColumn(), op == BinaryOperator::OR_OP ? "Operands of 'or' must be boolean" : "Operands of 'and' must be boolean");
+            }
+            return binary->getLeft();
+        }
+        // Short-circuit evaluation: (True) OR (X) = True, (False) AND (X) = False
+        if (step == 1 && values_.back().getBoolValue() != (op == BinaryOperator::OR_OP)) {
+            values_.pop_back();
+            return binary->getRight(); // (False) OR (X) = (X), (True) AND (X) = (X)
+        }
+        return nullptr;
     }
+
+    // Evaluate the left and right expressions
+    if (step == 0) return binary->getLeft();
+    if (step == 1) return binary->getRight();
+    EvaluatedElement rightValue = values_.back();
+    values_.pop_back();
+    EvaluatedElement leftValue = values_.back();
+    values_.pop_back();
+
+    // Equality operators: both sides must be of the same type (int or bool)
+    if (op == BinaryOperator::EQ_OP || op == BinaryOperator::NEQ_OP) {
+        if (leftValue.getType() != rightValue.getType()) {
+            throw TypeError(binary->getLine(), binary->getColumn(), "Operands of '==' and '!=' must be of the same type (int or bool)");
+        }
+        bool equal = (leftValue.getType() == Types::TYPE_BOOL) ?
+            leftValue.getBoolValue() == rightValue.getBoolValue() :
+            leftValue.getIntValue() == rightValue.getIntValue();
+        values_.push_back(EvaluatedElement(op == BinaryOperator::EQ_OP ? equal : !equal));
+        return nullptr;
+    }
+
+    // Relational operators: both sides must be integers
+    if (op == BinaryOperator::LT_OP || op == BinaryOperator::LE_OP || op == BinaryOperator::GT_OP || op == BinaryOperator::GE_OP) {
+        if (leftValue.getType() != Types::TYPE_INT || rightValue.getType() != Types::TYPE_INT) {
+            throw TypeError(binary->getLine(), binary->getColumn(), "Operands of '<', '<=', '>', '>=' must be integers");
+        }
+        int left = leftValue.getIntValue();
+        int right = rightValue.getIntValue();
+        switch (op) {
+            case BinaryOperator::LT_OP: values_.push_back(EvaluatedElement(left < right)); break;
+            case BinaryOperator::LE_OP: values_.push_back(EvaluatedElement(left <= right)); break;
+            case BinaryOperator::GT_OP: values_.push_back(EvaluatedElement(left > right)); break;
+            default: values_.push_back(EvaluatedElement(left >= right)); break;
+        }
+        return nullptr;
+    }
+
+    // Arithmetic operators: both sides must be integers
+    if (leftValue.getType() != Types::TYPE_INT || rightValue.getType() != Types::TYPE_INT) {
+        throw TypeError(binary->getLine(), binary->getColumn(), "Operands of arithmetic expressions must be integers");
+    }
+    int left = leftValue.getIntValue();
+    int right = rightValue.getIntValue();
+    switch (op) {
+        case BinaryOperator::ADD_OP: values_.push_back(EvaluatedElement(left + right)); break;
+        case BinaryOperator::SUB_OP: values_.push_back(EvaluatedElement(left - right)); break;
+        case BinaryOperator::MUL_OP: values_.push_back(EvaluatedElement(left * right)); break;
+        case BinaryOperator::DIV_OP:
+            if (right == 0) {
+                throw ZeroDivisionError(binary->getLine(), binary->getColumn(), "Division by zero");
+            }
+            values_.push_back(EvaluatedElement(left / right));
+            break;
+        default:
+            throw InternalError(binary->getLine(), binary->getColumn(), "Unknown operator in binary expression");
+    }
+    return nullptr;
 }
 
 /**
- * @brief Determines the data type of an expression
- * @param expr The expression to check
- * @return The Types enum value representing the data type of the expression
+ * @brief Evaluates a chain of operators of the same precedence left to right, one operand at a time
+ * @param nary The chain to evaluate
+ * @param step The number of times the chain has been resumed (the operands already evaluated)
+ * @return The operand to evaluate next, nullptr when the result is on the value stack
  */
-EvaluatedElement* Visitor::eval(Expression* expr) {
-    if (expr->getExprType() == ExpressionType::OR_EXPR) {
-        // Downcast to OrExpr
-        OrExpr* orExpr = static_cast<OrExpr*>(expr);
-
-        // Check the type of the expressions (if they aren't boolean, raise an error)
-        if (
-            getDataType(orExpr->getLeft()) != Types::TYPE_BOOL || 
-            getDataType(orExpr->getRight()) != Types::TYPE_BOOL
-        ) {
-            throw TypeError(orExpr->getLine(), orExpr->getColumn(), "Operands of 'or' must be boolean");
-        }
-        // Evaluate the left and right expressions
-        EvaluatedElement* leftValue = eval(orExpr->getLeft());
-        // Short-circuit evaluation
-        if (leftValue->getBoolValue()) {
-            return new EvaluatedElement(true);
-        }
-        // If leftValue is false, evaluate the right expression
-        EvaluatedElement* rightValue = eval(orExpr->getRight());
-        if (!rightValue) {
-            throw InternalError(orExpr->getRight()->getLine(), orExpr->getRight()->getColumn(), "Failed to evaluate right operand of 'or'");
-        }
-        return new EvaluatedElement(rightValue->getBoolValue()); // (False) OR (X) = (X)
-
-    } else if (expr->getExprType() == ExpressionType::JOIN) {
-        // Downcast to Join
-        Join* join = static_cast<Join*>(expr);
-        if (join->getJoinType() == JoinType::AND_JOIN) {
-            AndExpr* andExpr = static_cast<AndExpr*>(join);
-            // Check the type of the expressions (if they aren't boolean, raise an error)
-            if (
-                getDataType(andExpr->getLeft()) != Types::TYPE_BOOL || 
-                getDataType(andExpr->getRight()) != Types::TYPE_BOOL
-            ) {
-                throw TypeError(andExpr->getLine(), andExpr->getColumn(), "Operands of 'and' must be boolean");
-            }
-            // Evaluate the left and right expressions
-            EvaluatedElement* leftValue = eval(andExpr->getLeft());
+Expression* Visitor::evalNary(Nary* nary, size_t step) {
+    std::vector<Expression*> const& operands = nary->getOperands();
+    std::vector<BinaryOperator> const& operators = nary->getOperators();
+    BinaryOperator first = operators[0];
 
-            // Short-circuit evaluation
-            if (!leftValue->getBoolValue()) {
-                return new EvaluatedElement(false);
+    // Boolean chains: every operand is type checked before evaluation, then short-circuited
+    if (first == BinaryOperator::OR_OP || first == BinaryOperator::AND_OP) {
+        if (step == 0) {
+            bool booleans = true;
+            for (auto operand : operands) {
+                booleans = getDataType(operand) == Types::TYPE_BOOL && booleans;
             }
-            // If leftValue is true, evaluate the right expression
-            EvaluatedElement* rightValue = eval(andExpr->getRight());
-            if (!rightValue) {
-                throw InternalError(andExpr->getRight()->getLine(), andExpr->getRight()->getColumn(), "Failed to evaluate right operand of 'and'");
+            if (!booleans) {
+                throw TypeError(nary->getLine(), nary->getColumn(), first == BinaryOperator::OR_OP ? "Operands of 'or' must be boolean" : "Operands of 'and' must be boolean");
             }
-            return new EvaluatedElement(rightValue->getBoolValue()); // (True) AND (X) = (X)
-
-        } else if (join->getJoinType() == JoinType::EQUALITY) {
-            Equality* equality = static_cast<Equality*>(join);
-            if (equality->getEqualityType() == EqualityType::COMP_EQUALITY){
-                EqualExpr* eqExpr = static_cast<EqualExpr*>(equality);
-                // Check that both sides are of the same type (int or bool)
-                Types leftType = getDataType(eqExpr->getLeft());
-                Types rightType = getDataType(eqExpr->getRight());
-                if(leftType == Types::TYPE_UNDEFINED || rightType == Types::TYPE_UNDEFINED || leftType != rightType) {
-                    throw TypeError(eqExpr->getLine(), eqExpr->getColumn(), "Operands of '==' and '!=' must be of the same type (int or bool)");
-                }
-                // Evaluate the left and right expressions
-                EvaluatedElement* leftValue = eval(eqExpr->getLeft());
-                EvaluatedElement* rightValue = eval(eqExpr->getRight());
-                if (!leftValue || !rightValue) {
-                    throw InternalError(eqExpr->getLine(), eqExpr->getColumn(), "Failed to evaluate operands of '=='");
-                }
-                // Get the operator
-                EqualExprType op = eqExpr->getType();
-                if (op == EqualExprType::EQ_EXPR) {
-                    if (leftValue->getType() == Types::TYPE_BOOL) {
-                        return new EvaluatedElement(leftValue->getBoolValue() == rightValue->getBoolValue());
-                    } else if (leftValue->getType() == Types::TYPE_INT) {
-                        return new EvaluatedElement(leftValue->getIntValue() == rightValue->getIntValue());
-                    } else {
-                        throw InternalError(eqExpr->getLine(), eqExpr->getColumn(), "Unknown EvaluatedElement type in '==' expression");
-                    }
-                } else if (op == EqualExprType::NEQ_EXPR) {
-                    if (leftValue->getType() == Types::TYPE_BOOL) {
-                        return new EvaluatedElement(leftValue->getBoolValue() != rightValue->getBoolValue());
-                    } else if (leftValue->getType() == Types::TYPE_INT) {
-                        return new EvaluatedElement(leftValue->getIntValue() != rightValue->getIntValue());
-                    } else {
-                        throw InternalError(eqExpr->getLine(), eqExpr->getColumn(), "Unknown EvaluatedElement type in '!=' expression");
+            return operands[0];
+        }
+        // The first operand that is True for 'or' (False for 'and') decides the result,
+        // otherwise the result is the value of the last operand
+        if (values_.back().getBoolValue() == (first == BinaryOperator::OR_OP) || step == operands.size()) {
+            return nullptr;
+        }
+        values_.pop_back();
+        return operands[step];
+    }
+
+    // Arithmetic chains: accumulate from the left, every operand must be an integer
+    if (step > 0) {
+        EvaluatedElement value = values_.back();
+        if (value.getType() != Types::TYPE_INT) {
+            throw TypeError(nary->getLine(), nary->getColumn(), "Operands of arithmetic expressions must be integers");
+        }
+        // The first operand stays on the value stack as the accumulator
+        if (step > 1) {
+            values_.pop_back();
+            int operand = value.getIntValue();
+            int accumulator = values_.back().getIntValue();
+            switch (operators[step - 2]) {
+                case BinaryOperator::ADD_OP: accumulator += operand; break;
+                case BinaryOperator::SUB_OP: accumulator -= operand; break;
+                case BinaryOperator::MUL_OP: accumulator *= operand; break;
+                case BinaryOperator::DIV_OP:
+                    if (operand == 0) {
+                        throw ZeroDivisionError(nary->getLine(), nary->getColumn(), "Division by zero");
                     }
-                } else {
-                    throw InternalError(eqExpr->getLine(), eqExpr->getColumn(), "Unknown operator in '==' expression");
-                }
+                    accumulator /= operand;
+                    break;
+                default:
+                    throw InternalError(nary->getLine(), nary->getColumn(), "Unknown operator in arithmetic expression");
             }
-            else if (equality->getEqualityType() == EqualityType::REL) {
-                Relation* relation = static_cast<Relation*>(equality);
-                if (relation->getRelType() == RelationType::COMPARATIVE_RELATION) {
-                    ComparativeRelation* compRel = static_cast<ComparativeRelation*>(relation);
-                    // Check that both sides are integers
-                    Types leftType = getDataType(compRel->getLeft());
-                    Types rightType = getDataType(compRel->getRight());
-                    if(leftType != Types::TYPE_INT || rightType != Types::TYPE_INT) {
-                        throw TypeError(compRel->getLine(), compRel->getColumn(), "Operands of '<', '<=', '>', '>=' must be integers");
-                    }
-                    // Evaluate the left and right expressions
-                    EvaluatedElement* leftValue = eval(compRel->getLeft());
-                    EvaluatedElement* rightValue = eval(compRel->getRight());
-                    if (!leftValue || !rightValue) {
-                        throw InternalError(compRel->getLine(), compRel->getColumn(), "Failed to evaluate operands of relational expression");
-                    }
+            values_.back().setIntValue(accumulator);
+        }
+    }
+    return step < operands.size() ? operands[step] : nullptr;
+}
 
-                    // Get the operator
-                    ComparativeRelationType op = compRel->getType();
-                    if (op == ComparativeRelationType::LT_REL) {
-                        return new EvaluatedElement(leftValue->getIntValue() < rightValue->getIntValue());
-                    } else if (op == ComparativeRelationType::LE_REL) {
-                        return new EvaluatedElement(leftValue->getIntValue() <= rightValue->getIntValue());
-                    } else if (op == ComparativeRelationType::GT_REL) {
-                        return new EvaluatedElement(leftValue->getIntValue() > rightValue->getIntValue());
-                    } else if (op == ComparativeRelationType::GE_REL) {
-                        return new EvaluatedElement(leftValue->getIntValue() >= rightValue->getIntValue());
-                    } else {
-                        throw InternalError(compRel->getLine(), compRel->getColumn(), "Unknown operator in relational expression");
-                    }
-                } else if (relation->getRelType() == RelationType::NUM_EXPR) {
-                    NumExpr* numExpr = static_cast<NumExpr*>(relation);
-                    if (numExpr->getNumExprType() == NumExprType::ARIT_EXPR) {
-                        AritExpr* aritExpr = static_cast<AritExpr*>(numExpr);
-                        // Check that both sides are integers
-                        Types leftType = getDataType(aritExpr->getLeft());
-                        Types rightType = getDataType(aritExpr->getRight());
-                        if(leftType != Types::TYPE_INT || rightType != Types::TYPE_INT) {
-                            throw TypeError(aritExpr->getLine(), aritExpr->getColumn(), "Operands of arithmetic expressions must be integers");
-                        }
-                        // Evaluate the left and right expressions
-                        EvaluatedElement* leftValue = eval(aritExpr->getLeft());
-                        EvaluatedElement* rightValue = eval(aritExpr->getRight());
-                        if (!leftValue || !rightValue) {
-                            throw InternalError(aritExpr->getLine(), aritExpr->getColumn(), "Failed to evaluate operands of arithmetic expression");
-                        }
-                        // Get the operator
-                        AritExprType op = aritExpr->getAritExprType();
-                        if (op == AritExprType::ADD_EXPR) {
-                            return new EvaluatedElement(leftValue->getIntValue() + rightValue->getIntValue());
-                        } else if (op == AritExprType::SUB_EXPR) {
-                            return new EvaluatedElement(leftValue->getIntValue() - rightValue->getIntValue());
-                        } else {
-                            throw InternalError(aritExpr->getLine(), aritExpr->getColumn(), "Unknown operator in arithmetic expression");
-                        }
-                    } else if (numExpr->getNumExprType() == NumExprType::TERM) {
-                        Term* term = static_cast<Term*>(numExpr);
+/**
+ * @brief Evaluates a unary expression one step at a time
+ * @param unary The unary expression to evaluate
+ * @param step The number of times the expression has been resumed
+ * @return The operand to evaluate next, nullptr when the result is on the value stack
+ */
+Expression* Visitor::evalUnary(Unary* unary, size_t step) {
+    if (step == 0) return unary->getOperand();
+    EvaluatedElement& operandValue = values_.back();
 
-                        if (term->getTermType() == TermType::MULDIV_TERM) {
-                            MulDivTerm* mulDivTerm = static_cast<MulDivTerm*>(term);
+    if (unary->getOperator() == UnaryOperator::NOT_OP) {
+        // Check that the operand is boolean
+        if (operandValue.getType() != Types::TYPE_BOOL) {
+            throw TypeError(unary->getLine(), unary->getColumn(), "Operand of 'not' must be boolean");
+        }
+        operandValue.setBoolValue(!operandValue.getBoolValue());
+        return nullptr;
+    }
 
-                            // Check that both sides are integers
-                            Types leftType = getDataType(mulDivTerm->getLeft());
-                            Types rightType = getDataType(mulDivTerm->getRight());
-                            if(leftType != Types::TYPE_INT || rightType != Types::TYPE_INT) {
-                                throw TypeError(mulDivTerm->getLine(), mulDivTerm->getColumn(), "Operands of arithmetic expressions must be integers");
-                            }
-                            // Evaluate the left and right expressions
-                            EvaluatedElement* leftValue = eval(mulDivTerm->getLeft());
-                            EvaluatedElement* rightValue = eval(mulDivTerm->getRight());
-                            if (!leftValue || !rightValue) {
-                                throw InternalError(mulDivTerm->getLine(), mulDivTerm->getColumn(), "Failed to evaluate operands of arithmetic expression");
-                            }
-                            // Get the operator
-                            MulDivTermType op = mulDivTerm->getMulDivTermType();
-                            if (op == MulDivTermType::MUL_TERM) {
-                                return new EvaluatedElement(leftValue->getIntValue() * rightValue->getIntValue());
-                            } else if (op == MulDivTermType::DIV_TERM) {
-                                if (rightValue->getIntValue() == 0) {
-                                    throw ZeroDivisionError(mulDivTerm->getLine(), mulDivTerm->getColumn(), "Division by zero");
-                                }
-                                return new EvaluatedElement(leftValue->getIntValue() / rightValue->getIntValue());
-                            } else {
-                                throw InternalError(mulDivTerm->getLine(), mulDivTerm->getColumn(), "Unknown operator in arithmetic expression");
-                            }
-                        } else if (term->getTermType() == TermType::UNARY_TERM) {
-                            Unary* unary = static_cast<Unary*>(term);
-                            if (
-                                unary->getUnaryType() == UnaryType::NOT_UNARY ||
-                                unary->getUnaryType() == UnaryType::MINUS_UNARY
-                            ) {
-                                Unary* unaryExpr = static_cast<Unary*>(unary);
-                                if (unaryExpr->getUnaryType() == UnaryType::NOT_UNARY) {
-                                    NotUnary* notUnary = static_cast<NotUnary*>(unaryExpr);
-                                    // Check that the operand is boolean
-                                    Types unaryType = getDataType(notUnary->getUnary());
-                                    if(unaryType != Types::TYPE_BOOL) {
-                                        throw TypeError(notUnary->getLine(), notUnary->getColumn(), "Operand of 'not' must be boolean");
-                                    }
-                                    // Evaluate the operand
-                                    EvaluatedElement* unaryValue = eval(notUnary->getUnary());
-                                    if (!unaryValue) {
-                                        throw InternalError(notUnary->getLine(), notUnary->getColumn(), "Failed to evaluate operand of 'not'");
-                                    }
-
-                                    return new EvaluatedElement(!unaryValue->getBoolValue());
-                                } else if (unaryExpr->getUnaryType() == UnaryType::MINUS_UNARY) {
-                                    MinusUnary* minusUnary = static_cast<MinusUnary*>(unaryExpr);
-                                    // Check that the operand is integer
-                                    Types unaryType = getDataType(minusUnary->getUnary());
-                                    if(unaryType != Types::TYPE_INT) {
-                                        throw TypeError(minusUnary->getLine(), minusUnary->getColumn(), "Operand of unary '-' must be integer");
-                                    }
-                                    // Evaluate the operand
-                                    EvaluatedElement* unaryValue = eval(minusUnary->getUnary());
-                                    if (!unaryValue) {
-                                        throw InternalError(minusUnary->getLine(), minusUnary->getColumn(), "Failed to evaluate operand of unary '-'");
-                                    }
-                                    return new EvaluatedElement(-unaryValue->getIntValue());
-                                } else {
-                                    throw InternalError(unaryExpr->getLine(), unaryExpr->getColumn(), "Unknown unary expression type");
-                                }
-                            } else if (unary->getUnaryType() == UnaryType::FACTOR) {
-                                Factor* factor = static_cast<Factor*>(unary);
-                                if (factor->getFactorType() == FactorType::EXPR_FACTOR) {
-                                    ExpressionFactor* exprFactor = static_cast<ExpressionFactor*>(factor);
-                                    return eval(exprFactor->getExpression());
-                                } else if (factor->getFactorType() == FactorType::NUMBER) {
-                                    NumberFactor* number = static_cast<NumberFactor*>(factor);
-                                    return new EvaluatedElement(number->getNumber()->getIntValue());
-                                }
-                                else if (factor->getFactorType() == FactorType::BOOL) {
-                                    BoolFactor* boolFactor = static_cast<BoolFactor*>(factor);
-                                    return new EvaluatedElement(boolFactor->getBool()->getBoolValue());
-                                } 
-                                else if (factor->getFactorType() == FactorType::LOCATION) {
-                                    Location* locFactor = static_cast<Location*>(factor);
-                                    if (locFactor->getLocationType() == LocationType::ID) {
-                                        IdLocation* idLoc = static_cast<IdLocation*>(locFactor);
-                                        std::string id = idLoc->getId();
-                                        if (!isVariableDefined(id)) {
-                                            throw SemanticError(idLoc->getLine(), idLoc->getColumn(), "Variable '" + id + "' is not defined");
-                                        }
-                                        return new EvaluatedElement(getVariableValue(id, idLoc->getLine(), idLoc->getColumn()));
-                                    } else if (locFactor->getLocationType() == LocationType::LIST_ELEM) {
-                                        ListElementLocation* listElemLoc = static_cast<ListElementLocation*>(locFactor);
-                                        std::string id = listElemLoc->getId();
-                                        if (!isListDefined(id)) {
-                                            throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List '" + id + "' is not defined");
-                                        }
-                                        // Evaluate the index expression
-                                        EvaluatedElement* indexValue = eval(listElemLoc->getIndex());
-                                        if (!indexValue) {
-                                            throw InternalError(listElemLoc->getLine(), listElemLoc->getColumn(), "Failed to evaluate index expression in list element access");
-                                        }
-                                        if (indexValue->getType() != Types::TYPE_INT) {
-                                            throw TypeError(listElemLoc->getLine(), listElemLoc->getColumn(), "List index must be an integer");
-                                        }
-                                        if (indexValue->getIntValue() < 0 || indexValue->getIntValue() >= getListSize(id, listElemLoc->getLine(), listElemLoc->getColumn())) {
-                                            throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List index out of bounds");
-                                        }
-                                        int index = indexValue->getIntValue();
-                                        return new EvaluatedElement(getListElement(id, index, listElemLoc->getLine(), listElemLoc->getColumn()));
-                                    } else {
-                                        throw InternalError(locFactor->getLine(), locFactor->getColumn(), "Unknown LocationType in factor");
-                                    }
-                                } else {
-                                    throw InternalError(factor->getLine(), factor->getColumn(), "Unknown FactorType in unary");
-                                } 
-                            } else {
-                                throw InternalError(unary->getLine(), unary->getColumn(), "Unknown UnaryType in term");
-                            }
-                        } else {
-                            throw InternalError(term->getLine(), term->getColumn(), "Unknown TermType in num expr");
-                        }
-                    } else {
-                        throw InternalError(numExpr->getLine(), numExpr->getColumn(), "Unknown NumExprType in relation");
-                    }
-                } else {
-                    throw InternalError(relation->getLine(), relation->getColumn(), "Unknown RelationType in equality");
-                }
-            } else {
-                throw InternalError(equality->getLine(), equality->getColumn(), "Unknown EqualityType in join");
+    // Check that the operand is integer
+    if (operandValue.getType() != Types::TYPE_INT) {
+        throw TypeError(unary->getLine(), unary->getColumn(), "Operand of unary '-' must be integer");
+    }
+    operandValue.setIntValue(-operandValue.getIntValue());
+    return nullptr;
+}
+
+/**
+ * @brief Evaluates a location (variable or list element load) one step at a time
+ * @param loc The location to read
+ * @param step The number of times the location has been resumed
+ * @return The index to evaluate next, nullptr when the stored value is on the value stack
+ */
+Expression* Visitor::evalLocation(Location* loc, size_t step) {
+    if (loc->getLocationType() == LocationType::ID) {
+        IdLocation* idLoc = static_cast<IdLocation*>(loc);
+        std::string id = idLoc->getId();
+        if (!isVariableDefined(id)) {
+            throw SemanticError(idLoc->getLine(), idLoc->getColumn(), "Variable '" + id + "' is not defined");
+        }
+        values_.push_back(getVariableValue(id, idLoc->getLine(), idLoc->getColumn()));
+        return nullptr;
+    } else if (loc->getLocationType() == LocationType::LIST_ELEM) {
+        ListElementLocation* listElemLoc = static_cast<ListElementLocation*>(loc);
+        std::string id = listElemLoc->getId();
+        if (step == 0) {
+            if (!isListDefined(id)) {
+                throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List '" + id + "' is not defined");
             }
-        } else {
-            throw InternalError(join->getLine(), join->getColumn(), "Unknown JoinType in or expr");
+            // Evaluate the index expression
+            return listElemLoc->getIndex();
         }
-    } else {
-        throw InternalError(expr->getLine(), expr->getColumn(), "Unknown ExpressionType");
+        EvaluatedElement indexValue = values_.back();
+        values_.pop_back();
+        if (indexValue.getType() != Types::TYPE_INT) {
+            throw TypeError(listElemLoc->getLine(), listElemLoc->getColumn(), "List index must be an integer");
+        }
+        if (indexValue.getIntValue() < 0 || indexValue.getIntValue() >= getListSize(id, listElemLoc->getLine(), listElemLoc->getColumn())) {
+            throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List index out of bounds");
+        }
+        int index = indexValue.getIntValue();
+        values_.push_back(getListElement(id, index, listElemLoc->getLine(), listElemLoc->getColumn()));
+        return nullptr;
     }
-    return nullptr; // Should never reach here
+    throw InternalError(loc->getLine(), loc->getColumn(), "Unknown LocationType in expression");
 }
 
 /**
  * @brief Determines the data type of an expression without evaluating it
+ *
+ * Like eval(), the operands are visited with an explicit stack; the types of the visited
+ * operands are kept on the type stack.
  * @param expr The expression to check
  * @return The Types enum value representing the data type of the expression
  */
 Types Visitor::getDataType(Expression* expr) {
-    if (expr->getExprType() == ExpressionType::OR_EXPR) {
-        OrExpr* orExpr = static_cast<OrExpr*>(expr);
-        Types leftType = getDataType(orExpr->getLeft());
-        Types rightType = getDataType(orExpr->getRight());
-        if (leftType == Types::TYPE_BOOL && rightType == Types::TYPE_BOOL) {
-            return Types::TYPE_BOOL;
-        } else {
-            return Types::TYPE_UNDEFINED;
-        }
-    } else if (expr->getExprType() == ExpressionType::JOIN) {
-        Join* join = static_cast<Join*>(expr);
-        if (join->getJoinType() == JoinType::AND_JOIN) {
-            AndExpr* andExpr = static_cast<AndExpr*>(join);
-            Types leftType = getDataType(andExpr->getLeft());
-            Types rightType = getDataType(andExpr->getRight());
-            if (leftType == Types::TYPE_BOOL && rightType == Types::TYPE_BOOL) {
-                return Types::TYPE_BOOL;
-            } else {
-                return Types::TYPE_UNDEFINED;
-            }
-        } else if (join->getJoinType() == JoinType::EQUALITY) {
-            Equality* equality = static_cast<Equality*>(join);
-            if (equality->getEqualityType() == EqualityType::COMP_EQUALITY){
-                EqualExpr* eqExpr = static_cast<EqualExpr*>(equality);
-                Types leftType = getDataType(eqExpr->getLeft());
-                Types rightType = getDataType(eqExpr->getRight());
-                if(leftType == Types::TYPE_UNDEFINED || rightType == Types::TYPE_UNDEFINED || leftType != rightType) {
-                    return Types::TYPE_UNDEFINED;
+    size_t base = typeStack_.size();
+    size_t typeBase = types_.size();
+    typeStack_.push_back(EvaluationFrame{expr, 0});
+    counts_.typeChecks++;
+
+    try {
+        while (typeStack_.size() > base) {
+            EvaluationFrame& frame = typeStack_.back();
+            Expression* current = frame.expr;
+            size_t step = frame.step++;
+
+            Expression* next = nullptr;
+            switch (current->getExprType()) {
+                case ExpressionType::BINARY_EXPR: {
+                    Binary* binary = static_cast<Binary*>(current);
+                    if (step == 0) { next = binary->getLeft(); break; }
+                    if (step == 1) { next = binary->getRight(); break; }
+                    Types rightType = types_.back();
+                    types_.pop_back();
+                    Types leftType = types_.back();
+                    types_.pop_back();
+                    switch (binary->getOperator()) {
+                        case BinaryOperator::OR_OP:
+                        case BinaryOperator::AND_OP:
+                            types_.push_back((leftType == Types::TYPE_BOOL && rightType == Types::TYPE_BOOL) ? Types::TYPE_BOOL : Types::TYPE_UNDEFINED);
+                            break;
+                        case BinaryOperator::EQ_OP:
+                        case BinaryOperator::NEQ_OP:
+                            if (leftType == Types::TYPE_UNDEFINED || rightType == Types::TYPE_UNDEFINED || leftType != rightType) {
+                                types_.push_back(Types::TYPE_UNDEFINED);
+                            } else {
+                                types_.push_back(Types::TYPE_BOOL);
+                            }
+                            break;
+                        case BinaryOperator::LT_OP:
+                        case BinaryOperator::LE_OP:
+                        case BinaryOperator::GT_OP:
+                        case BinaryOperator::GE_OP:
+                            types_.push_back((leftType == Types::TYPE_INT && rightType == Types::TYPE_INT) ? Types::TYPE_BOOL : Types::TYPE_UNDEFINED);
+                            break;
+                        default:
+                            types_.push_back((leftType == Types::TYPE_INT && rightType == Types::TYPE_INT) ? Types::TYPE_INT : Types::TYPE_UNDEFINED);
+                    }
+                    break;
                 }
-                return Types::TYPE_BOOL;
-            }
-            else if (equality->getEqualityType() == EqualityType::REL) {
-                Relation* relation = static_cast<Relation*>(equality);
-                if (relation->getRelType() == RelationType::COMPARATIVE_RELATION) {
-                    ComparativeRelation* compRel = static_cast<ComparativeRelation*>(relation);
-                    Types leftType = getDataType(compRel->getLeft());
-                    Types rightType = getDataType(compRel->getRight());
-                    if(leftType == Types::TYPE_INT && rightType == Types::TYPE_INT) {
-                        return Types::TYPE_BOOL;
+                case ExpressionType::NARY_EXPR: {
+                    Nary* nary = static_cast<Nary*>(current);
+                    std::vector<Expression*> const& operands = nary->getOperands();
+                    BinaryOperator first = nary->getOperators()[0];
+                    Types expected = (first == BinaryOperator::OR_OP || first == BinaryOperator::AND_OP) ? Types::TYPE_BOOL : Types::TYPE_INT;
+                    // The chain is undefined when one operand has the wrong type (all of them are visited)
+                    if (step == 0) {
+                        types_.push_back(expected);
                     } else {
-                        return Types::TYPE_UNDEFINED;
+                        Types operandType = types_.back();
+                        types_.pop_back();
+                        if (operandType != expected) types_.back() = Types::TYPE_UNDEFINED;
                     }
-                } else if (relation->getRelType() == RelationType::NUM_EXPR) {
-                    NumExpr* numExpr = static_cast<NumExpr*>(relation);
-                    if (numExpr->getNumExprType() == NumExprType::ARIT_EXPR) {
-                        AritExpr* aritExpr = static_cast<AritExpr*>(numExpr);
-                        Types leftType = getDataType(aritExpr->getLeft());
-                        Types rightType = getDataType(aritExpr->getRight());
-                        if(leftType == Types::TYPE_INT && rightType == Types::TYPE_INT) {
-                            return Types::TYPE_INT;
-                        } else {
-                            return Types::TYPE_UNDEFINED;
+                    if (step < operands.size()) next = operands[step];
+                    break;
+                }
+                case ExpressionType::UNARY_EXPR: {
+                    Unary* unary = static_cast<Unary*>(current);
+                    if (step == 0) { next = unary->getOperand(); break; }
+                    Types operandType = types_.back();
+                    if (unary->getOperator() == UnaryOperator::NOT_OP) {
+                        types_.back() = operandType == Types::TYPE_BOOL ? Types::TYPE_BOOL : Types::TYPE_UNDEFINED;
+                    } else {
+                        types_.back() = operandType == Types::TYPE_INT ? Types::TYPE_INT : Types::TYPE_UNDEFINED;
+                    }
+                    break;
+                }
+                case ExpressionType::LITERAL_EXPR:
+                    types_.push_back(static_cast<Literal*>(current)->getLiteralType());
+                    break;
+                case ExpressionType::LOAD_EXPR: {
+                    Location* locFactor = static_cast<Location*>(current);
+                    if (locFactor->getLocationType() == LocationType::ID) {
+                        IdLocation* idLoc = static_cast<IdLocation*>(locFactor);
+                        std::string id = idLoc->getId();
+                        if (!isVariableDefined(id)) {
+                            throw SemanticError(idLoc->getLine(), idLoc->getColumn(), "Variable '" + id + "' is not defined");
                         }
-                    } else if (numExpr->getNumExprType() == NumExprType::TERM) {
-                        Term* term = static_cast<Term*>(numExpr);
-                        if (term->getTermType() == TermType::MULDIV_TERM) {
-                            MulDivTerm* mulDivTerm = static_cast<MulDivTerm*>(term);
-                            Types leftType = getDataType(mulDivTerm->getLeft());
-                            Types rightType = getDataType(mulDivTerm->getRight());
-                            if(leftType == Types::TYPE_INT && rightType == Types::TYPE_INT) {
-                                return Types::TYPE_INT;
-                            } else {
-                                return Types::TYPE_UNDEFINED;
-                            }
-                        } else if (term->getTermType() == TermType::UNARY_TERM) {
-                            Unary* unary = static_cast<Unary*>(term);
-                            if (
-                                unary->getUnaryType() == UnaryType::NOT_UNARY ||
-                                unary->getUnaryType() == UnaryType::MINUS_UNARY
-                            ) {
-                                if (unary->getUnaryType() == UnaryType::NOT_UNARY) {
-                                    NotUnary* notUnary = static_cast<NotUnary*>(unary);
-                                    Types unaryType = getDataType(notUnary->getUnary());
-                                    if(unaryType == Types::TYPE_BOOL) {
-                                        return Types::TYPE_BOOL;
-                                    } else {
-                                        return Types::TYPE_UNDEFINED;
-                                    }
-                                } else if (unary->getUnaryType() == UnaryType::MINUS_UNARY) {
-                                    MinusUnary* minusUnary = static_cast<MinusUnary*>(unary);
-                                    Types unaryType = getDataType(minusUnary->getUnary());
-                                    if(unaryType == Types::TYPE_INT) {
-                                        return Types::TYPE_INT;
-                                    } else {
-                                        return Types::TYPE_UNDEFINED;
-                                    }
-                                } else {
-                                    return Types::TYPE_UNDEFINED;
-                                }
-                            } else if (unary->getUnaryType() == UnaryType::FACTOR) {
-                                Factor* factor = static_cast<Factor*>(unary);
-                                if (factor->getFactorType() == FactorType::EXPR_FACTOR) {
-                                    ExpressionFactor* exprFactor = static_cast<ExpressionFactor*>(factor);
-                                    return getDataType(exprFactor->getExpression());
-                                } else if (factor->getFactorType() == FactorType::NUMBER) {
-                                    return Types::TYPE_INT;
-                                }
-                                else if (factor->getFactorType() == FactorType::BOOL) {
-                                    return Types::TYPE_BOOL;
-                                } 
-                                else if (factor->getFactorType() == FactorType::LOCATION) {
-                                    Location* locFactor = static_cast<Location*>(factor);
-                                    if (locFactor->getLocationType() == LocationType::ID) {
-                                        IdLocation* idLoc = static_cast<IdLocation*>(locFactor);
-                                        std::string id = idLoc->getId();
-                                        if (!isVariableDefined(id)) {
-                                            throw SemanticError(idLoc->getLine(), idLoc->getColumn(), "Variable '" + id + "' is not defined");
-                                        }
-                                        return getVariableValue(id, idLoc->getLine(), idLoc->getColumn()).getType();
-                                    } else if (locFactor->getLocationType() == LocationType::LIST_ELEM) {
-                                        ListElementLocation* listElemLoc = static_cast<ListElementLocation*>(locFactor);
-                                        std::string id = listElemLoc->getId();
-                                        if (!isListDefined(id)) {
-                                            throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List '" + id + "' is not defined");
-                                        }
-                                        return symbolTable_.getListElement(id, eval(listElemLoc->getIndex())->getIntValue()).getType();
-                                    } else {
-                                        return Types::TYPE_UNDEFINED;
-                                    }
-                                } else {
-                                    return Types::TYPE_UNDEFINED;
-                                } 
-                            } else {
-                                return Types::TYPE_UNDEFINED;
-                            }
-                        } else {
-                            return Types::TYPE_UNDEFINED;
+                        types_.push_back(getVariableValue(id, idLoc->getLine(), idLoc->getColumn()).getType());
+                    } else if (locFactor->getLocationType() == LocationType::LIST_ELEM) {
+                        ListElementLocation* listElemLoc = static_cast<ListElementLocation*>(locFactor);
+                        std::string id = listElemLoc->getId();
+                        if (!isListDefined(id)) {
+                            throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List '" + id + "' is not defined");
+                        }
+                        EvaluatedElement indexValue = eval(listElemLoc->getIndex());
+                        if (indexValue.getType() != Types::TYPE_INT) {
+                            throw TypeError(listElemLoc->getLine(), listElemLoc->getColumn(), "List index must be an integer");
                         }
+                        if (indexValue.getIntValue() < 0 || indexValue.getIntValue() >= getListSize(id, listElemLoc->getLine(), listElemLoc->getColumn())) {
+                            throw SemanticError(listElemLoc->getLine(), listElemLoc->getColumn(), "List index out of bounds");
+                        }
+                        types_.push_back(getListElement(id, indexValue.getIntValue(), listElemLoc->getLine(), listElemLoc->getColumn()).getType());
                     } else {
-                        return Types::TYPE_UNDEFINED;
+                        types_.push_back(Types::TYPE_UNDEFINED);
                     }
-                } else {
-                    return Types::TYPE_UNDEFINED;
+                    break;
                 }
+                default:
+                    types_.push_back(Types::TYPE_UNDEFINED);
+            }
+
+            // Either descend into the next operand or the type of the expression is known
+            if (next) {
+                typeStack_.push_back(EvaluationFrame{next, 0});
+                counts_.typeChecks++;
             } else {
-                return Types::TYPE_UNDEFINED;
+                typeStack_.pop_back();
             }
-        } else {
-            return Types::TYPE_UNDEFINED;
         }
-    } else {
-        return Types::TYPE_UNDEFINED;
+    } catch (...) {
+        // Leave the stacks as they were before this call
+        typeStack_.resize(base);
+        types_.resize(typeBase);
+        throw;
     }
-}  
\ No newline at end of file
+
+    Types result = types_.back();
+    types_.pop_back();
+    return result;
+}
@@ -4,6 +4,14 @@
 #include "syntax.h"
 #include "semantics.h"
 #include "error.h"
+#include "output.h"
+#include "profiler.h"
+#include "tracer.h"
+#include "counters.h"
+#include "perf.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 /**
  * @file visitor.h
@@ -17,17 +25,65 @@
  */
 
 
+/**
+ * @struct ExecutionFrame
+ * @brief One block or loop on the explicit execution stack
+ *
+ * A block frame runs its statements in order; a loop frame (loop != nullptr) re-evaluates
+ * the condition of its while statement and pushes the body as a new block frame.
+ */
+struct ExecutionFrame {
+    std::vector<Statement*> const* statements; // statements of the block (block frames only)
+    size_t next;                                // index of the next statement to run
+    bool loopBody;                              // the block is the body of a while statement
+    CompoundStatement* loop;                    // while statement (loop frames only)
+    bool endsStatement;                         // the block ends its if statement (profiling only)
+};
+
+/**
+ * @struct EvaluationFrame
+ * @brief One expression on the explicit evaluation (or type checking) stack
+ *
+ * The step counts how many times the expression has been resumed, i.e. how many of its
+ * operands have already been pushed on the value stack.
+ */
+struct EvaluationFrame {
+    Expression* expr; // expression being evaluated
+    size_t step;      // progress of the evaluation
+};
+
+// Largest number of steps between two readings of the clock when a time limit is set
+#define LIMIT_CHECK_INTERVAL 4096
+
+/**
+ * @struct ExecutionLimits
+ * @brief Limits of a run (0 means unlimited)
+ *
+ * Statements and time are checked on the back-edges of loops, the only places where a program
+ * can run for long; memory is checked when lists grow, the only structures that can grow
+ * without bound. Exceeding a limit raises a LimitError.
+ */
+struct ExecutionLimits {
+    uint64_t maxSteps{0};        // statements and loop iterations
+    uint64_t maxMilliseconds{0}; // wall time since the start of the run
+    size_t maxMemory{0};         // estimated bytes of the variables and lists
+};
+
 /**
  * @class Visitor
  * @brief Semantic analyzer for the Python-Sublanguage interpreter
  * 
  * The Visitor class is responsible for collecting information from the Syntax Tree and performing semantic analysis.
+ * Blocks and expressions are executed with explicit stacks, so the nesting depth of the
+ * program is not limited by the size of the call stack. Since the whole state of the execution
+ * lives in those stacks, a run can also be suspended at the back-edges of while loops and after
+ * print statements, and resumed later (see Scheduler).
  */
 class Visitor{
     public:
         // constructors
         Visitor() = delete;
-        Visitor(Program* program) : program_(program) {}
+        Visitor(Program* program, OutputSink& output) : program_(program), output_(output) {}
         Visitor(Visitor const& v) = delete;
 
         // destructor
@@ -56,6 +112,23 @@ class Visitor{
         // General methods
         bool isAlreadyDefined(std::string id);
 
+        // Methods for suspendable execution: start() prepares the program, resume() runs it for a slice
+        void start();
+        bool resume(uint64_t budget);
+        // Method to run the statements added to the program after the run reached its end (see Pipeline)
+        bool extend(uint64_t budget);
+
+        // Method to set the execution limits (before start())
+        void setLimits(const ExecutionLimits& limits) { limits_ = limits; }
+        // Method to attach a profiler, which records every statement (null to disable)
+        void setProfiler(Profiler* profiler) { profiler_ = profiler; }
+        // Method to publish the statement being executed in a slot read by the Sampler (null to disable)
+        void setSampleSlot(std::atomic<Statement*>* slot) { sampleSlot_ = slot; }
+        // Method to attach a tracer, which records the top-level statements and the loops (null to disable)
+        void setTracer(Tracer* tracer) { tracer_ = tracer; }
+        // Method to attach perf counters, read around every top-level statement (null to disable)
+        void setPerfCounters(PerfCounters* perf) { perf_ = perf; }
+
         // Visitor methods for each type of statement
         void visitProgram();
         void visitStatement(Statement* stmt);
@@ -63,29 +136,60 @@ class Visitor{
         void visitListDeclarationStatement(ListDeclarationStatement* lds);
         void visitListAppendStatement(ListAppendStatement* las);
         void visitPrintStatement(PrintStatement* ps);
-        void visitIfStatement(CompoundStatement* ifs);
-        void visitWhileStatement(CompoundStatement* ws);
-        void visitSimpleBlock(SimpleBlock* sb);
-        void visitElifBlock(ElifBlock* elifBlock);
-        void visitElseBlock(ElseBlock* elseBlock);
+        Block* visitIfStatement(CompoundStatement* ifs);
+        bool visitWhileStatement(CompoundStatement* ws);
         void visitBreakStatement(BreakStatement* bs);
         void visitContinueStatement(ContinueStatement* cs);
-        
 
         // Method to get the type of an expression
         Types getDataType(Expression* expr);
 
         // Evaluation methods for expressions
-        EvaluatedElement* eval(Expression* expr);
+        EvaluatedElement eval(Expression* expr);
+        EvaluatedElement evalSteps(Expression* expr);
+        void checkOperandTypes(Expression* expr);
+        Expression* evalBinary(Binary* binary, size_t step);
+        Expression* evalNary(Nary* nary, size_t step);
+        Expression* evalUnary(Unary* unary, size_t step);
+        Expression* evalLocation(Location* loc, size_t step);
 
         // Method to access the symbol table
         SymbolTable& getSymbolTable() { return symbolTable_; }
+        // Method to get the work done so far by the run (without the allocations, counted by the executable)
+        OperationCounts getOperationCounts() const;
 
     private:
         Program* program_;
+        OutputSink& output_; // destination of the print statements
         SymbolTable symbolTable_;
-        std::vector<bool> conditionMetStack_;
         std::vector<bool> loopStack_;
+
+        // explicit stacks replacing the recursion on the Syntax Tree
+        std::vector<ExecutionFrame> frames_;     // blocks and loops being executed
+        std::vector<EvaluationFrame> evalStack_; // expressions being evaluated
+        std::vector<EvaluatedElement> values_;   // values of the evaluated operands
+        std::vector<EvaluationFrame> typeStack_; // expressions being type checked
+        std::vector<Types> types_;               // types of the checked operands
+        bool checkTypes_{false};                 // type check the operands of the next operator before evaluating them
+
+        Profiler* profiler_{nullptr};
+        std::atomic<Statement*>* sampleSlot_{nullptr}; // statement being executed, for the Sampler
+        Tracer* tracer_{nullptr};
+        PerfCounters* perf_{nullptr};
+        OperationCounts counts_; // statements, iterations and expressions (the symbol table counts the rest)
+
+        // execution limits and progress of the run
+        ExecutionLimits limits_;
+        uint64_t steps_{0};                              // statements and loop iterations run so far
+        size_t ranStatements_{0};                        // top-level statements run when the run last ended
+        uint64_t limitCheckpoint_{UINT64_MAX};           // step of the next check of the limits
+        std::chrono::steady_clock::time_point deadline_; // end of the wall time of the run
+
+        // method to run the frames on the execution stack (returns false when suspended)
+        bool execute(uint64_t budget);
+        // methods to enforce the execution limits
+        void checkLimits(CompoundStatement* loop);
+        void checkMemory(Statement* stmt);
 };
 
 